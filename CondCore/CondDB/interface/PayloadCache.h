@@ -0,0 +1,126 @@
+#ifndef CondCore_CondDB_PayloadCache_h
+#define CondCore_CondDB_PayloadCache_h
+
+#include "CondCore/CondDB/interface/Binary.h"
+#include "CondCore/CondDB/interface/Exception.h"
+#include "CondCore/CondDB/interface/Serialization.h"
+#include "CondCore/CondDB/interface/Types.h"
+//
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <utility>
+
+namespace cond {
+
+  namespace persistency {
+
+    class Session;
+    class PayloadSnapshot;
+
+    // serialized payload, as stored in the database
+    struct PayloadData {
+      std::string type;
+      Binary data;
+      Binary streamerInfo;
+    };
+
+    /* process-wide cache of the deserialized payloads, keyed by payload hash and C++ type.
+       A payload is deserialized only once as long as anyone holds it: concurrent requests
+       for the same payload wait for the first one to complete, then share the object.
+       Optionally, the serialized data fetched from the database are also written to a local
+       directory, one file per payload hash, and read back from there by any later job
+       using the same directory ( e.g. all the jobs running on a node ).
+       A PayloadSnapshot, when set, is looked up before the disk cache and the database.
+    */
+    class PayloadCache {
+    public:
+      struct Stats {
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t diskReads = 0;
+	size_t diskWrites = 0;
+	size_t snapshotReads = 0;
+      };
+
+      static PayloadCache& instance();
+
+      PayloadCache( const PayloadCache& ) = delete;
+      PayloadCache& operator=( const PayloadCache& ) = delete;
+
+      // an empty directory ( the default ) disables the disk cache
+      void setDiskCacheDirectory( const std::string& directory );
+
+      std::string diskCacheDirectory() const;
+
+      void setSnapshot( const std::shared_ptr<const PayloadSnapshot>& snapshot );
+
+      // keeps a copy of the serialized data of all the payloads fetched from now on, for writeSnapshot
+      void recordPayloads( bool record );
+
+      void writeSnapshot( const std::string& fileName, const std::string& globalTag ) const;
+
+      // true if the payload is in use, or being loaded
+      template <typename T> bool contains( const Hash& payloadHash ) const {
+	return contains( payloadHash, std::type_index( typeid(T) ) );
+      }
+
+      // returns the cached payload, or the one made by loader.
+      // The exceptions thrown by loader are passed on to all the waiting requests.
+      template <typename T> std::shared_ptr<T> get( const Hash& payloadHash, const std::function<std::shared_ptr<T>()>& loader ){
+	return std::static_pointer_cast<T>( get( payloadHash, std::type_index( typeid(T) ),
+						 [&loader]() -> std::shared_ptr<void> { return loader(); } ) );
+      }
+
+      // reads the serialized payload from the disk cache or, if it is not there, from the database;
+      // the latter requires an active transaction on the session.
+      bool fetchPayloadData( Session& session, const Hash& payloadHash, PayloadData& payload );
+
+      // drops the entries of the payloads no longer in use
+      void purge();
+
+      Stats stats() const;
+
+    private:
+      PayloadCache();
+
+      typedef std::pair<Hash,std::type_index> Key;
+      struct Entry {
+	std::shared_future<std::shared_ptr<void> > loading;
+	std::weak_ptr<void> payload;
+      };
+
+      bool contains( const Hash& payloadHash, const std::type_index& type ) const;
+      std::shared_ptr<void> get( const Hash& payloadHash, const std::type_index& type,
+				 const std::function<std::shared_ptr<void>()>& loader );
+      bool readFromDisk( const Hash& payloadHash, PayloadData& payload );
+      void writeToDisk( const Hash& payloadHash, const PayloadData& payload );
+
+    private:
+      mutable std::mutex m_mutex;
+      std::map<Key,Entry> m_entries;
+      std::string m_directory;
+      std::shared_ptr<const PayloadSnapshot> m_snapshot;
+      bool m_record;
+      std::map<Hash,PayloadData> m_recorded;
+      Stats m_stats;
+    };
+
+    template <typename T> inline std::shared_ptr<T> deserializePayload( const Hash& payloadHash, const PayloadData& payload ){
+      std::shared_ptr<T> ret;
+      try{
+	ret = deserialize<T>( payload.type, payload.data, payload.streamerInfo );
+      } catch ( const cond::persistency::Exception& e ){
+	std::string em(e.what());
+	throwException( "Payload of type "+payload.type+" with id "+payloadHash+" could not be loaded. "+em,"deserializePayload");
+      }
+      return ret;
+    }
+
+  }
+}
+#endif // CondCore_CondDB_PayloadCache_h
@@ -1,8 +1,11 @@
 #ifndef CondCore_CondDB_PayloadProxy_h
 #define CondCore_CondDB_PayloadProxy_h
 
+#include "CondCore/CondDB/interface/PayloadCache.h"
 #include "CondCore/CondDB/interface/Session.h"
 #include "CondCore/CondDB/interface/Time.h"
+//
+#include <functional>
 
 namespace cond {
 
@@ -38,6 +41,14 @@ namespace cond {
       virtual void make()=0;
       
       virtual void invalidateCache()=0;
+
+      // fetches from the database the payload of the current iov, unless it is already loaded, and returns
+      // the function deserializing it into the PayloadCache. The functions returned by different proxies
+      // can run concurrently. An empty function is returned when there is nothing to do.
+      virtual std::function<void()> prefetchPayload()=0;
+
+      // drops the payload kept by prefetchPayload, if it has not been loaded
+      virtual void releasePrefetchedPayload()=0;
       
       // current cached object token
       const Hash& payloadId() const { return m_currentIov.payloadId;}
@@ -112,12 +123,47 @@ namespace cond {
 	m_requests.clear();
       }
 
+      std::function<void()> prefetchPayload() override {
+	// a payload prefetched for a previous iov and never loaded is not needed anymore
+	if( m_prefetchedId != m_currentIov.payloadId ) releasePrefetchedPayload();
+	if( !isValid() || m_currentIov.payloadId == m_currentPayloadId ) return std::function<void()>();
+	Hash payloadId = m_currentIov.payloadId;
+	if( PayloadCache::instance().contains<DataT>( payloadId ) ) return std::function<void()>();
+	auto payload = std::make_shared<PayloadData>();
+	TransactionScope transaction( m_session.transaction() );
+	transaction.start( true );
+	bool found = PayloadCache::instance().fetchPayloadData( m_session, payloadId, *payload );
+	transaction.commit();
+	// a missing payload is reported by loadPayload
+	if( !found ) return std::function<void()>();
+	m_prefetchedId = payloadId;
+	return [this,payloadId,payload](){
+	  m_prefetched = PayloadCache::instance().get<DataT>( payloadId, [&payloadId,&payload](){
+	      return deserializePayload<DataT>( payloadId, *payload );
+	    } );
+	};
+      }
+
+      void releasePrefetchedPayload() override {
+	m_prefetched.reset();
+	m_prefetchedId.clear();
+      }
+
     protected:
       void loadPayload() override {
 	if( m_currentIov.payloadId.empty() ){
 	  throwException( "Can't load payload: no valid IOV found.","PayloadProxy::loadPayload" );
 	}
-	m_data = m_session.fetchPayload<DataT>( m_currentIov.payloadId );
+	const Hash& payloadId = m_currentIov.payloadId;
+	m_data = PayloadCache::instance().get<DataT>( payloadId, [this,&payloadId](){
+	    PayloadData payload;
+	    if( !PayloadCache::instance().fetchPayloadData( m_session, payloadId, payload ) )
+	      throwException( "Payload with id "+payloadId+" has not been found in the database.",
+			      "PayloadProxy::loadPayload" );
+	    return deserializePayload<DataT>( payloadId, payload );
+	  } );
+	// the prefetched payload, if any, is now held by m_data
+	releasePrefetchedPayload();
 	m_currentPayloadId = m_currentIov.payloadId;	  
 	m_requests.push_back( m_currentIov );
       }
@@ -125,6 +171,10 @@ namespace cond {
     private:
       std::shared_ptr<DataT> m_data;
       Hash m_currentPayloadId;
+      // keeps the payload made by prefetchPayload in the PayloadCache until it is loaded,
+      // or until the iov moves to another payload
+      std::shared_ptr<DataT> m_prefetched;
+      Hash m_prefetchedId;
     };
     
   }
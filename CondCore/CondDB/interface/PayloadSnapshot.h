@@ -0,0 +1,57 @@
+#ifndef CondCore_CondDB_PayloadSnapshot_h
+#define CondCore_CondDB_PayloadSnapshot_h
+
+#include "CondCore/CondDB/interface/PayloadCache.h"
+#include "CondCore/CondDB/interface/Types.h"
+//
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace cond {
+
+  namespace persistency {
+
+    /* read-only, memory-mapped file holding the serialized payloads used by a job, for a given global tag.
+       The file is made of a header, the global tag name, the payload data and an index sorted by payload hash;
+       all the positions are offsets from the start of the file, so that it can be copied and mapped anywhere.
+       It is written by a first job, and then used by the later ones to get the payloads without any
+       database access.
+    */
+    class PayloadSnapshot {
+    public:
+      // incremented at any change of the file layout
+      static constexpr uint32_t formatVersion = 1;
+
+      // maps the file; throws if it can not be read or has been written with a different format version
+      explicit PayloadSnapshot( const std::string& fileName );
+
+      ~PayloadSnapshot();
+
+      PayloadSnapshot( const PayloadSnapshot& ) = delete;
+      PayloadSnapshot& operator=( const PayloadSnapshot& ) = delete;
+
+      const std::string& fileName() const { return m_fileName; }
+
+      const std::string& globalTag() const { return m_globalTag; }
+
+      size_t size() const { return m_nPayloads; }
+
+      bool find( const Hash& payloadHash, PayloadData& payload ) const;
+
+      // the file is written under a temporary name, then renamed
+      static void write( const std::string& fileName, const std::string& globalTag, const std::map<Hash,PayloadData>& payloads );
+
+    private:
+      std::string m_fileName;
+      const char* m_buffer;
+      size_t m_size;
+      std::string m_globalTag;
+      const void* m_index;
+      size_t m_nPayloads;
+    };
+
+  }
+}
+#endif // CondCore_CondDB_PayloadSnapshot_h
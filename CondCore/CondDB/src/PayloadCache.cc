@@ -0,0 +1,256 @@
+#include "CondCore/CondDB/interface/PayloadCache.h"
+#include "CondCore/CondDB/interface/PayloadSnapshot.h"
+#include "CondCore/CondDB/interface/Session.h"
+#include "IOVSchema.h"
+//
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+//
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cond {
+
+  namespace persistency {
+
+    namespace {
+
+      // layout of the files of the disk cache: header, type name, payload data, streamer info
+      constexpr char s_diskMagic[8] = { 'C','o','n','d','P','L','0','1' };
+
+      struct DiskHeader {
+	char magic[8];
+	uint64_t typeSize;
+	uint64_t dataSize;
+	uint64_t streamerInfoSize;
+      };
+
+      bool readAll( int fd, void* buffer, size_t size ){
+	char* p = static_cast<char*>( buffer );
+	while( size > 0 ){
+	  ssize_t n = ::read( fd, p, size );
+	  if( n <= 0 ) return false;
+	  p += n;
+	  size -= n;
+	}
+	return true;
+      }
+
+      bool writeAll( int fd, const void* buffer, size_t size ){
+	const char* p = static_cast<const char*>( buffer );
+	while( size > 0 ){
+	  ssize_t n = ::write( fd, p, size );
+	  if( n < 0 ) return false;
+	  p += n;
+	  size -= n;
+	}
+	return true;
+      }
+
+    }
+
+    PayloadCache& PayloadCache::instance(){
+      static PayloadCache s_cache;
+      return s_cache;
+    }
+
+    PayloadCache::PayloadCache():
+      m_mutex(),
+      m_entries(),
+      m_directory(),
+      m_snapshot(),
+      m_record( false ),
+      m_recorded(),
+      m_stats(){
+    }
+
+    void PayloadCache::setDiskCacheDirectory( const std::string& directory ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_directory = directory;
+      while( m_directory.size() > 1 && m_directory.back() == '/' ) m_directory.pop_back();
+    }
+
+    std::string PayloadCache::diskCacheDirectory() const {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      return m_directory;
+    }
+
+    void PayloadCache::setSnapshot( const std::shared_ptr<const PayloadSnapshot>& snapshot ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_snapshot = snapshot;
+    }
+
+    void PayloadCache::recordPayloads( bool record ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_record = record;
+      if( !m_record ) m_recorded.clear();
+    }
+
+    void PayloadCache::writeSnapshot( const std::string& fileName, const std::string& globalTag ) const {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      PayloadSnapshot::write( fileName, globalTag, m_recorded );
+    }
+
+    bool PayloadCache::contains( const Hash& payloadHash, const std::type_index& type ) const {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      auto it = m_entries.find( Key( payloadHash, type ) );
+      if( it == m_entries.end() ) return false;
+      return it->second.loading.valid() || !it->second.payload.expired();
+    }
+
+    std::shared_ptr<void> PayloadCache::get( const Hash& payloadHash, const std::type_index& type,
+					     const std::function<std::shared_ptr<void>()>& loader ){
+      Key key( payloadHash, type );
+      std::promise<std::shared_ptr<void> > promise;
+      std::shared_future<std::shared_ptr<void> > loading;
+      {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	Entry& entry = m_entries[ key ];
+	if( auto payload = entry.payload.lock() ){
+	  m_stats.hits++;
+	  return payload;
+	}
+	if( entry.loading.valid() ){
+	  // someone else is loading it: wait outside of the lock
+	  m_stats.hits++;
+	  loading = entry.loading;
+	} else {
+	  m_stats.misses++;
+	  entry.loading = promise.get_future().share();
+	}
+      }
+      if( loading.valid() ) return loading.get();
+
+      std::shared_ptr<void> payload;
+      try{
+	payload = loader();
+      } catch ( ... ){
+	{
+	  std::lock_guard<std::mutex> lock( m_mutex );
+	  m_entries.erase( key );
+	}
+	promise.set_exception( std::current_exception() );
+	throw;
+      }
+      {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	Entry& entry = m_entries[ key ];
+	entry.payload = payload;
+	entry.loading = std::shared_future<std::shared_ptr<void> >();
+      }
+      promise.set_value( payload );
+      return payload;
+    }
+
+    bool PayloadCache::fetchPayloadData( Session& session, const Hash& payloadHash, PayloadData& payload ){
+      std::shared_ptr<const PayloadSnapshot> snapshot;
+      {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	snapshot = m_snapshot;
+      }
+      if( snapshot && snapshot->find( payloadHash, payload ) ){
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_stats.snapshotReads++;
+	return true;
+      }
+      if( !readFromDisk( payloadHash, payload ) ){
+	if( !session.fetchPayloadData( payloadHash, payload.type, payload.data, payload.streamerInfo ) ) return false;
+	writeToDisk( payloadHash, payload );
+      }
+      std::lock_guard<std::mutex> lock( m_mutex );
+      if( m_record ) m_recorded.insert( std::make_pair( payloadHash, payload ) );
+      return true;
+    }
+
+    void PayloadCache::purge(){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      for( auto it = m_entries.begin(); it != m_entries.end(); ){
+	if( !it->second.loading.valid() && it->second.payload.expired() ) it = m_entries.erase( it );
+	else ++it;
+      }
+    }
+
+    PayloadCache::Stats PayloadCache::stats() const {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      return m_stats;
+    }
+
+    bool PayloadCache::readFromDisk( const Hash& payloadHash, PayloadData& payload ){
+      std::string directory = diskCacheDirectory();
+      if( directory.empty() ) return false;
+      std::string fileName = directory+"/"+payloadHash;
+      int fd = ::open( fileName.c_str(), O_RDONLY );
+      if( fd < 0 ) return false;
+      struct stat st;
+      if( ::fstat( fd, &st ) != 0 || static_cast<size_t>( st.st_size ) < sizeof(DiskHeader) ){
+	::close( fd );
+	return false;
+      }
+      // the payload data are copied into their Binary anyway, so the file is simply read
+      size_t fileSize = st.st_size;
+      std::vector<char> buffer( fileSize );
+      bool ok = readAll( fd, buffer.data(), fileSize );
+      ::close( fd );
+      if( !ok ) return false;
+
+      // a file not matching the expected layout, or whose content does not match the
+      // payload hash, is ignored and will be replaced
+      DiskHeader header;
+      ::memcpy( &header, buffer.data(), sizeof(DiskHeader) );
+      if( ::memcmp( header.magic, s_diskMagic, sizeof(s_diskMagic) ) != 0 ) return false;
+      // each size is checked against what remains of the file, so that corrupted sizes cannot overflow
+      uint64_t remaining = fileSize-sizeof(DiskHeader);
+      if( header.typeSize > remaining ) return false;
+      remaining -= header.typeSize;
+      if( header.dataSize > remaining ) return false;
+      remaining -= header.dataSize;
+      if( header.streamerInfoSize != remaining ) return false;
+      const char* p = buffer.data()+sizeof(DiskHeader);
+      PayloadData fromDisk;
+      fromDisk.type.assign( p, header.typeSize );
+      p += header.typeSize;
+      fromDisk.data = Binary( p, header.dataSize );
+      p += header.dataSize;
+      fromDisk.streamerInfo = Binary( p, header.streamerInfoSize );
+      if( makeHash( fromDisk.type, fromDisk.data ) != payloadHash ) return false;
+
+      payload = fromDisk;
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_stats.diskReads++;
+      return true;
+    }
+
+    void PayloadCache::writeToDisk( const Hash& payloadHash, const PayloadData& payload ){
+      std::string directory = diskCacheDirectory();
+      if( directory.empty() ) return;
+      std::string fileName = directory+"/"+payloadHash;
+      // the file is written under a temporary name, then renamed: concurrent jobs never see a partial file
+      std::vector<char> tmpName( fileName.begin(), fileName.end() );
+      const char suffix[] = ".XXXXXX";
+      tmpName.insert( tmpName.end(), suffix, suffix+sizeof(suffix) );
+      int fd = ::mkstemp( tmpName.data() );
+      if( fd < 0 ) return;
+      DiskHeader header;
+      ::memcpy( header.magic, s_diskMagic, sizeof(s_diskMagic) );
+      header.typeSize = payload.type.size();
+      header.dataSize = payload.data.size();
+      header.streamerInfoSize = payload.streamerInfo.size();
+      bool ok = writeAll( fd, &header, sizeof(DiskHeader) ) &&
+	writeAll( fd, payload.type.data(), payload.type.size() ) &&
+	writeAll( fd, payload.data.data(), payload.data.size() ) &&
+	writeAll( fd, payload.streamerInfo.data(), payload.streamerInfo.size() );
+      ::fchmod( fd, 0644 );
+      ok = ( ::close( fd ) == 0 ) && ok;
+      if( ok && ::rename( tmpName.data(), fileName.c_str() ) == 0 ){
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_stats.diskWrites++;
+      } else {
+	::unlink( tmpName.data() );
+      }
+    }
+
+  }
+}
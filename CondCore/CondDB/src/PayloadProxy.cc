@@ -37,13 +37,15 @@ namespace cond {
     ValidityInterval BasePayloadProxy::setIntervalFor(cond::Time_t time, bool load) {
       if( !m_currentIov.isValidFor( time ) ){
 	m_currentIov.clear();
-	m_session.transaction().start(true);
+	// rolled back if the lookup or the load throws, so that the session can be used again
+	TransactionScope transaction( m_session.transaction() );
+	transaction.start(true);
 	auto it = m_iovProxy.find( time );
 	if( it != m_iovProxy.end() ) {
 	  m_currentIov = *it;
 	  if(load) loadPayload();
 	}
-	m_session.transaction().commit();
+	transaction.commit();
       }
       return ValidityInterval( m_currentIov.since, m_currentIov.till );
     }
@@ -0,0 +1,181 @@
+#include "CondCore/CondDB/interface/PayloadSnapshot.h"
+#include "CondCore/CondDB/interface/Exception.h"
+//
+#include <algorithm>
+#include <cstring>
+#include <vector>
+//
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cond {
+
+  namespace persistency {
+
+    namespace {
+
+      constexpr char s_snapshotMagic[8] = { 'C','o','n','d','S','N','A','P' };
+      constexpr size_t s_hashSize = 40;
+
+      struct SnapshotHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t globalTagSize;
+	uint64_t nPayloads;
+	uint64_t indexOffset;
+      };
+
+      struct IndexEntry {
+	char hash[s_hashSize];
+	uint64_t typeOffset;
+	uint64_t typeSize;
+	uint64_t dataOffset;
+	uint64_t dataSize;
+	uint64_t streamerInfoOffset;
+	uint64_t streamerInfoSize;
+      };
+
+      bool writeAll( int fd, const void* buffer, size_t size ){
+	const char* p = static_cast<const char*>( buffer );
+	while( size > 0 ){
+	  ssize_t n = ::write( fd, p, size );
+	  if( n < 0 ) return false;
+	  p += n;
+	  size -= n;
+	}
+	return true;
+      }
+
+      bool inFile( uint64_t offset, uint64_t size, size_t fileSize ){
+	return offset <= fileSize && size <= fileSize-offset;
+      }
+
+    }
+
+    PayloadSnapshot::PayloadSnapshot( const std::string& fileName ):
+      m_fileName( fileName ),
+      m_buffer( nullptr ),
+      m_size( 0 ),
+      m_globalTag(),
+      m_index( nullptr ),
+      m_nPayloads( 0 ){
+      int fd = ::open( fileName.c_str(), O_RDONLY );
+      if( fd < 0 ) throwException( "Snapshot file \""+fileName+"\" can not be opened.","PayloadSnapshot::PayloadSnapshot" );
+      struct stat st;
+      if( ::fstat( fd, &st ) != 0 || static_cast<size_t>( st.st_size ) < sizeof(SnapshotHeader) ){
+	::close( fd );
+	throwException( "Snapshot file \""+fileName+"\" is too short.","PayloadSnapshot::PayloadSnapshot" );
+      }
+      m_size = st.st_size;
+      void* mapped = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      ::close( fd );
+      if( mapped == MAP_FAILED ) throwException( "Snapshot file \""+fileName+"\" can not be mapped.","PayloadSnapshot::PayloadSnapshot" );
+      m_buffer = static_cast<const char*>( mapped );
+
+      SnapshotHeader header;
+      ::memcpy( &header, m_buffer, sizeof(SnapshotHeader) );
+      std::string error;
+      if( ::memcmp( header.magic, s_snapshotMagic, sizeof(s_snapshotMagic) ) != 0 ){
+	error = "is not a payload snapshot";
+      } else if( header.version != formatVersion ){
+	error = "has format version "+std::to_string( header.version )+", expected "+std::to_string( formatVersion );
+      } else if( !inFile( sizeof(SnapshotHeader), header.globalTagSize, m_size ) ||
+		 header.indexOffset % alignof(IndexEntry) != 0 ||
+		 header.nPayloads > m_size/sizeof(IndexEntry) ||
+		 !inFile( header.indexOffset, header.nPayloads*sizeof(IndexEntry), m_size ) ){
+	error = "is corrupted";
+      } else {
+	const IndexEntry* index = reinterpret_cast<const IndexEntry*>( m_buffer+header.indexOffset );
+	for( uint64_t i=0; i<header.nPayloads; i++ ){
+	  const IndexEntry& e = index[i];
+	  if( !inFile( e.typeOffset, e.typeSize, m_size ) || !inFile( e.dataOffset, e.dataSize, m_size ) ||
+	      !inFile( e.streamerInfoOffset, e.streamerInfoSize, m_size ) ||
+	      ( i > 0 && ::memcmp( index[i-1].hash, e.hash, s_hashSize ) >= 0 ) ){
+	    error = "is corrupted";
+	    break;
+	  }
+	}
+      }
+      if( !error.empty() ){
+	::munmap( mapped, m_size );
+	throwException( "Snapshot file \""+fileName+"\" "+error+".","PayloadSnapshot::PayloadSnapshot" );
+      }
+      m_globalTag.assign( m_buffer+sizeof(SnapshotHeader), header.globalTagSize );
+      m_index = m_buffer+header.indexOffset;
+      m_nPayloads = header.nPayloads;
+    }
+
+    PayloadSnapshot::~PayloadSnapshot(){
+      if( m_buffer ) ::munmap( const_cast<char*>( m_buffer ), m_size );
+    }
+
+    bool PayloadSnapshot::find( const Hash& payloadHash, PayloadData& payload ) const {
+      if( payloadHash.size() != s_hashSize ) return false;
+      const IndexEntry* begin = static_cast<const IndexEntry*>( m_index );
+      const IndexEntry* end = begin+m_nPayloads;
+      const IndexEntry* it = std::lower_bound( begin, end, payloadHash, []( const IndexEntry& e, const Hash& h ){
+	  return ::memcmp( e.hash, h.data(), s_hashSize ) < 0;
+	} );
+      if( it == end || ::memcmp( it->hash, payloadHash.data(), s_hashSize ) != 0 ) return false;
+      payload.type.assign( m_buffer+it->typeOffset, it->typeSize );
+      payload.data = Binary( m_buffer+it->dataOffset, it->dataSize );
+      payload.streamerInfo = Binary( m_buffer+it->streamerInfoOffset, it->streamerInfoSize );
+      return true;
+    }
+
+    void PayloadSnapshot::write( const std::string& fileName, const std::string& globalTag, const std::map<Hash,PayloadData>& payloads ){
+      // the map is ordered by hash, as required for the index
+      std::vector<IndexEntry> index;
+      index.reserve( payloads.size() );
+      uint64_t offset = sizeof(SnapshotHeader)+globalTag.size();
+      for( auto const& p : payloads ){
+	if( p.first.size() != s_hashSize ) continue;
+	IndexEntry e;
+	::memcpy( e.hash, p.first.data(), s_hashSize );
+	e.typeOffset = offset;
+	e.typeSize = p.second.type.size();
+	offset += e.typeSize;
+	e.dataOffset = offset;
+	e.dataSize = p.second.data.size();
+	offset += e.dataSize;
+	e.streamerInfoOffset = offset;
+	e.streamerInfoSize = p.second.streamerInfo.size();
+	offset += e.streamerInfoSize;
+	index.push_back( e );
+      }
+      uint64_t padding = ( alignof(IndexEntry) - offset % alignof(IndexEntry) ) % alignof(IndexEntry);
+
+      SnapshotHeader header;
+      ::memcpy( header.magic, s_snapshotMagic, sizeof(s_snapshotMagic) );
+      header.version = formatVersion;
+      header.globalTagSize = globalTag.size();
+      header.nPayloads = index.size();
+      header.indexOffset = offset+padding;
+
+      std::vector<char> tmpName( fileName.begin(), fileName.end() );
+      const char suffix[] = ".XXXXXX";
+      tmpName.insert( tmpName.end(), suffix, suffix+sizeof(suffix) );
+      int fd = ::mkstemp( tmpName.data() );
+      if( fd < 0 ) throwException( "Snapshot file \""+fileName+"\" can not be created.","PayloadSnapshot::write" );
+      bool ok = writeAll( fd, &header, sizeof(SnapshotHeader) ) && writeAll( fd, globalTag.data(), globalTag.size() );
+      for( auto const& p : payloads ){
+	if( !ok ) break;
+	if( p.first.size() != s_hashSize ) continue;
+	ok = writeAll( fd, p.second.type.data(), p.second.type.size() ) &&
+	  writeAll( fd, p.second.data.data(), p.second.data.size() ) &&
+	  writeAll( fd, p.second.streamerInfo.data(), p.second.streamerInfo.size() );
+      }
+      const char zeros[alignof(IndexEntry)] = {};
+      ok = ok && writeAll( fd, zeros, padding ) && writeAll( fd, index.data(), index.size()*sizeof(IndexEntry) );
+      ::fchmod( fd, 0644 );
+      ok = ( ::close( fd ) == 0 ) && ok;
+      if( !ok || ::rename( tmpName.data(), fileName.c_str() ) != 0 ){
+	::unlink( tmpName.data() );
+	throwException( "Snapshot file \""+fileName+"\" could not be written.","PayloadSnapshot::write" );
+      }
+    }
+
+  }
+}
@@ -0,0 +1,223 @@
+#include "FWCore/PluginManager/interface/PluginManager.h"
+#include "FWCore/PluginManager/interface/standard.h"
+//
+#include "CondCore/CondDB/interface/ConnectionPool.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
+#include "CondCore/CondDB/interface/PayloadProxy.h"
+#include "CondCore/CondDB/interface/PayloadSnapshot.h"
+//
+#include "MyTestData.h"
+//
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+//
+#include <unistd.h>
+
+using namespace cond::persistency;
+
+int main (int argc, char** argv)
+{
+  edmplugin::PluginManager::Config config;
+  edmplugin::PluginManager::configure(edmplugin::standard::config());
+
+  std::string connectionString("sqlite_file:cms_conditions_cache.db");
+  std::cout <<"# Connecting with db in "<<connectionString<<std::endl;
+  int ret = 0;
+  try{
+
+    ConnectionPool connPool;
+    Session session = connPool.createSession( connectionString, true );
+    session.transaction().start( false );
+    MyTestData d0( 20000 );
+    cond::Hash p0 = session.storePayload( d0, boost::posix_time::microsec_clock::universal_time() );
+    session.transaction().commit();
+
+    char cacheDir[] = "/tmp/testPayloadCacheXXXXXX";
+    if( !::mkdtemp( cacheDir ) ){
+      std::cout <<"ERROR: could not create the cache directory."<<std::endl;
+      return -1;
+    }
+    PayloadCache& cache = PayloadCache::instance();
+    cache.setDiskCacheDirectory( cacheDir );
+
+    // first fetch from the database, written to disk; the second one is read back from disk
+    PayloadData data0;
+    PayloadData data1;
+    session.transaction().start( true );
+    bool found0 = cache.fetchPayloadData( session, p0, data0 );
+    session.transaction().commit();
+    bool found1 = cache.fetchPayloadData( session, p0, data1 );
+    PayloadCache::Stats stats = cache.stats();
+    if( !found0 || !found1 || stats.diskWrites != 1 || stats.diskReads != 1 ){
+      std::cout <<"ERROR: disk cache writes "<<stats.diskWrites<<" reads "<<stats.diskReads<<std::endl;
+      ret = -1;
+    } else if( *deserializePayload<MyTestData>( p0, data1 ) != d0 ){
+      std::cout <<"ERROR: MyTestData object read from the disk cache different from source."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"MyTestData read back from the disk cache"<<std::endl;
+    }
+
+    // a cache file whose content does not match the payload hash is fetched again from the database
+    {
+      std::fstream cacheFile( std::string( cacheDir )+"/"+p0, std::ios::in | std::ios::out | std::ios::binary );
+      cacheFile.seekg( 0, std::ios::end );
+      std::streamoff lastDataByte = std::streamoff( cacheFile.tellg() )-data0.streamerInfo.size()-1;
+      cacheFile.seekg( lastDataByte );
+      char c = cacheFile.get();
+      cacheFile.seekp( lastDataByte );
+      cacheFile.put( c^0x1 );
+    }
+    PayloadData data3;
+    session.transaction().start( true );
+    bool found3 = cache.fetchPayloadData( session, p0, data3 );
+    session.transaction().commit();
+    stats = cache.stats();
+    if( !found3 || stats.diskWrites != 2 || stats.diskReads != 1 ){
+      std::cout <<"ERROR: corrupted disk cache file, writes "<<stats.diskWrites<<" reads "<<stats.diskReads<<std::endl;
+      ret = -1;
+    } else if( *deserializePayload<MyTestData>( p0, data3 ) != d0 ){
+      std::cout <<"ERROR: MyTestData object fetched again different from source."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"Corrupted disk cache file replaced"<<std::endl;
+    }
+
+    // the snapshot gives back the payloads it has been written with
+    std::string snapshotFile = std::string( cacheDir )+"/snapshot.db";
+    std::map<cond::Hash,PayloadData> snapshotPayloads;
+    snapshotPayloads.insert( std::make_pair( p0, data0 ) );
+    PayloadSnapshot::write( snapshotFile, "MyGlobalTag", snapshotPayloads );
+    PayloadSnapshot snapshot( snapshotFile );
+    PayloadData data2;
+    if( snapshot.globalTag() != "MyGlobalTag" || snapshot.size() != 1 || !snapshot.find( p0, data2 ) ){
+      std::cout <<"ERROR: payload not found in the snapshot."<<std::endl;
+      ret = -1;
+    } else if( *deserializePayload<MyTestData>( p0, data2 ) != d0 ){
+      std::cout <<"ERROR: MyTestData object read from the snapshot different from source."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"MyTestData read back from the snapshot"<<std::endl;
+    }
+
+    // concurrent requests for the same payload share a single deserialization
+    std::atomic<int> nLoads(0);
+    std::vector<std::shared_ptr<MyTestData> > results( 8 );
+    std::vector<std::thread> threads;
+    for( size_t i=0; i<results.size(); i++ ){
+      threads.emplace_back( [&,i](){
+	  results[i] = cache.get<MyTestData>( p0, [&](){
+	      ++nLoads;
+	      return deserializePayload<MyTestData>( p0, data1 );
+	    } );
+	} );
+    }
+    for( auto& t : threads ) t.join();
+    bool shared = true;
+    for( auto const& r : results ) shared = shared && r && r == results[0];
+    if( nLoads != 1 || !shared ){
+      std::cout <<"ERROR: payload deserialized "<<nLoads<<" times."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"MyTestData deserialized once for "<<results.size()<<" concurrent requests"<<std::endl;
+    }
+
+    // the proxy finds the payload in the cache
+    IOVEditor editor;
+    session.transaction().start( false );
+    if( !session.existsIov( "MyCachedIOV" ) ){
+      editor = session.createIov<MyTestData>( "MyCachedIOV", cond::runnumber );
+      editor.setDescription("Test with MyTestData class");
+      editor.insert( 1, p0 );
+      editor.flush();
+    }
+    session.transaction().commit();
+    PayloadProxy<MyTestData> pp0;
+    pp0.setUp( session );
+    pp0.loadTag( "MyCachedIOV" );
+    pp0.setIntervalFor( 25, true );
+    if( &pp0() != results[0].get() ){
+      std::cout <<"ERROR: PayloadProxy did not get the cached payload."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"PayloadProxy got the cached payload"<<std::endl;
+    }
+
+    // a prefetched payload is kept in the cache until it is loaded, or released
+    results.clear();
+    pp0.invalidateCache();
+    PayloadProxy<MyTestData> pp1;
+    pp1.setUp( session );
+    pp1.loadTag( "MyCachedIOV" );
+    pp1.setIntervalFor( 25 );
+    auto deserializer = pp1.prefetchPayload();
+    bool prefetched = false;
+    if( deserializer ){
+      deserializer();
+      prefetched = cache.contains<MyTestData>( p0 );
+    }
+    pp1.releasePrefetchedPayload();
+    if( !prefetched || cache.contains<MyTestData>( p0 ) ){
+      std::cout <<"ERROR: prefetched payload not kept in the cache until released."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"Prefetched payload kept in the cache until released"<<std::endl;
+    }
+    deserializer = pp1.prefetchPayload();
+    if( deserializer ) deserializer();
+    size_t misses = cache.stats().misses;
+    pp1.make();
+    if( !deserializer || cache.stats().misses != misses || pp1() != d0 ){
+      std::cout <<"ERROR: PayloadProxy did not load the prefetched payload."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"PayloadProxy loaded the prefetched payload"<<std::endl;
+    }
+
+    // a failed load rolls back the transaction, and a failed prefetch leaves nothing in the cache
+    PayloadProxy<std::string> pp2;
+    pp2.setUp( session );
+    pp2.loadTag( "MyCachedIOV" );
+    bool loadFailed = false;
+    try{
+      pp2.setIntervalFor( 25, true );
+    } catch ( const std::exception& ){
+      loadFailed = true;
+    }
+    if( !loadFailed || session.transaction().isActive() ){
+      std::cout <<"ERROR: failed load not rolled back."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"Failed load rolled back"<<std::endl;
+    }
+    bool prefetchFailed = false;
+    deserializer = pp2.prefetchPayload();
+    try{
+      if( deserializer ) deserializer();
+    } catch ( const std::exception& ){
+      prefetchFailed = true;
+    }
+    pp2.releasePrefetchedPayload();
+    if( !prefetchFailed || session.transaction().isActive() || cache.contains<std::string>( p0 ) ){
+      std::cout <<"ERROR: failed prefetch left a transaction or a cache entry behind."<<std::endl;
+      ret = -1;
+    } else {
+      std::cout <<"Failed prefetch left nothing behind"<<std::endl;
+    }
+
+    ::unlink( (std::string(cacheDir)+"/"+p0).c_str() );
+    ::unlink( snapshotFile.c_str() );
+    ::rmdir( cacheDir );
+  } catch (const std::exception& e){
+    std::cout << "ERROR: " << e.what() << std::endl;
+    return -1;
+  } catch (...){
+    std::cout << "UNEXPECTED FAILURE." << std::endl;
+    return -1;
+  }
+  return ret;
+}
@@ -21,12 +21,19 @@
 #include "CondCore/ESSources/interface/ProxyFactory.h"
 #include "CondCore/ESSources/interface/DataProxy.h"
 
+#include "CondCore/CondDB/interface/PayloadCache.h"
 #include "CondCore/CondDB/interface/PayloadProxy.h"
+#include "CondCore/CondDB/interface/PayloadSnapshot.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include <exception>
+#include <functional>
+#include <vector>
+
+#include "tbb/parallel_for.h"
 
 #include <iomanip>
+#include <unistd.h>
 
 namespace {
   /* utility ot build the name of the plugin corresponding to a given record
@@ -93,6 +100,10 @@ namespace {
  *  config Param
  *  RefreshEachRun: if true will refresh the IOV at each new run (or lumiSection)
  *  DumpStat: if true dump the statistics of all DataProxy (currently on cout)
+ *  prefetchPayloads: if true, at each new IOV sync value the payloads of all the records are fetched, then deserialized in parallel
+ *  payloadCacheDirectory: local directory where the serialized payloads are cached, shared by all the jobs using it
+ *  payloadSnapshotFile: file holding the serialized payloads for the global tag; read, if it exists, unless writePayloadSnapshot is set
+ *  writePayloadSnapshot: if true the payloads used by the job are written to payloadSnapshotFile at the end of the job
  *  DBParameters: configuration set of the connection
  *  globaltag: The GlobalTag
  *  toGet: list of record label tag connection-string to add/overwrite the content of the global-tag
@@ -103,7 +114,12 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
   m_lastRun(0),  // for the stat
   m_lastLumi(0),  // for the stat
   m_policy( NOREFRESH ),
-  m_doDump( iConfig.getUntrackedParameter<bool>( "DumpStat", false ) )
+  m_doDump( iConfig.getUntrackedParameter<bool>( "DumpStat", false ) ),
+  m_prefetchPayloads( iConfig.getUntrackedParameter<bool>( "prefetchPayloads", false ) ),
+  m_lastPrefetchTime( edm::IOVSyncValue::invalidIOVSyncValue() ),
+  m_globalTag(),
+  m_payloadSnapshotFile( iConfig.getUntrackedParameter<std::string>( "payloadSnapshotFile", "" ) ),
+  m_writePayloadSnapshot( iConfig.getUntrackedParameter<bool>( "writePayloadSnapshot", false ) )
 {
   if( iConfig.getUntrackedParameter<bool>( "RefreshAlways", false ) ) {
     m_policy = REFRESH_ALWAYS;
@@ -121,6 +137,18 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
   Stats s = {0,0,0,0,0,0,0,0};
   m_stats = s;	
 
+  // the payload cache is shared by all the sources of the process
+  std::string payloadCacheDirectory = iConfig.getUntrackedParameter<std::string>( "payloadCacheDirectory", "" );
+  if( !payloadCacheDirectory.empty() ) {
+    cond::persistency::PayloadCache::instance().setDiskCacheDirectory( payloadCacheDirectory );
+  }
+  if( m_prefetchPayloads && m_policy != NOREFRESH ) {
+    // the refresh policies reload the tags record by record
+    edm::LogWarning( "CondDBESSource" ) << "prefetchPayloads is not supported together with a refresh policy, it is disabled"
+					<< "; from CondDBESSource::CondDBESSource";
+    m_prefetchPayloads = false;
+  }
+
   /*parameter set parsing
    */  
   std::string globaltag("");
@@ -172,6 +200,27 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
   }
   
   // get the global tag, merge with "replacement" store in "tagCollection"
+  m_globalTag = globaltag;
+  if( !m_payloadSnapshotFile.empty() ) {
+    if( m_writePayloadSnapshot ) {
+      cond::persistency::PayloadCache::instance().recordPayloads( true );
+    } else if( ::access( m_payloadSnapshotFile.c_str(), R_OK ) == 0 ) {
+      auto payloadSnapshot = std::make_shared<cond::persistency::PayloadSnapshot>( m_payloadSnapshotFile );
+      if( payloadSnapshot->globalTag() != globaltag ) {
+	edm::LogWarning( "CondDBESSource" ) << "Payload snapshot \"" << m_payloadSnapshotFile << "\" was written for global tag \""
+					    << payloadSnapshot->globalTag() << "\", not for \"" << globaltag << "\": it is not used"
+					    << "; from CondDBESSource::CondDBESSource";
+      } else {
+	edm::LogInfo( "CondDBESSource" ) << "Reading " << payloadSnapshot->size() << " payloads from snapshot \""
+					 << m_payloadSnapshotFile << "\"; from CondDBESSource::CondDBESSource";
+	cond::persistency::PayloadCache::instance().setSnapshot( payloadSnapshot );
+      }
+    } else {
+      edm::LogWarning( "CondDBESSource" ) << "Payload snapshot \"" << m_payloadSnapshotFile << "\" not found"
+					  << "; from CondDBESSource::CondDBESSource";
+    }
+  }
+
   std::vector<std::string> globaltagList;
   std::vector<std::string> connectList;
   std::vector<std::string> pfnPrefixList;
@@ -293,6 +342,13 @@ void CondDBESSource::fillList(const std::string & stringList, std::vector<std::s
 }
 
 CondDBESSource::~CondDBESSource() {
+  if( m_writePayloadSnapshot && !m_payloadSnapshotFile.empty() ) {
+    try {
+      cond::persistency::PayloadCache::instance().writeSnapshot( m_payloadSnapshotFile, m_globalTag );
+    } catch ( const std::exception& e ) {
+      edm::LogError( "CondDBESSource" ) << e.what() << "; from CondDBESSource::~CondDBESSource";
+    }
+  }
   //dump info FIXME: find a more suitable place...
   if (m_doDump) {
     std::cout << "CondDBESSource Statistics" << std::endl
@@ -305,6 +361,13 @@ CondDBESSource::~CondDBESSource() {
 	      << " Reconnect " << m_stats.nReconnect
 	      << " Actual Reconnect " << m_stats.nActualReconnect;
     std::cout << std::endl;
+    cond::persistency::PayloadCache::Stats cacheStats = cond::persistency::PayloadCache::instance().stats();
+    std::cout << "PayloadCache hits " << cacheStats.hits
+	      << " misses " << cacheStats.misses
+	      << " disk reads " << cacheStats.diskReads
+	      << " disk writes " << cacheStats.diskWrites
+	      << " snapshot reads " << cacheStats.snapshotReads;
+    std::cout << std::endl;
 
 
     ProxyMap::iterator b= m_proxies.begin();
@@ -320,6 +383,57 @@ CondDBESSource::~CondDBESSource() {
 }
 
 
+//
+// fetches the payloads valid at iTime for all the records, serially as the sessions are not thread safe,
+// then deserializes them in parallel into the PayloadCache, where loadPayload will find them.
+// Failures are only reported as warnings here: the error is raised when the payload is actually requested.
+//
+void
+CondDBESSource::prefetchPayloads( const edm::IOVSyncValue& iTime ){
+  struct Deserializer {
+    std::function<void()> deserialize;
+    std::string record;
+    std::string tag;
+    cond::ValidityInterval iov;
+  };
+  std::vector<Deserializer> deserializers;
+  for( auto const& p : m_proxies ){
+    auto proxy = p.second->proxy();
+    cond::Time_t abtime = cond::time::fromIOVSyncValue( iTime, proxy->timeType() );
+    if( 0 == abtime ) continue;
+    try{
+      cond::ValidityInterval iov = proxy->setIntervalFor( abtime );
+      auto deserializer = proxy->prefetchPayload();
+      if( deserializer ) deserializers.push_back( Deserializer{ std::move( deserializer ), p.first, p.second->tag(), iov } );
+    } catch ( const std::exception& e ){
+      proxy->releasePrefetchedPayload();
+      edm::LogInfo( "CondDBESSource" ) << "Could not prefetch the payload for record \"" << p.first
+				       << "\" and label \"" << p.second->label() << "\": " << e.what()
+				       << "; from CondDBESSource::prefetchPayloads";
+    }
+  }
+  tbb::parallel_for( size_t(0), deserializers.size(), [&deserializers]( size_t i ){
+      Deserializer const& d = deserializers[i];
+      std::string error;
+      try{
+	d.deserialize();
+      } catch ( const std::exception& e ){
+	error = e.what();
+      } catch ( ... ){
+	error = "unknown exception";
+      }
+      if( !error.empty() ){
+	edm::LogWarning( "CondDBESSource" ) << "Could not deserialize the prefetched payload of tag \"" << d.tag
+					    << "\" for record \"" << d.record << "\" and IOV [" << d.iov.first << ", " << d.iov.second
+					    << "]: " << error << "; from CondDBESSource::prefetchPayloads";
+      }
+    } );
+  cond::persistency::PayloadCache::instance().purge();
+  edm::LogInfo( "CondDBESSource" ) << "Prefetched " << deserializers.size() << " payloads for "
+				   << iTime.eventID() << ", timestamp: " << iTime.time().value()
+				   << "; from CondDBESSource::prefetchPayloads";
+}
+
 //
 // invoked by EventSetUp: for a given record return the smallest IOV for which iTime is valid
 // limit to next run/lumisection of Refresh is required
@@ -345,6 +459,11 @@ CondDBESSource::setIntervalFor( const edm::eventsetup::EventSetupRecordKey& iKey
       m_stats.nLumi++;
     }
     //}
+
+  if( m_prefetchPayloads && iTime != m_lastPrefetchTime ) {
+    m_lastPrefetchTime = iTime;
+    prefetchPayloads( iTime );
+  }
  
   bool doRefresh = false;
   if( m_policy == REFRESH_EACH_RUN || m_policy == RECONNECT_EACH_RUN ) {
@@ -20,6 +20,7 @@
 
 #include "FWCore/Framework/interface/DataProxyProvider.h"
 #include "FWCore/Framework/interface/EventSetupRecordIntervalFinder.h"
+#include "FWCore/Framework/interface/IOVSyncValue.h"
 //#include "CondCore/DBCommon/interface/Time.h"
 
 namespace edm{
@@ -87,8 +88,17 @@ class CondDBESSource : public edm::eventsetup::DataProxyProvider,
   
   bool m_doDump;
 
+  bool m_prefetchPayloads;
+  edm::IOVSyncValue m_lastPrefetchTime;
+
+  std::string m_globalTag;
+  std::string m_payloadSnapshotFile;
+  bool m_writePayloadSnapshot;
+
  private:
 
+  void prefetchPayloads( const edm::IOVSyncValue& iTime );
+
   void fillList(const std::string & pfn, std::vector<std::string> & pfnList, const unsigned int listSize, const std::string & type);
 
   void fillTagCollectionFromGT(const std::string & connectionString,
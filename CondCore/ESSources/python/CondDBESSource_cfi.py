@@ -17,4 +17,8 @@ GlobalTag = cms.ESSource( "PoolDBESSource",
                           RefreshOpenIOVs  = cms.untracked.bool( False ),
                           pfnPostfix       = cms.untracked.string( '' ),
                           pfnPrefix        = cms.untracked.string( '' ),
+                          prefetchPayloads = cms.untracked.bool( False ),
+                          payloadCacheDirectory = cms.untracked.string( '' ),
+                          payloadSnapshotFile = cms.untracked.string( '' ),
+                          writePayloadSnapshot = cms.untracked.bool( False ),
                           )
@@ -6,24 +6,32 @@
  * ...
  */
 
+#include <memory>
 #include <mutex>
 #include <tbb/spin_mutex.h>
 
 #include "DQMServices/Core/interface/MonitorElement.h"
+#include "DQMServices/Core/interface/MonitorElementShards.h"
 
 class ConcurrentMonitorElement
 {
 private:
   mutable MonitorElement* me_;
+  // per-stream shards shared with the DQMStore, if sharding is enabled;
+  // the DQMStore releases their content at the end of the run, after which
+  // the fills go to the booked MonitorElement
+  std::shared_ptr<MonitorElementShards> shards_;
   mutable tbb::spin_mutex lock_;
 
 public:
   ConcurrentMonitorElement(void) :
-    me_(nullptr)
+    me_(nullptr),
+    shards_(nullptr)
   { }
 
-  explicit ConcurrentMonitorElement(MonitorElement* me) :
-    me_(me)
+  explicit ConcurrentMonitorElement(MonitorElement* me, std::shared_ptr<MonitorElementShards> shards = nullptr) :
+    me_(me),
+    shards_(std::move(shards))
   { }
 
   // non-copiable
@@ -34,6 +42,7 @@ public:
   {
     std::lock_guard<tbb::spin_mutex> guard(other.lock_);
     me_ = other.me_;
+    shards_ = std::move(other.shards_);
     other.me_ = nullptr;
   }
 
@@ -48,6 +57,7 @@ public:
     std::lock_guard<tbb::spin_mutex> ours(lock_, std::adopt_lock);
     std::lock_guard<tbb::spin_mutex> others(other.lock_, std::adopt_lock);
     me_ = other.me_;
+    shards_ = std::move(other.shards_);
     other.me_ = nullptr;
     return *this;
   }
@@ -59,11 +69,19 @@ public:
   template <typename... Args>
   void fill(Args && ... args) const
   {
+    // lock-free if the current stream owns a shard
+    if (shards_) {
+      if (MonitorElement* shard = shards_->shard(lock_)) {
+        shard->Fill(std::forward<Args>(args)...);
+        return;
+      }
+    }
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_->Fill(std::forward<Args>(args)...);
   }
 
   // expose as a const method to mean that it is concurrent-safe
+  // always applied to the booked MonitorElement, since it depends on the order of the fills
   void shiftFillLast(double y, double ye = 0., int32_t xscale = 1) const
   {
     std::lock_guard<tbb::spin_mutex> guard(lock_);
@@ -75,6 +93,7 @@ public:
   {
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_ = nullptr;
+    shards_.reset();
   }
 
   operator bool() const
@@ -54,10 +54,12 @@ DQMGlobalEDAnalyzer<H, Args...>::globalEndRun(edm::Run const&, edm::EventSetup c
 
 template <typename H, typename... Args>
 void
-DQMGlobalEDAnalyzer<H, Args...>::analyze(edm::StreamID, edm::Event const& event, edm::EventSetup const& setup) const
+DQMGlobalEDAnalyzer<H, Args...>::analyze(edm::StreamID stream, edm::Event const& event, edm::EventSetup const& setup) const
 {
   //auto& h = const_cast<H&>(* this->runCache(event.getRun().index()));
   auto const& h = * this->runCache(event.getRun().index());
+  // let the ConcurrentMonitorElements fill the shard of this stream, if any
+  MonitorElementShards::StreamScope scope(stream.value());
   dqmAnalyze(event, setup, h);
 }
 
@@ -147,7 +147,7 @@ public:
     ConcurrentMonitorElement book##suffix(Args&&... args)               \
     {                                                                   \
       MonitorElement* me = IBooker::book##suffix(std::forward<Args>(args)...); \
-      return ConcurrentMonitorElement(me);                              \
+      return ConcurrentMonitorElement(me, store_->makeShards(me));      \
     }
 
     // For the supported interface, see the DQMStore function that
@@ -177,10 +177,13 @@ public:
 
   private:
     explicit ConcurrentBooker(DQMStore* store) noexcept :
-      IBooker{store}
+      IBooker{store},
+      store_{store}
     {}
 
     ~ConcurrentBooker() = default;
+
+    DQMStore* store_;
   };
 
   class IGetter {
@@ -554,6 +557,11 @@ private:
   void forceReset();
   void postGlobalBeginLumi(const edm::GlobalContext&);
 
+  // ------------- Per-stream shards of ConcurrentMonitorElements -------------
+  std::shared_ptr<MonitorElementShards> makeShards(MonitorElement* me);
+  void mergeShards();
+  void postGlobalEndRun(const edm::GlobalContext&);
+
   bool extract(TObject* obj, std::string const& dir, bool overwrite, bool collateHistograms);
   TObject* extractNextObject(TBufferFile&) const;
 
@@ -635,6 +643,8 @@ private:
   bool enableMultiThread_{false};
   bool LSbasedMode_;
   bool forceResetOnBeginLumi_{false};
+  bool shardConcurrentMonitorElements_{false};
+  unsigned int nStreams_{1};
   std::string readSelectedDirectory_{};
   uint32_t run_{};
   uint32_t moduleId_{};
@@ -648,6 +658,10 @@ private:
   QAMap qalgos_;
   QTestSpecs qtestspecs_;
 
+  // shards of the ConcurrentMonitorElements booked for the current run,
+  // guarded by book_mutex_
+  std::vector<std::shared_ptr<MonitorElementShards>> shards_;
+
   std::mutex book_mutex_;
 
   friend class edm::DQMHttpSource;
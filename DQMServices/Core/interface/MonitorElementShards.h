@@ -0,0 +1,85 @@
+#ifndef DQMServices_Core_MonitorElementShards_h
+#define DQMServices_Core_MonitorElementShards_h
+
+/* Per-stream copies of a MonitorElement, used by ConcurrentMonitorElement
+ * when the DQMStore is configured with shardConcurrentMonitorElements.
+ *
+ * Each stream fills its own shard without taking any lock; the shards are
+ * added to the MonitorElement booked in the DQMStore, and reset, by the
+ * DQMStore at the end of every luminosity block and run, when no event is
+ * being processed.  A shard is created by the first fill made from its
+ * stream, so that it picks up the binning, labels and options set on the
+ * booked MonitorElement after booking.
+ *
+ * The stream being processed by the current thread is set by
+ * DQMGlobalEDAnalyzer around the call to dqmAnalyze.  Fills made from any
+ * other context have no shard and go to the booked MonitorElement under the
+ * ConcurrentMonitorElement lock.
+ */
+
+#include <memory>
+#include <vector>
+#include <tbb/spin_mutex.h>
+
+#include "DQMServices/Core/interface/MonitorElement.h"
+
+class MonitorElementShards
+{
+public:
+  static constexpr unsigned int invalidStream = ~0U;
+
+  // sets the stream of the current thread for the lifetime of the object
+  class StreamScope
+  {
+  public:
+    explicit StreamScope(unsigned int stream);
+    ~StreamScope();
+
+    StreamScope(StreamScope const&) = delete;
+    StreamScope& operator=(StreamScope const&) = delete;
+
+  private:
+    unsigned int previous_;
+  };
+
+  MonitorElementShards(MonitorElement* me, unsigned int nStreams);
+
+  MonitorElementShards(MonitorElementShards const&) = delete;
+  MonitorElementShards& operator=(MonitorElementShards const&) = delete;
+
+  // shard of the stream of the current thread, or nullptr if there is none;
+  // lock is the one protecting the fills of the booked MonitorElement, which
+  // is held while the booked MonitorElement is copied into a new shard
+  MonitorElement* shard(tbb::spin_mutex& lock)
+  {
+    unsigned int stream = currentStream_;
+    if (stream >= shards_.size())
+      return nullptr;
+    MonitorElement* shard = shards_[stream].get();
+    return shard ? shard : makeShard(stream, lock);
+  }
+
+  // add the content of the shards to the booked MonitorElement and reset them;
+  // must not run concurrently with any fill
+  void merge();
+
+  // number of shards created so far
+  unsigned int size() const;
+
+  // free the shards once the booked MonitorElement is not filled anymore;
+  // later fills find no shard and go to the booked MonitorElement.
+  // Must not run concurrently with any fill
+  void release();
+
+  static bool supports(MonitorElement const* me);
+
+private:
+  MonitorElement* makeShard(unsigned int stream, tbb::spin_mutex& lock);
+
+  MonitorElement* me_;
+  std::vector<std::unique_ptr<MonitorElement>> shards_;
+
+  static thread_local unsigned int currentStream_;
+};
+
+#endif // DQMServices_Core_MonitorElementShards_h
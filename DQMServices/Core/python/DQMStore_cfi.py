@@ -10,5 +10,9 @@ DQMStore = cms.Service("DQMStore",
     #MEs are flagged to be LS based.
     LSbasedMode = cms.untracked.bool(False),
     #this is bound to the enableMultiThread flag.
-    forceResetOnBeginLumi = cms.untracked.bool(False)
+    forceResetOnBeginLumi = cms.untracked.bool(False),
+    #fill per-stream copies of the ConcurrentMonitorElements without locking,
+    #and merge them at the end of each lumisection and run. The memory used
+    #by these MEs grows with the number of streams.
+    shardConcurrentMonitorElements = cms.untracked.bool(False)
 )
@@ -16,6 +16,9 @@ if len(sys.argv) < 1:
     sys.exit(1)
 
 filename = sys.argv[1]
+# optional: number of entries expected in each histogram
+if len(sys.argv) > 2:
+    numEntries = int(sys.argv[2])
 m = re.match(RXOFFLINE, filename)
 if not m:
     print("Error: wrong file supplied\n")
@@ -33,8 +33,9 @@ run_step2_edm() {
 
 check_files() {
 filter=$1;shift
+entries=$1
  for f in $(ls ${filter}); do
-   python check_harvesting.py ${f}
+   python check_harvesting.py ${f} ${entries}
    ret=$?
    if [ ${ret} -ne 0 ]; then
      print_abort ${ret}
@@ -42,6 +43,16 @@ filter=$1;shift
  done
 }
 
+check_file_count() {
+  filter=$1;shift
+  expected=$1
+  found=$(ls ${filter} | wc -l)
+  if [ ${found} -ne ${expected} ]; then
+    echo "Found ${found} files matching ${filter} instead of ${expected}"
+    print_abort 1
+  fi
+}
+
 run_step1_dqmio() {
   echo 'Running first step for DQMIO'
   cmsRun dqm_testMultiThread_DQMIO_cfg.py &> /dev/null
@@ -60,6 +71,14 @@ run_step2_dqmio() {
   fi
 }
 
+run_global_sharded() {
+  echo 'Running DQMGlobalEDAnalyzer with sharded ConcurrentMonitorElements'
+  cmsRun dqm_testGlobalMultiThread_cfg.py &> /dev/null
+  ret=$?
+  if [ ${ret} -ne 0 ]; then
+    print_abort ${ret}
+  fi
+}
 
 clean_files
 run_step1_edm
@@ -68,4 +87,8 @@ check_files "*EDM_Harvesting.root"
 run_step1_dqmio
 run_step2_dqmio
 check_files "*DQMIO_Harvesting.root"
+run_global_sharded
+# 2000 events in 4 runs: every event must be found in the merged histograms
+check_file_count "*GlobalWorkflow.root" 4
+check_files "*GlobalWorkflow.root" 500
 echo 'Test Successful'
@@ -371,6 +371,15 @@ DQMStore::DQMStore(edm::ParameterSet const& pset, edm::ActivityRegistry& ar)
       if(iBounds.maxNumberOfStreams() > 1 ) {
         enableMultiThread_ = true;
       }
+      nStreams_ = iBounds.maxNumberOfStreams();
+      // the shards are merged when no event is being processed, which is
+      // only guaranteed at the end of a lumi or run if they do not overlap
+      if (shardConcurrentMonitorElements_ and
+          (iBounds.maxNumberOfConcurrentLuminosityBlocks() > 1 or iBounds.maxNumberOfConcurrentRuns() > 1)) {
+        shardConcurrentMonitorElements_ = false;
+        std::cout << "DQMStore: shardConcurrentMonitorElements option is disabled, "
+                  << "it requires a single concurrent luminosity block and run\n";
+      }
     });
   if(pset.getUntrackedParameter<bool>("forceResetOnBeginRun",false)) {
     ar.watchPostSourceRun([this](edm::RunIndex){ forceReset(); });
@@ -380,6 +389,11 @@ DQMStore::DQMStore(edm::ParameterSet const& pset, edm::ActivityRegistry& ar)
     ar.watchPostSourceLumi([this](edm::LuminosityBlockIndex){ forceReset(); });
   }
   ar.watchPostGlobalBeginLumi(this, &DQMStore::postGlobalBeginLumi);
+  if (shardConcurrentMonitorElements_) {
+    ar.watchPreGlobalEndLumi([this](edm::GlobalContext const&){ mergeShards(); });
+    ar.watchPreGlobalEndRun([this](edm::GlobalContext const&){ mergeShards(); });
+    ar.watchPostGlobalEndRun(this, &DQMStore::postGlobalEndRun);
+  }
 }
 
 DQMStore::DQMStore(edm::ParameterSet const& pset)
@@ -419,6 +433,10 @@ DQMStore::initializeFrom(edm::ParameterSet const& pset)
   if (enableMultiThread_)
     std::cout << "DQMStore: MultiThread option is enabled\n";
 
+  shardConcurrentMonitorElements_ = pset.getUntrackedParameter<bool>("shardConcurrentMonitorElements", false);
+  if (shardConcurrentMonitorElements_)
+    std::cout << "DQMStore: shardConcurrentMonitorElements option is enabled\n";
+
   LSbasedMode_ = pset.getUntrackedParameter<bool>("LSbasedMode", false);
   if (LSbasedMode_)
     std::cout << "DQMStore: LSbasedMode option is enabled\n";
@@ -1894,6 +1912,50 @@ DQMStore::postGlobalBeginLumi(edm::GlobalContext const& gc)
   }
 }
 
+/** Create the per-stream shards of a ConcurrentMonitorElement being booked.
+ * Called from bookConcurrentTransaction, i.e. while holding book_mutex_.
+ * Returns nullptr if sharding is disabled or not applicable to the ME.
+ */
+std::shared_ptr<MonitorElementShards>
+DQMStore::makeShards(MonitorElement* me)
+{
+  if (not shardConcurrentMonitorElements_ or not MonitorElementShards::supports(me))
+    return nullptr;
+  shards_.push_back(std::make_shared<MonitorElementShards>(me, nStreams_));
+  return shards_.back();
+}
+
+/** Add the content of all the shards to the booked MEs, before the
+ * end of lumi and end of run transitions make use of them.
+ */
+void
+DQMStore::mergeShards()
+{
+  std::lock_guard<std::mutex> guard(book_mutex_);
+  for (auto& shards : shards_)
+    shards->merge();
+}
+
+/** The MEs booked for the run are not filled anymore, drop their shards.
+ * The ConcurrentMonitorElements still hold the emptied MonitorElementShards,
+ * so a late fill goes to the booked ME instead of a freed shard.
+ */
+void
+DQMStore::postGlobalEndRun(edm::GlobalContext const&)
+{
+  std::lock_guard<std::mutex> guard(book_mutex_);
+  if (verbose_ > 0) {
+    unsigned int n = 0;
+    for (auto const& shards : shards_)
+      n += shards->size();
+    std::cout << "DQMStore: " << n << " shards used by "
+              << shards_.size() << " ConcurrentMonitorElements\n";
+  }
+  for (auto& shards : shards_)
+    shards->release();
+  shards_.clear();
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -0,0 +1,85 @@
+#include <mutex>
+
+#include "DQMServices/Core/interface/MonitorElementShards.h"
+
+#include "TH1.h"
+
+thread_local unsigned int MonitorElementShards::currentStream_ = MonitorElementShards::invalidStream;
+
+namespace {
+  // cloning a ROOT histogram is not guaranteed to be thread safe
+  std::mutex s_clone_mutex;
+}
+
+MonitorElementShards::StreamScope::StreamScope(unsigned int stream) :
+  previous_(currentStream_)
+{
+  currentStream_ = stream;
+}
+
+MonitorElementShards::StreamScope::~StreamScope()
+{
+  currentStream_ = previous_;
+}
+
+MonitorElementShards::MonitorElementShards(MonitorElement* me, unsigned int nStreams) :
+  me_(me),
+  shards_(nStreams)
+{ }
+
+bool
+MonitorElementShards::supports(MonitorElement const* me)
+{
+  // scalars are overwritten by each fill, so there is nothing to merge
+  return me != nullptr and me->kind() >= MonitorElement::DQM_KIND_TH1F;
+}
+
+MonitorElement*
+MonitorElementShards::makeShard(unsigned int stream, tbb::spin_mutex& lock)
+{
+  std::lock_guard<std::mutex> guard(s_clone_mutex);
+  std::unique_ptr<MonitorElement> shard;
+  {
+    // the booked MonitorElement may be filled meanwhile from a context without a shard
+    std::lock_guard<tbb::spin_mutex> meGuard(lock);
+    shard = std::make_unique<MonitorElement>(*me_);
+  }
+  shard->getTH1()->SetDirectory(nullptr);
+  shard->Reset();
+  shards_[stream] = std::move(shard);
+  return shards_[stream].get();
+}
+
+void
+MonitorElementShards::merge()
+{
+  TH1* target = me_->getTH1();
+  for (auto& shard : shards_) {
+    if (not shard)
+      continue;
+    TH1* source = shard->getTH1();
+    if (source->GetEntries() == 0)
+      continue;
+    target->Add(source);
+    me_->update();
+    source->Reset();
+  }
+}
+
+unsigned int
+MonitorElementShards::size() const
+{
+  unsigned int n = 0;
+  for (auto const& shard : shards_)
+    if (shard)
+      ++n;
+  return n;
+}
+
+void
+MonitorElementShards::release()
+{
+  // with no shard left, shard() returns nullptr for every stream
+  shards_.clear();
+  shards_.shrink_to_fit();
+}
@@ -0,0 +1,59 @@
+#include "DQMServices/Core/interface/DQMGlobalEDAnalyzer.h"
+#include "DQMServices/Core/interface/DQMStore.h"
+#include "DQMServices/Core/interface/ConcurrentMonitorElement.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <string>
+
+struct DQMTestGlobalMultiThreadHistograms {
+  ConcurrentMonitorElement values;
+  ConcurrentMonitorElement profile;
+};
+
+class DQMTestGlobalMultiThread
+    : public DQMGlobalEDAnalyzer<DQMTestGlobalMultiThreadHistograms>
+{
+ public:
+  explicit DQMTestGlobalMultiThread(const edm::ParameterSet&);
+
+ private:
+  void bookHistograms(DQMStore::ConcurrentBooker&,
+                      edm::Run const&,
+                      edm::EventSetup const&,
+                      DQMTestGlobalMultiThreadHistograms&) const override;
+
+  void dqmAnalyze(edm::Event const&,
+                  edm::EventSetup const&,
+                  DQMTestGlobalMultiThreadHistograms const&) const override;
+
+  std::string folder_;
+  double fill_value_;
+};
+
+DQMTestGlobalMultiThread::DQMTestGlobalMultiThread(const edm::ParameterSet &pset)
+    : folder_(pset.getUntrackedParameter<std::string>("folder")),
+      fill_value_(pset.getUntrackedParameter<double>("fillValue", 1.))
+{}
+
+void DQMTestGlobalMultiThread::bookHistograms(DQMStore::ConcurrentBooker &b,
+                                              edm::Run const & /* iRun*/,
+                                              edm::EventSetup const & /* iSetup*/,
+                                              DQMTestGlobalMultiThreadHistograms & h) const {
+  b.setCurrentFolder(folder_);
+  h.values = b.book1D("MyHisto", "MyHisto", 100, -0.5, 99.5);
+  h.values.setXTitle("value");
+  h.profile = b.bookProfile("MyProfile", "MyProfile", 100, -0.5, 99.5, 0., 100.);
+}
+
+void DQMTestGlobalMultiThread::dqmAnalyze(edm::Event const& iEvent,
+                                          edm::EventSetup const&,
+                                          DQMTestGlobalMultiThreadHistograms const& h) const
+{
+  h.values.fill(fill_value_);
+  h.profile.fill(fill_value_, static_cast<double>(iEvent.id().event() % 100));
+}
+
+// define this as a plug-in
+DEFINE_FWK_MODULE(DQMTestGlobalMultiThread);
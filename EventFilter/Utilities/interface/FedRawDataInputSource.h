@@ -1,11 +1,13 @@
 #ifndef EventFilter_Utilities_FedRawDataInputSource_h
 #define EventFilter_Utilities_FedRawDataInputSource_h
 
+#include <cassert>
 #include <memory>
 #include <cstdio>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
+#include <sys/mman.h>
 #include "tbb/concurrent_queue.h"
 #include "tbb/concurrent_vector.h"
 
@@ -65,6 +67,9 @@ private:
   //functions for single buffered reader
   void readNextChunkIntoBuffer(InputFile *file);
 
+  //function for memory-mapped reader
+  InputChunk* mapFile(std::string const& fileName, uint64_t fileSize);
+
   //monitoring
   void reportEventsThisLumiInSource(unsigned int lumi,unsigned int events);
 
@@ -91,6 +96,7 @@ private:
   const bool verifyAdler32_;
   const bool verifyChecksum_;
   const bool useL1EventID_;
+  const bool useMMap_;
   std::vector<std::string> fileNames_;
   bool useFileBroker_;
   //std::vector<std::string> fileNamesSorted_;
@@ -183,11 +189,17 @@ struct InputChunk {
   unsigned int offset_;
   unsigned int fileIndex_;
   std::atomic<bool> readComplete_;
+  const bool mapped_ = false;
 
   InputChunk(unsigned int index, uint32_t size): size_(size),index_(index) {
     buf_ = new unsigned char[size_];
     reset(0,0,0);
   }
+  //read-only view of a whole memory-mapped file, owned by its InputFile
+  InputChunk(unsigned char * mapping, uint32_t size): buf_(mapping),size_(size),index_(0),mapped_(true) {
+    reset(0,size,0);
+    readComplete_=true;
+  }
   void reset(unsigned int newOffset, unsigned int toRead, unsigned int fileIndex) {
     offset_=newOffset;
     usedSize_=toRead;
@@ -195,7 +207,10 @@ struct InputChunk {
     readComplete_=false;
   }
 
-  ~InputChunk() {delete[] buf_;}
+  ~InputChunk() {
+    if (mapped_) munmap(buf_,size_);
+    else delete[] buf_;
+  }
 };
 
 
@@ -232,6 +247,18 @@ struct InputFile {
 
   InputFile(std::string & name):fileName_(name) {}
 
+  ~InputFile() {
+    //buffered chunks are recycled by the source, mapped chunks are released with the file.
+    //Reading mapped_ from a buffered chunk is safe only because the chunks of the freeChunks_
+    //pool are never deleted (not even by the source destructor), so they outlive every InputFile
+    for (auto chunk : chunks_) {
+      if (chunk && chunk->mapped_) {
+        assert(chunk->index_==0 && chunk->size_==fileSize_);
+        delete chunk;
+      }
+    }
+  }
+
   bool waitForChunk(unsigned int chunkid) {
     //some atomics to make sure everything is cache synchronized for the main thread
     return chunks_[chunkid]!=nullptr && chunks_[chunkid]->readComplete_;
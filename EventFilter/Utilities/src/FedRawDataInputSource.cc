@@ -12,6 +12,7 @@
 #include <zlib.h>
 #include <cstdio>
 #include <chrono>
+#include <limits>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/fstream.hpp>
@@ -64,6 +65,7 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset,
   verifyAdler32_(pset.getUntrackedParameter<bool> ("verifyAdler32", true)),
   verifyChecksum_(pset.getUntrackedParameter<bool> ("verifyChecksum", true)),
   useL1EventID_(pset.getUntrackedParameter<bool> ("useL1EventID", false)),
+  useMMap_(pset.getUntrackedParameter<bool> ("useMMap", false)),
   fileNames_(pset.getUntrackedParameter<std::vector<std::string>> ("fileNames",std::vector<std::string>())),
   fileListMode_(pset.getUntrackedParameter<bool> ("fileListMode", false)),
   fileListLoopMode_(pset.getUntrackedParameter<bool> ("fileListLoopMode", false)),
@@ -109,8 +111,9 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset,
     throw cms::Exception("FedRawDataInputSource::FedRawDataInputSource") <<
 	           "no reading enabled with numBuffers parameter 0";
 
-  numConcurrentReads_=numBuffers_-1;
-  singleBufferMode_ = !(numBuffers_>1);
+  //memory-mapped files need neither chunk buffers nor reader threads
+  numConcurrentReads_= useMMap_ ? 0 : numBuffers_-1;
+  singleBufferMode_ = !useMMap_ && !(numBuffers_>1);
   readingFilesCount_=0;
 
   if (!crc32c_hw_test())
@@ -147,9 +150,13 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset,
    fms_->setInStateSup(evf::FastMonitoringThread::inInit);
   }
   //should delete chunks when run stops
-  for (unsigned int i=0;i<numBuffers_;i++) {
-    freeChunks_.push(new InputChunk(i,eventChunkSize_));
+  if (!useMMap_) {
+    for (unsigned int i=0;i<numBuffers_;i++) {
+      freeChunks_.push(new InputChunk(i,eventChunkSize_));
+    }
   }
+  else
+    edm::LogInfo("FedRawDataInputSource") << "Input files will be memory-mapped";
 
   quit_threads_ = false;
 
@@ -214,6 +221,7 @@ void FedRawDataInputSource::fillDescriptions(edm::ConfigurationDescriptions& des
   desc.addUntracked<bool> ("verifyAdler32", true)->setComment("Verify event Adler32 checksum with FRDv3 or v4");
   desc.addUntracked<bool> ("verifyChecksum", true)->setComment("Verify event CRC-32C checksum of FRDv5 or higher");
   desc.addUntracked<bool> ("useL1EventID", false)->setComment("Use L1 event ID from FED header if true or from TCDS FED if false");
+  desc.addUntracked<bool> ("useMMap", false)->setComment("Memory-map raw files instead of reading them into chunk buffers (numBuffers and eventChunkBlock are then not used). Files larger than 4 GB can not be mapped and make the source fail");
   desc.addUntracked<bool> ("fileListMode", false)->setComment("Use fileNames parameter to directly specify raw files to open");
   desc.addUntracked<std::vector<std::string>> ("fileNames", std::vector<std::string>())->setComment("file list used when fileListMode is enabled");
   desc.setAllowAnything();
@@ -421,8 +429,9 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
   //file is finished
   if (currentFile_->bufferPosition_==currentFile_->fileSize_) {
     readingFilesCount_--;
-    //release last chunk (it is never released elsewhere)
-    freeChunks_.push(currentFile_->chunks_[currentFile_->currentChunk_]);
+    //release last chunk (it is never released elsewhere), mapped chunk is released with the file
+    if (!useMMap_)
+      freeChunks_.push(currentFile_->chunks_[currentFile_->currentChunk_]);
     if (currentFile_->nEvents_>=0 && currentFile_->nEvents_!=int(currentFile_->nProcessed_))
     {
       throw cms::Exception("FedRawDataInputSource::getNextEvent")
@@ -431,8 +440,8 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
 	<< " but according to BU JSON there should be "
 	<< currentFile_->nEvents_ << " events";
     }
-    //try to wake up supervisor thread which might be sleeping waiting for the free chunk
-    if (singleBufferMode_) {
+    //try to wake up supervisor thread which might be sleeping waiting for the free chunk or file slot
+    if (singleBufferMode_ || useMMap_) {
       std::unique_lock<std::mutex> lkw(mWakeup_);
       cvWakeup_.notify_one();
     }
@@ -458,7 +467,21 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
     throw cms::Exception("FedRawDataInputSource::getNextEvent") <<
       "Premature end of input file while reading event header";
   }
-  if (singleBufferMode_) {
+  if (useMMap_) {
+
+    //whole file is mapped, event is always contiguous
+    unsigned char *dataPosition = currentFile_->chunks_[0]->buf_+ currentFile_->bufferPosition_;
+    event_.reset( new FRDEventMsgView(dataPosition) );
+    if (event_->size()<FRDHeaderVersionSize[detectedFRDversion_] ||
+        currentFile_->fileSize_ - currentFile_->bufferPosition_ < event_->size())
+    {
+      throw cms::Exception("FedRawDataInputSource::getNextEvent") <<
+	"Premature end of input file while reading event data";
+    }
+    currentFile_->bufferPosition_ += event_->size();
+    currentFile_->chunkPosition_ += event_->size();
+  }
+  else if (singleBufferMode_) {
 
     //should already be there
     if (fms_) fms_->setInState(evf::FastMonitoringThread::inWaitChunk);
@@ -797,7 +820,8 @@ void FedRawDataInputSource::readSupervisor()
 
     //wait for at least one free thread and chunk
     int counter=0;
-    while ((workerPool_.empty() && !singleBufferMode_) || freeChunks_.empty() || readingFilesCount_>=maxBufferedFiles_)
+    while ((!useMMap_ && ((workerPool_.empty() && !singleBufferMode_) || freeChunks_.empty()))
+           || readingFilesCount_>=maxBufferedFiles_)
     {
       //report state to monitoring
       if (fms_) {
@@ -825,7 +849,7 @@ void FedRawDataInputSource::readSupervisor()
         LogDebug("FedRawDataInputSource") << "No free chunks or threads...";
       }
       else {
-        assert(!(workerPool_.empty() && !singleBufferMode_) || freeChunks_.empty());
+        assert(useMMap_ || !(workerPool_.empty() && !singleBufferMode_) || freeChunks_.empty());
       }
       if (quit_threads_.load(std::memory_order_relaxed) || edm::shutdown_flag.load(std::memory_order_relaxed)) {stop=true;break;}
     }
@@ -1004,7 +1028,26 @@ void FedRawDataInputSource::readSupervisor()
         assert((eventsInNewFile>0) == (fileSize>0));//file without events must be empty
       }
 
-      if (!singleBufferMode_) {
+      if (useMMap_) {
+        //the whole file becomes a single chunk
+        InputFile * newInputFile = new InputFile(evf::EvFDaqDirector::FileStatus::newFile,ls,rawFile,fileSize,fileSize ? 1 : 0,eventsInNewFile,this);
+        if (fileSize) {
+          InputChunk * newChunk = mapFile(rawFile,fileSize);
+          if (newChunk == nullptr) {
+            delete newInputFile;
+            setExceptionState_=true;
+            break;
+          }
+          if (detectedFRDversion_==0) detectedFRDversion_=*((uint32*)newChunk->buf_);
+          assert(detectedFRDversion_<=5);
+          newInputFile->chunks_[0]=newChunk;
+        }
+        std::unique_lock<std::mutex> lkw(mWakeup_);
+        readingFilesCount_++;
+        fileQueue_.push(newInputFile);
+        cvWakeup_.notify_one();
+      }
+      else if (!singleBufferMode_) {
 	//calculate number of needed chunks
 	unsigned int neededChunks = fileSize/eventChunkSize_;
 	if (fileSize%eventChunkSize_) neededChunks++;
@@ -1324,6 +1367,36 @@ void FedRawDataInputSource::readNextChunkIntoBuffer(InputFile *file)
 }
 
 
+//memory-mapped file reading
+InputChunk* FedRawDataInputSource::mapFile(std::string const& fileName, uint64_t fileSize)
+{
+  //chunk sizes and offsets are 32 bit, a mapped file is a single chunk
+  if (fileSize > std::numeric_limits<uint32_t>::max()) {
+    edm::LogError("FedRawDataInputSource") << "mapFile: file -: " << fileName << " of size " << fileSize
+                                           << " is too large to be mapped (4 GB limit), run with useMMap=False";
+    return nullptr;
+  }
+  int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+  if (fileDescriptor<0) {
+    edm::LogError("FedRawDataInputSource") <<
+    "mapFile failed to open file -: " << fileName << " fd:" << fileDescriptor <<" error: " << strerror(errno);
+    return nullptr;
+  }
+  void * mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  //mapping stays valid after the descriptor is closed
+  close(fileDescriptor);
+  if (mapping==MAP_FAILED) {
+    edm::LogError("FedRawDataInputSource") <<
+    "mapFile failed to map file -: " << fileName << " error: " << strerror(errno);
+    return nullptr;
+  }
+  //events are consumed in order, let the kernel read ahead
+  madvise(mapping, fileSize, MADV_SEQUENTIAL);
+  madvise(mapping, fileSize, MADV_WILLNEED);
+  LogDebug("FedRawDataInputSource") << "mapped file -: " << fileName << " size: " << fileSize;
+  return new InputChunk((unsigned char*)mapping, (uint32_t)fileSize);
+}
+
 void FedRawDataInputSource::reportEventsThisLumiInSource(unsigned int lumi,unsigned int events)
 {
 
@@ -0,0 +1,67 @@
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+#reads FRD files given on the command line with FedRawDataInputSource in fileListMode
+#and prints a checksum of the FED data of every event
+
+options = VarParsing.VarParsing ('analysis')
+
+options.register ('runNumber',
+                  100, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Run Number")
+
+options.register ('fuBaseDir',
+                  '.', # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "FU base directory")
+
+options.register ('useMMap',
+                  False, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.bool,
+                  "Memory-map the raw files")
+
+options.register ('numThreads',
+                  1, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Number of CMSSW threads")
+
+options.parseArguments()
+
+process = cms.Process("TESTFU")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.numThreads),
+    numberOfStreams = cms.untracked.uint32(options.numThreads),
+)
+
+process.EvFDaqDirector = cms.Service("EvFDaqDirector",
+    runNumber = cms.untracked.uint32(options.runNumber),
+    baseDir = cms.untracked.string(options.fuBaseDir),
+    buBaseDir = cms.untracked.string(options.fuBaseDir),
+    directorIsBu = cms.untracked.bool(False))
+
+process.source = cms.Source("FedRawDataInputSource",
+    runNumber = cms.untracked.uint32(options.runNumber),
+    getLSFromFilename = cms.untracked.bool(True),
+    verifyAdler32 = cms.untracked.bool(True),
+    verifyChecksum = cms.untracked.bool(True),
+    useL1EventID = cms.untracked.bool(True),
+    eventChunkSize = cms.untracked.uint32(4),
+    eventChunkBlock = cms.untracked.uint32(1),
+    numBuffers = cms.untracked.uint32(2),
+    useMMap = cms.untracked.bool(options.useMMap),
+    fileListMode = cms.untracked.bool(True),
+    fileNames = cms.untracked.vstring(options.inputFiles)
+    )
+
+process.a = cms.EDAnalyzer("RawDataChecksumAnalysis")
+
+process.p = cms.Path(process.a)
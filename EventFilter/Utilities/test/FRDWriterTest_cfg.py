@@ -0,0 +1,52 @@
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+#writes a few FRD files with fake FED payloads into buBaseDir/run<runNumber>
+
+options = VarParsing.VarParsing ('analysis')
+
+options.register ('runNumber',
+                  100, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Run Number")
+
+options.register ('buBaseDir',
+                  '.', # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "BU base directory")
+
+options.parseArguments()
+
+process = cms.Process("FAKEBU")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(40)
+)
+
+process.source = cms.Source("EmptySource",
+     firstRun= cms.untracked.uint32(options.runNumber),
+     numberEventsInLuminosityBlock = cms.untracked.uint32(15),
+     numberEventsInRun       = cms.untracked.uint32(0)
+)
+
+process.EvFDaqDirector = cms.Service("EvFDaqDirector",
+    runNumber = cms.untracked.uint32(options.runNumber),
+    baseDir = cms.untracked.string(options.buBaseDir),
+    buBaseDir = cms.untracked.string(options.buBaseDir),
+    directorIsBu = cms.untracked.bool(True))
+
+process.s = cms.EDProducer("DaqFakeReader",
+                           meanSize = cms.untracked.uint32(1024),
+                           width = cms.untracked.uint32(512),
+                           injectErrPpm = cms.untracked.uint32(0)
+                           )
+
+process.out = cms.OutputModule("RawStreamFileWriterForBU",
+    ProductLabel = cms.untracked.string("s"),
+    numEventsPerFile= cms.untracked.uint32(10),
+    frdVersion=cms.untracked.uint32(5))
+
+process.p = cms.Path(process.s)
+
+process.ep = cms.EndPath(process.out)
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Pass in name and status
+function die { echo $1: status $2 ;  exit $2; }
+
+# the same FRD files must give the same events with and without memory mapping
+pushd ${LOCAL_TMP_DIR}
+
+rm -rf frdmmap
+mkdir -p frdmmap/bu frdmmap/fu
+cmsRun ${LOCAL_TEST_DIR}/FRDWriterTest_cfg.py runNumber=100 buBaseDir=frdmmap/bu || die 'Failure using FRDWriterTest_cfg.py' $?
+
+files=`ls frdmmap/bu/run000100/run000100_ls*_index*.raw | sed 's/^/inputFiles=file:/'`
+[ -n "$files" ] || die 'FRDWriterTest_cfg.py wrote no raw files' 1
+
+cmsRun ${LOCAL_TEST_DIR}/FRDReaderTest_cfg.py runNumber=100 fuBaseDir=frdmmap/fu useMMap=False ${files} > frdmmap/read.log || die 'Failure using FRDReaderTest_cfg.py with useMMap=False' $?
+cmsRun ${LOCAL_TEST_DIR}/FRDReaderTest_cfg.py runNumber=100 fuBaseDir=frdmmap/fu useMMap=True ${files} > frdmmap/mmap.log || die 'Failure using FRDReaderTest_cfg.py with useMMap=True' $?
+cmsRun ${LOCAL_TEST_DIR}/FRDReaderTest_cfg.py runNumber=100 fuBaseDir=frdmmap/fu useMMap=True numThreads=4 ${files} > frdmmap/mmap4.log || die 'Failure using FRDReaderTest_cfg.py with useMMap=True and 4 threads' $?
+
+grep '^RawDataChecksum' frdmmap/read.log | sort > frdmmap/read.txt
+grep '^RawDataChecksum' frdmmap/mmap.log | sort > frdmmap/mmap.txt
+grep '^RawDataChecksum' frdmmap/mmap4.log | sort > frdmmap/mmap4.txt
+
+[ `wc -l < frdmmap/read.txt` -eq 40 ] || die 'FRDReaderTest_cfg.py did not read the 40 written events' 1
+diff frdmmap/read.txt frdmmap/mmap.txt || die 'Events read with useMMap=True differ from those read into chunk buffers' 1
+diff frdmmap/read.txt frdmmap/mmap4.txt || die 'Events read with useMMap=True and 4 threads differ from those read into chunk buffers' 1
+
+popd
@@ -0,0 +1,52 @@
+/** \file
+ *
+ * Prints one line per event with the size and the Adler32 checksum of
+ * every FED buffer, used to compare the content delivered by differently
+ * configured input sources.
+ *
+*/
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/FEDRawData/interface/FEDNumbering.h"
+
+#include <zlib.h>
+
+namespace test{
+
+  class RawDataChecksumAnalysis: public edm::one::EDAnalyzer<> {
+    private:
+    edm::EDGetTokenT<FEDRawDataCollection> m_fedRawDataCollectionToken;
+    public:
+    RawDataChecksumAnalysis(const edm::ParameterSet& pset):
+      m_fedRawDataCollectionToken( consumes<FEDRawDataCollection>( pset.getUntrackedParameter<edm::InputTag>( "inputTag", edm::InputTag( "rawDataCollector" ) ) ) ) {
+    }
+
+    void analyze(const edm::Event & e, const edm::EventSetup& c) {
+      edm::Handle<FEDRawDataCollection> rawdata;
+      e.getByToken(m_fedRawDataCollectionToken,rawdata);
+      unsigned int nFeds=0;
+      size_t totalSize=0;
+      uLong adler = adler32(0L,Z_NULL,0);
+      for (int fedId=0;fedId<=FEDNumbering::lastFEDId();fedId++) {
+        const FEDRawData& data = rawdata->FEDData(fedId);
+        if (data.size()==0) continue;
+        nFeds++;
+        totalSize+=data.size();
+        adler = adler32(adler,(const Bytef*)data.data(),data.size());
+      }
+      edm::LogAbsolute( "RawDataChecksum" ) << "RawDataChecksum Run: " << e.id().run()
+                                            << " LS: " << e.luminosityBlock()
+                                            << " Event: " << e.id().event()
+                                            << " FEDs: " << nFeds
+                                            << " bytes: " << totalSize
+                                            << " adler32: " << std::hex << adler << std::dec;
+    }
+  };
+DEFINE_FWK_MODULE(RawDataChecksumAnalysis);
+}
@@ -27,6 +27,8 @@
 // user include files
 #include "DataFormats/Provenance/interface/BranchType.h"
 #include "FWCore/Framework/interface/ProductResolverIndexAndSkipBit.h"
+#include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Framework/interface/ESItemToGet.h"
 #include "FWCore/Framework/interface/EventSetupRecordKey.h"
 #include "FWCore/ServiceRegistry/interface/ConsumesInfo.h"
 #include "FWCore/Utilities/interface/TypeID.h"
@@ -75,6 +77,9 @@ namespace edm {
 
     std::vector<ProductResolverIndexAndSkipBit> const& itemsToGetFrom(BranchType iType) const { return itemsToGetFromBranch_[iType]; }
 
+    ///EventSetup products declared via esConsumes
+    std::vector<ESItemToGet> const& esItemsToGet() const { return esItemsToGet_; }
+
     ///\return true if the product corresponding to the index was registered via consumes or mayConsume call
     bool registeredToConsume(ProductResolverIndex, bool, BranchType) const;
 
@@ -161,17 +166,19 @@ namespace edm {
     template <typename ESProduct, typename ESRecord, Transition Tr = Transition::Event>
     auto esConsumes(ESInputTag const& tag)
     {
-      return ESGetTokenT<ESProduct>{tag};
+      return esConsumes<ESProduct, Tr>(eventsetup::EventSetupRecordKey::makeKey<ESRecord>(), tag);
     }
 
     template <typename ESProduct, Transition Tr = Transition::Event>
-    auto esConsumes(eventsetup::EventSetupRecordKey const&, ESInputTag const& tag)
+    auto esConsumes(eventsetup::EventSetupRecordKey const& key, ESInputTag const& tag)
     {
+      recordESConsumes(Tr, key, eventsetup::DataKey::makeTypeTag<ESProduct>(), tag);
       return ESGetTokenT<ESProduct>{tag};
     }
 
   private:
     unsigned int recordConsumes(BranchType iBranch, TypeToGet const& iType, edm::InputTag const& iTag, bool iAlwaysGets);
+    void recordESConsumes(Transition, eventsetup::EventSetupRecordKey const&, eventsetup::TypeTag const&, ESInputTag const&);
 
     void throwTypeMismatch(edm::TypeID const&, EDGetToken) const;
     void throwBranchMismatch(BranchType, EDGetToken) const;
@@ -214,6 +221,8 @@ namespace edm {
 
     std::array<std::vector<ProductResolverIndexAndSkipBit>, edm::NumBranchTypes> itemsToGetFromBranch_;
 
+    std::vector<ESItemToGet> esItemsToGet_;
+
     bool frozen_;
     bool containsCurrentProcessAlias_;
   };
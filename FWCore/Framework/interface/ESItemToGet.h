@@ -0,0 +1,36 @@
+#ifndef FWCore_Framework_ESItemToGet_h
+#define FWCore_Framework_ESItemToGet_h
+// -*- C++ -*-
+//
+// Package:     FWCore/Framework
+// Class  :     edm::ESItemToGet
+//
+/**\class edm::ESItemToGet
+
+ Description: Identifies an EventSetup product a module declared, via esConsumes,
+    it will get during a given transition.
+
+ Usage:
+    EDConsumerBase records one for each esConsumes call. The Workers pass them
+    on to the EventProcessor which can then have the products made as soon as
+    a new IOV starts, before the modules ask for them.
+*/
+
+#include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Framework/interface/EventSetupRecordKey.h"
+#include "FWCore/Utilities/interface/Transition.h"
+
+namespace edm {
+
+  struct ESItemToGet {
+    ESItemToGet(Transition iTransition,
+                eventsetup::EventSetupRecordKey const& iRecord,
+                eventsetup::DataKey const& iKey) :
+      m_transition(iTransition), m_record(iRecord), m_key(iKey) {}
+
+    Transition m_transition;
+    eventsetup::EventSetupRecordKey m_record;
+    eventsetup::DataKey m_key;
+  };
+}
+#endif
@@ -12,6 +12,7 @@ configured in the user's main() function, and is set running.
 #include "DataFormats/Provenance/interface/RunID.h"
 #include "DataFormats/Provenance/interface/LuminosityBlockID.h"
 
+#include "FWCore/Framework/interface/ESItemToGet.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Framework/interface/InputSource.h"
 #include "FWCore/Framework/interface/MergeableRunProductProcesses.h"
@@ -268,6 +269,10 @@ namespace edm {
     void processEventAsyncImpl(WaitingTaskHolder iHolder,
                                unsigned int iStreamIndex);
 
+    //has the EventSetup products consumed by the modules made concurrently,
+    // the holder is released once they all have been
+    void prefetchEventSetupAsync(WaitingTaskHolder iHolder) const;
+
     //returns true if an asynchronous stop was requested
     bool checkForAsyncStopRequest(StatusCode&);
     
@@ -331,6 +336,8 @@ namespace edm {
     bool                                          forceLooperToEnd_;
     bool                                          looperBeginJobRun_;
     bool                                          forceESCacheClearOnNewRun_;
+    bool                                          prefetchEventSetup_;
+    std::vector<ESItemToGet>                      esItemsToPrefetch_;
     
     PreallocationConfiguration                    preallocations_;
     
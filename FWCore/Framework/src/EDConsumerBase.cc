@@ -136,6 +136,15 @@ EDConsumerBase::recordConsumes(BranchType iBranch, TypeToGet const& iType, edm::
   return index;
 }
 
+void
+EDConsumerBase::recordESConsumes(Transition iTrans,
+                                 eventsetup::EventSetupRecordKey const& iRecord,
+                                 eventsetup::TypeTag const& iDataType,
+                                 ESInputTag const& iTag) {
+  //ESInputTag::module() is only used to validate where the data came from, it is not part of the key
+  esItemsToGet_.emplace_back(iTrans, iRecord, eventsetup::DataKey(iDataType, iTag.data().c_str()));
+}
+
 void
 EDConsumerBase::updateLookup(BranchType iBranchType,
                              ProductResolverIndexHelper const& iHelper,
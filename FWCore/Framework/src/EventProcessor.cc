@@ -29,6 +29,7 @@
 #include "FWCore/Framework/interface/SubProcess.h"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/src/Breakpoints.h"
+#include "FWCore/Framework/src/Worker.h"
 #include "FWCore/Framework/src/EventSetupsController.h"
 #include "FWCore/Framework/src/InputSourceFactory.h"
 #include "FWCore/Framework/src/SharedResourcesRegistry.h"
@@ -247,6 +248,8 @@ namespace edm {
     forceLooperToEnd_(false),
     looperBeginJobRun_(false),
     forceESCacheClearOnNewRun_(false),
+    prefetchEventSetup_(false),
+    esItemsToPrefetch_(),
     eventSetupDataToExcludeFromPrefetching_() {
     auto processDesc = std::make_shared<ProcessDesc>(std::move(parameterSet));
     processDesc->addServices(defaultServices, forcedServices);
@@ -283,6 +286,8 @@ namespace edm {
     forceLooperToEnd_(false),
     looperBeginJobRun_(false),
     forceESCacheClearOnNewRun_(false),
+    prefetchEventSetup_(false),
+    esItemsToPrefetch_(),
     asyncStopRequestedWhileProcessingEvents_(false),
     eventSetupDataToExcludeFromPrefetching_()
   {
@@ -321,6 +326,8 @@ namespace edm {
     forceLooperToEnd_(false),
     looperBeginJobRun_(false),
     forceESCacheClearOnNewRun_(false),
+    prefetchEventSetup_(false),
+    esItemsToPrefetch_(),
     asyncStopRequestedWhileProcessingEvents_(false),
     eventSetupDataToExcludeFromPrefetching_()
   {
@@ -362,6 +369,7 @@ namespace edm {
       fileModeNoMerge_ = (fileMode == "NOMERGE");
     }
     forceESCacheClearOnNewRun_ = optionsPset.getUntrackedParameter<bool>("forceEventSetupCacheClearOnNewRun");
+    prefetchEventSetup_ = optionsPset.getUntrackedParameter<bool>("prefetchEventSetup");
 
     //threading
     unsigned int nThreads = optionsPset.getUntrackedParameter<unsigned int>("numberOfThreads");
@@ -565,6 +573,24 @@ namespace edm {
       throw;
     }
     schedule_->beginJob(*preg_);
+    if(prefetchEventSetup_) {
+      //collect once the EventSetup products the modules declared they consume
+      std::set<std::pair<eventsetup::EventSetupRecordKey, eventsetup::DataKey>> seen;
+      for(auto const* worker : schedule_->allWorkers()) {
+        for(auto const& item : worker->esItemsToGet()) {
+          if(seen.emplace(item.m_record, item.m_key).second) {
+            esItemsToPrefetch_.push_back(item);
+          }
+        }
+      }
+      LogInfo info("EventSetupPrefetch");
+      info << esItemsToPrefetch_.size()
+           << " EventSetup products declared via esConsumes will be made at each new IOV:";
+      for(auto const& item : esItemsToPrefetch_) {
+        info << "\n  record " << item.m_record.name() << " type " << item.m_key.type().name()
+             << " label '" << item.m_key.name().value() << "'";
+      }
+    }
     // toerror.succeeded(); // should we add this?
     for_all(subProcesses_, [](auto& subProcess){ subProcess.doBeginJob(); });
     actReg_->postBeginJobSignal_();
@@ -894,6 +920,38 @@ namespace edm {
       << "This likely indicates a bug in an input module or corrupted input or both\n";
   }
   
+  void EventProcessor::prefetchEventSetupAsync(WaitingTaskHolder iHolder) const {
+    //Only the products consumed by the modules of this process are prefetched, for all
+    // transitions; those consumed by SubProcesses are made when they are first asked for.
+    if(not prefetchEventSetup_) {
+      return;
+    }
+    EventSetup const& es = esp_->eventSetup();
+    for(auto const& item : esItemsToPrefetch_) {
+      tbb::task::spawn( *make_functor_task( tbb::task::allocate_root(), [this, &es, &item, holder = iHolder]() {
+        //make the services available
+        ServiceRegistry::Operate operate(serviceToken_);
+        //the module asking for the product will get the same failure with the proper context
+        auto warn = [&item](std::string const& iWhat) {
+          LogWarning("EventSetupPrefetch") << "Failed to prefetch " << item.m_key.type().name() << " '" << item.m_key.name().value()
+                                           << "' from record " << item.m_record.name() << iWhat;
+        };
+        try {
+          auto record = es.find(item.m_record);
+          if(record) {
+            record->doGet(item.m_key);
+          }
+        } catch(cms::Exception const& iException) {
+          warn(":\n" + iException.explainSelf());
+        } catch(std::exception const& iException) {
+          warn(std::string(": ") + iException.what());
+        } catch(...) {
+          warn(": unknown exception");
+        }
+      }));
+    }
+  }
+
   void EventProcessor::beginRun(ProcessHistoryID const& phid, RunNumber_t run, bool& globalBeginSucceeded,
                                 bool& eventSetupForInstanceSucceeded) {
     globalBeginSucceeded = false;
@@ -927,6 +985,8 @@ namespace edm {
       typedef OccurrenceTraits<RunPrincipal, BranchActionGlobalBegin> Traits;
       auto globalWaitTask = make_empty_waiting_task();
       globalWaitTask->increment_ref_count();
+      //the EventSetup products are made while the modules do their global begin run
+      prefetchEventSetupAsync(WaitingTaskHolder(globalWaitTask.get()));
       beginGlobalTransitionAsync<Traits>(WaitingTaskHolder(globalWaitTask.get()),
                                          *schedule_,
                                          runPrincipal,
@@ -1086,12 +1146,14 @@ namespace edm {
     
     auto status= std::make_shared<LuminosityBlockProcessingStatus>(this, preallocations_.numberOfStreams(), iRunResource) ;
 
-    auto lumiWork = [this, iHolder, status](edm::LimitedTaskQueue::Resumer iResumer) mutable {
+    bool const newIOV = not espController_->isWithinValidityInterval(iSync);
+
+    auto lumiWork = [this, iHolder, status, newIOV](edm::LimitedTaskQueue::Resumer iResumer) mutable {
       if(iHolder.taskHasFailed()) { return; }
 
       status->setResumer(std::move(iResumer));
       
-      sourceResourcesAcquirer_.serialQueueChain().push([this,iHolder,status]() mutable {
+      sourceResourcesAcquirer_.serialQueueChain().push([this,iHolder,status,newIOV]() mutable {
         //make the services available
         ServiceRegistry::Operate operate(serviceToken_);
 
@@ -1164,6 +1226,10 @@ namespace edm {
           //task to start the global begin lumi
           WaitingTaskHolder beginStreamsHolder{beginStreamsTask};
           EventSetup const& es = esp_->eventSetup();
+          if(newIOV) {
+            //the streams only start once the new EventSetup products are made
+            prefetchEventSetupAsync(beginStreamsHolder);
+          }
           {
             typedef OccurrenceTraits<LuminosityBlockPrincipal, BranchActionGlobalBegin> Traits;
             beginGlobalTransitionAsync<Traits>(beginStreamsHolder,
@@ -1182,7 +1248,7 @@ namespace edm {
         
     //Safe to do check now since can not have multiple beginLumis at same time in this part of the code
     // because we do not attempt to read from the source again until we try to get the first event in a lumi
-    if(espController_->isWithinValidityInterval(iSync)) {
+    if(not newIOV) {
       iovQueue_.pause();
       lumiQueue_->pushAndPause(std::move(lumiWork));
     } else {
@@ -24,6 +24,7 @@ the worker is reset().
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
 #include "FWCore/MessageLogger/interface/ExceptionMessages.h"
 #include "FWCore/Framework/src/WorkerParams.h"
+#include "FWCore/Framework/interface/ESItemToGet.h"
 #include "FWCore/Framework/interface/ExceptionActions.h"
 #include "FWCore/Framework/interface/ModuleContextSentry.h"
 #include "FWCore/Framework/interface/OccurrenceTraits.h"
@@ -207,6 +208,8 @@ namespace edm {
 
     virtual std::vector<ConsumesInfo> consumesInfo() const = 0;
 
+    virtual std::vector<ESItemToGet> const& esItemsToGet() const = 0;
+
     virtual Types moduleType() const =0;
 
     void clearCounters() {
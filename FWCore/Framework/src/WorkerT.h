@@ -139,6 +139,10 @@ namespace edm {
       return module_->consumesInfo();
     }
 
+    std::vector<ESItemToGet> const& esItemsToGet() const final {
+      return module_->esItemsToGet();
+    }
+
     void itemsToGet(BranchType branchType, std::vector<ProductResolverIndexAndSkipBit>& indexes) const override {
       module_->itemsToGet(branchType, indexes);
     }
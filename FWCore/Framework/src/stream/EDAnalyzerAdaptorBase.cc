@@ -101,6 +101,12 @@ EDAnalyzerAdaptorBase::itemsToGetFrom(BranchType iType) const {
   return m_streamModules[0]->itemsToGetFrom(iType);
 }
 
+std::vector<edm::ESItemToGet> const&
+EDAnalyzerAdaptorBase::esItemsToGet() const {
+  assert(not m_streamModules.empty());
+  return m_streamModules[0]->esItemsToGet();
+}
+
 void
 EDAnalyzerAdaptorBase::updateLookup(BranchType iType,
                                     ProductResolverIndexHelper const& iHelper,
@@ -106,6 +106,13 @@ namespace edm {
       return m_streamModules[0]->itemsToGetFrom(iType);
     }
 
+    template<typename T>
+    std::vector<edm::ESItemToGet> const&
+    ProducingModuleAdaptorBase<T>::esItemsToGet() const {
+      assert(not m_streamModules.empty());
+      return m_streamModules[0]->esItemsToGet();
+    }
+
     template< typename T>
     void
     ProducingModuleAdaptorBase<T>::modulesWhoseProductsAreConsumed(std::vector<ModuleDescription const*>& modules,
@@ -10,3 +10,7 @@ function die { echo $1: status $2 ;  exit $2; }
 (cmsRun ${LOCAL_TEST_DIR}/test_es_prefer_2_es_sources_order1_cfg.py ) || die 'Failure using test_es_prefer_2_es_sources_order1_cfg.py' $?
 (cmsRun ${LOCAL_TEST_DIR}/test_es_prefer_2_es_sources_order2_cfg.py ) || die 'Failure using test_es_prefer_2_es_sources_order2_cfg.py' $?
 (cmsRun ${LOCAL_TEST_DIR}/test_2_es_sources_no_prefer_cfg.py ) || die 'Failure using test_2_es_sources_no_prefer_cfg.py' $?
+(cmsRun ${LOCAL_TEST_DIR}/test_es_prefetch_cfg.py ) >& ${LOCAL_TMP_DIR}/test_es_prefetch_cfg.log || die 'Failure using test_es_prefetch_cfg.py' $?
+grep -q '\<1 EventSetup products declared via esConsumes will be made at each new IOV' ${LOCAL_TMP_DIR}/test_es_prefetch_cfg.log || die 'test_es_prefetch_cfg.py did not prefetch exactly one product' 1
+grep -q 'record DefaultRecord type .*DummyData label' ${LOCAL_TMP_DIR}/test_es_prefetch_cfg.log || die 'test_es_prefetch_cfg.py did not prefetch DummyData from DefaultRecord' 1
+if grep -q 'Failed to prefetch' ${LOCAL_TMP_DIR}/test_es_prefetch_cfg.log; then die 'test_es_prefetch_cfg.py failed to prefetch' 1; fi
@@ -0,0 +1,36 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+# the products to prefetch are listed at INFO level, checked by run_es_refer_tests.sh
+process.MessageLogger.cerr.INFO.limit = 100
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(4),
+    prefetchEventSetup = cms.untracked.bool(True)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(40)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInRun = cms.untracked.uint32(20),
+    numberEventsInLuminosityBlock = cms.untracked.uint32(5)
+)
+
+process.m = cms.EDAnalyzer("TestESDummyDataAnalyzer",
+    expected = cms.int32(5),
+    totalNEvents = cms.untracked.int32(40)
+)
+
+process.LoadableDummyProvider = cms.ESProducer("LoadableDummyProvider",
+    value = cms.untracked.int32(5)
+)
+
+process.LoadableDummyESSource = cms.ESSource("LoadableDummyESSource")
+
+process.p1 = cms.Path(process.m)
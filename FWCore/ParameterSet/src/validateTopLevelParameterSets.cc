@@ -25,6 +25,8 @@ void fillOptionsDescription(ParameterSetDescription& description) {
   description.addUntracked<std::string>("fileMode", "FULLMERGE")->
     setComment("Legal values are 'NOMERGE' and 'FULLMERGE'");
   description.addUntracked<bool>("forceEventSetupCacheClearOnNewRun", false);
+  description.addUntracked<bool>("prefetchEventSetup", false)->
+    setComment("Set true to have the EventSetup products declared via esConsumes made concurrently at the start of each new IOV, before events are processed");
   description.addUntracked<bool>("throwIfIllegalParameter", true)->
     setComment("Set false to disable exception throws when configuration validation detects illegal parameters");
   description.addUntracked<bool>("printDependencies", false)->
@@ -0,0 +1,146 @@
+#ifndef FWCore_SOA_ColumnMemoryResource_h
+#define FWCore_SOA_ColumnMemoryResource_h
+// -*- C++ -*-
+//
+// Package:     FWCore/SOA
+// Class  :     ColumnMemoryResource
+//
+/**\class ColumnMemoryResource ColumnMemoryResource.h "ColumnMemoryResource.h"
+
+ Description: Source of the memory used for the columns of an edm::soa::Table
+
+ Usage:
+    Every column of a Table starts on a kColumnAlignment byte boundary so that
+ loops over whole columns can use aligned vector loads and stores.
+
+    By default a Table gets its memory from the heap. A Table can instead be
+ given an ArenaColumnMemoryResource, in which case all its columns (and those
+ of any other Table sharing the arena) are carved out of large blocks which are
+ only returned when the arena is destroyed or released. This is intended for
+ the temporary tables built during a single call of a module.
+ \code
+ edm::soa::ArenaColumnMemoryResource arena;
+ JetTable selected{arena};
+ ...
+ \endcode
+ An arena is not thread safe and must outlive every Table using it. Tables
+ which are put into the Event must use the default memory resource; copying
+ a Table always uses the default memory resource.
+*/
+
+// system include files
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// user include files
+
+// forward declarations
+namespace edm {
+namespace soa {
+
+  //Cache line size, also enough for the widest vector registers
+  constexpr std::size_t kColumnAlignment = 64;
+
+  class ColumnMemoryResource {
+  public:
+    virtual ~ColumnMemoryResource() = default;
+
+    //The returned memory is aligned to kColumnAlignment
+    virtual void* allocate(std::size_t iBytes) = 0;
+    virtual void deallocate(void* iPtr, std::size_t iBytes) = 0;
+  };
+
+  class AlignedColumnMemoryResource : public ColumnMemoryResource {
+  public:
+    void* allocate(std::size_t iBytes) final {
+      return ::operator new(std::max<std::size_t>(iBytes,1), std::align_val_t(kColumnAlignment));
+    }
+    void deallocate(void* iPtr, std::size_t) final {
+      ::operator delete(iPtr, std::align_val_t(kColumnAlignment));
+    }
+  };
+
+  inline ColumnMemoryResource* defaultColumnMemoryResource() {
+    static AlignedColumnMemoryResource s_resource;
+    return &s_resource;
+  }
+
+  class ArenaColumnMemoryResource : public ColumnMemoryResource {
+  public:
+    explicit ArenaColumnMemoryResource(std::size_t iBlockSize = 64*1024):
+    m_blockSize(iBlockSize) {}
+
+    ~ArenaColumnMemoryResource() override { release(); }
+
+    ArenaColumnMemoryResource(ArenaColumnMemoryResource const&) = delete;
+    ArenaColumnMemoryResource& operator=(ArenaColumnMemoryResource const&) = delete;
+
+    void* allocate(std::size_t iBytes) final {
+      std::size_t bytes = roundUp(std::max<std::size_t>(iBytes,1));
+      if(m_blocks.empty() or m_used + bytes > m_blocks.back().second) {
+        std::size_t blockSize = std::max(bytes, m_blockSize);
+        m_blocks.emplace_back(static_cast<char*>(defaultColumnMemoryResource()->allocate(blockSize)), blockSize);
+        m_used = 0;
+      }
+      void* ptr = m_blocks.back().first + m_used;
+      m_used += bytes;
+      m_allocated += bytes;
+      return ptr;
+    }
+
+    //Memory is only given back by release()
+    void deallocate(void*, std::size_t) final {}
+
+    //Invalidates all memory handed out so far
+    void release() {
+      for(auto const& block: m_blocks) {
+        defaultColumnMemoryResource()->deallocate(block.first, block.second);
+      }
+      m_blocks.clear();
+      m_used = 0;
+      m_allocated = 0;
+    }
+
+    std::size_t bytesAllocated() const { return m_allocated; }
+    std::size_t numberOfBlocks() const { return m_blocks.size(); }
+
+  private:
+    static std::size_t roundUp(std::size_t iBytes) {
+      return (iBytes + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+    }
+
+    std::size_t const m_blockSize;
+    std::vector<std::pair<char*, std::size_t>> m_blocks;
+    std::size_t m_used = 0;
+    std::size_t m_allocated = 0;
+  };
+
+namespace impl {
+
+  template<typename T>
+  T* allocateColumn(ColumnMemoryResource* iResource, std::size_t iSize) {
+    static_assert(alignof(T) <= kColumnAlignment, "column type alignment exceeds kColumnAlignment");
+    T* ptr = static_cast<T*>(iResource->allocate(iSize*sizeof(T)));
+    try {
+      std::uninitialized_value_construct_n(ptr, iSize);
+    } catch(...) {
+      iResource->deallocate(ptr, iSize*sizeof(T));
+      throw;
+    }
+    return ptr;
+  }
+
+  template<typename T>
+  void deallocateColumn(ColumnMemoryResource* iResource, T* iPtr, std::size_t iSize) {
+    if(iPtr == nullptr) { return; }
+    std::destroy_n(iPtr, iSize);
+    iResource->deallocate(iPtr, iSize*sizeof(T));
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef FWCore_SOA_ColumnOperations_h
+#define FWCore_SOA_ColumnOperations_h
+// -*- C++ -*-
+//
+// Package:     FWCore/SOA
+//
+/**
+
+ Description: operations working on whole columns of an edm::soa::Table
+
+ Usage:
+    The functions work one column at a time over contiguous memory so that
+ the compiler can turn the inner loops into vector instructions. Predicates
+ are evaluated for all rows into a RowMask (one byte per row) without
+ branching, and the rows are then picked in a separate pass.
+ \code
+ using namespace edm::soa;
+ auto mask = evaluate<Pt,Eta>(jets, [](float pt, float eta) { return (pt > 20.f) & (std::abs(eta) < 2.4f); });
+ evaluateAnd<ID>(jets, [](int id) { return id > 0; }, mask);
+ JetTable selected = select(jets, mask);
+ JetTable ordered = sortByColumn<Pt>(selected, std::greater<>());
+ \endcode
+ The predicate is called with the values of the requested columns, in the order
+ the columns are given as template arguments. evaluate and evaluateAnd accept
+ a Table or a TableView. Combining conditions inside a predicate with '&'
+ instead of '&&' avoids the short-circuit branch which keeps the compiler from
+ vectorizing the loop.
+
+ A Table returned by select, gather or sortByColumn uses the default memory
+ resource unless a ColumnMemoryResource is passed as the last argument.
+*/
+
+// system include files
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// user include files
+#include "FWCore/SOA/interface/ColumnMemoryResource.h"
+#include "FWCore/SOA/interface/Table.h"
+
+// forward declarations
+
+namespace edm {
+namespace soa {
+
+  ///One entry per row, 1 if the row passed, 0 otherwise
+  using RowMask = std::vector<unsigned char>;
+  using RowIndices = std::vector<unsigned int>;
+
+namespace impl {
+  template<typename F, typename... T>
+  void evaluateColumns(size_t iSize, F& iPredicate, unsigned char* __restrict__ oMask, T const* __restrict__... iColumns) {
+    for(size_t i = 0; i < iSize; ++i) {
+      oMask[i] = iPredicate(iColumns[i]...) ? 1 : 0;
+    }
+  }
+
+  template<typename F, typename... T>
+  void evaluateColumnsAnd(size_t iSize, F& iPredicate, unsigned char* __restrict__ ioMask, T const* __restrict__... iColumns) {
+    for(size_t i = 0; i < iSize; ++i) {
+      ioMask[i] &= iPredicate(iColumns[i]...) ? 1 : 0;
+    }
+  }
+
+  template<typename COL, typename TABLE>
+  void gatherColumn(TABLE const& iFrom, unsigned int const* iRows, size_t iSize, TABLE& oTo) {
+    auto const* __restrict__ from = iFrom.template column<COL>().begin();
+    auto* __restrict__ to = oTo.template column<COL>().begin();
+    for(size_t i = 0; i < iSize; ++i) {
+      to[i] = from[iRows[i]];
+    }
+  }
+
+  template<typename COL, typename TABLE>
+  void scatterColumn(TABLE const& iFrom, unsigned int const* iRows, size_t iSize, TABLE& oTo) {
+    auto const* __restrict__ from = iFrom.template column<COL>().begin();
+    auto* __restrict__ to = oTo.template column<COL>().begin();
+    for(size_t i = 0; i < iSize; ++i) {
+      to[iRows[i]] = from[i];
+    }
+  }
+
+  template<typename TABLE, size_t... I>
+  void gatherColumns(TABLE const& iFrom, unsigned int const* iRows, size_t iSize, TABLE& oTo, std::index_sequence<I...>) {
+    (gatherColumn<typename std::tuple_element<I, typename TABLE::Layout>::type>(iFrom, iRows, iSize, oTo), ...);
+  }
+
+  template<typename TABLE, size_t... I>
+  void scatterColumns(TABLE const& iFrom, unsigned int const* iRows, size_t iSize, TABLE& oTo, std::index_sequence<I...>) {
+    (scatterColumn<typename std::tuple_element<I, typename TABLE::Layout>::type>(iFrom, iRows, iSize, oTo), ...);
+  }
+}
+
+  ///Evaluates iPredicate for every row using the values of the columns COLS
+  template<typename... COLS, typename TABLE, typename F>
+  RowMask evaluate(TABLE const& iTable, F iPredicate) {
+    static_assert(sizeof...(COLS) > 0, "evaluate needs at least one column");
+    RowMask mask(iTable.size());
+    impl::evaluateColumns(iTable.size(), iPredicate, mask.data(), iTable.template column<COLS>().begin()...);
+    return mask;
+  }
+
+  ///Clears the rows of ioMask for which iPredicate fails
+  template<typename... COLS, typename TABLE, typename F>
+  void evaluateAnd(TABLE const& iTable, F iPredicate, RowMask& ioMask) {
+    static_assert(sizeof...(COLS) > 0, "evaluateAnd needs at least one column");
+    assert(ioMask.size() == iTable.size());
+    impl::evaluateColumnsAnd(iTable.size(), iPredicate, ioMask.data(), iTable.template column<COLS>().begin()...);
+  }
+
+  inline size_t countSelected(RowMask const& iMask) {
+    size_t n = 0;
+    for(auto m: iMask) {
+      n += m;
+    }
+    return n;
+  }
+
+  ///Indices of the selected rows, in increasing order
+  inline RowIndices selectedRows(RowMask const& iMask) {
+    RowIndices rows(iMask.size());
+    size_t n = 0;
+    //branchless compaction
+    for(size_t i = 0; i < iMask.size(); ++i) {
+      rows[n] = i;
+      n += iMask[i];
+    }
+    rows.resize(n);
+    return rows;
+  }
+
+  ///New Table made of the rows iRows of iTable, in that order
+  template<typename... Args>
+  Table<Args...> gather(Table<Args...> const& iTable, RowIndices const& iRows,
+                        ColumnMemoryResource& iResource = *defaultColumnMemoryResource()) {
+    Table<Args...> result{iResource, static_cast<unsigned int>(iRows.size())};
+    impl::gatherColumns(iTable, iRows.data(), iRows.size(), result, std::make_index_sequence<sizeof...(Args)>{});
+    return result;
+  }
+
+  ///Copies row i of iFrom into row iRows[i] of oTo
+  template<typename... Args>
+  void scatter(Table<Args...> const& iFrom, RowIndices const& iRows, Table<Args...>& oTo) {
+    assert(iRows.size() == iFrom.size());
+    assert(std::all_of(iRows.begin(), iRows.end(), [&oTo](unsigned int r) { return r < oTo.size(); }));
+    impl::scatterColumns(iFrom, iRows.data(), iRows.size(), oTo, std::make_index_sequence<sizeof...(Args)>{});
+  }
+
+  ///New Table holding only the rows of iTable selected by iMask
+  template<typename... Args>
+  Table<Args...> select(Table<Args...> const& iTable, RowMask const& iMask,
+                        ColumnMemoryResource& iResource = *defaultColumnMemoryResource()) {
+    assert(iMask.size() == iTable.size());
+    return gather(iTable, selectedRows(iMask), iResource);
+  }
+
+  ///Row indices ordering the values of column COL according to iCompare. The sort is stable.
+  template<typename COL, typename TABLE, typename C = std::less<>>
+  RowIndices sortedRows(TABLE const& iTable, C iCompare = C()) {
+    RowIndices rows(iTable.size());
+    std::iota(rows.begin(), rows.end(), 0U);
+    auto const* values = iTable.template column<COL>().begin();
+    std::stable_sort(rows.begin(), rows.end(), [values, &iCompare](unsigned int iLHS, unsigned int iRHS) {
+      return iCompare(values[iLHS], values[iRHS]);
+    });
+    return rows;
+  }
+
+  ///New Table with the rows of iTable ordered by the values of column COL
+  template<typename COL, typename C = std::less<>, typename... Args>
+  Table<Args...> sortByColumn(Table<Args...> const& iTable, C iCompare = C(),
+                              ColumnMemoryResource& iResource = *defaultColumnMemoryResource()) {
+    return gather(iTable, sortedRows<COL>(iTable, iCompare), iResource);
+  }
+}
+}
+
+#endif
@@ -94,6 +94,15 @@
  \endcode
 
  
+ The memory of each column is aligned to edm::soa::kColumnAlignment bytes. The memory
+ can be taken from an edm::soa::ArenaColumnMemoryResource instead of the heap by passing
+ the arena when constructing the Table [See ColumnMemoryResource.h]
+ \code
+   edm::soa::ArenaColumnMemoryResource arena;
+   SphereTable selected{arena, nSelected};
+ \endcode
+ Vectorized operations over whole columns are provided in ColumnOperations.h.
+
  New Table declarations can be created based on existing Table declarations.
  E.g. say you want a new Table based on an existing Table but with an additional column.
  \code
@@ -114,11 +123,14 @@
 //
 
 // system include files
+#include <cassert>
 #include <memory>
 #include <tuple>
 #include <array>
+#include <type_traits>
 
 // user include files
+#include "FWCore/SOA/interface/ColumnMemoryResource.h"
 #include "FWCore/SOA/interface/TableItr.h"
 #include "FWCore/SOA/interface/tablehelpers.h"
 #include "FWCore/SOA/interface/ColumnFillers.h"
@@ -141,41 +153,49 @@ namespace soa {
     using const_iterator = ConstTableItr<Args...>;
     using iterator = TableItr<Args...>;
     
-    template <typename T, typename... CArgs>
+    template <typename T, typename... CArgs,
+              typename = std::enable_if_t<not std::is_base_of<ColumnMemoryResource, T>::value>>
     Table(T const& iContainer, CArgs... iArgs): m_size(iContainer.size()) {
       if constexpr(sizeof...(CArgs)==0) {
-        CtrFillerFromAOS::fill(m_values,iContainer);
+        CtrFillerFromAOS::fill(m_values,iContainer,m_resource);
       } else {
-        CtrFillerFromContainers::fill(m_values,iContainer,std::forward<CArgs>(iArgs)...);
+        CtrFillerFromContainers::fill(m_values,m_resource,iContainer,std::forward<CArgs>(iArgs)...);
       }
     }
     
     template<typename T, typename... CArgs>
     Table(T const& iContainer, ColumnFillers<CArgs...> iFiller) {
       m_size = iContainer.size();
-      CtrFillerFromAOS::fillUsingFiller(iFiller,m_values, iContainer);
+      CtrFillerFromAOS::fillUsingFiller(iFiller,m_values, iContainer,m_resource);
+    }
+    
+    ///Default initialized rows whose columns are taken from iResource
+    explicit Table(ColumnMemoryResource& iResource, unsigned int iSize = 0): m_size(0), m_resource(&iResource) {
+      resize(iSize);
     }
     
     Table( Table<Args...> const& iOther):m_size(iOther.m_size), m_values{{nullptr}} {
-      copyFromToWithResizeAll(m_size,iOther.m_values,m_values, std::make_index_sequence<sizeof...(Args)>{});
+      copyFromToWithResizeAll(m_size,iOther.m_values,m_values,m_resource, std::make_index_sequence<sizeof...(Args)>{});
     }
     
     Table( Table<Args...>&& iOther):m_size(0), m_values{{nullptr}} {
       std::swap(m_size,iOther.m_size);
       std::swap(m_values,iOther.m_values);
+      std::swap(m_resource,iOther.m_resource);
     }
     
     Table() : m_size(0) {
     }
     
     ~Table() {
-      dtr<0>(m_values);
+      dtr<0>(m_values,m_size,m_resource);
     }
     
     Table<Args...>& operator=(Table<Args...>&& iOther) {
       Table<Args...> cp(std::move(iOther));
       std::swap(m_size,cp.m_size);
       std::swap(m_values, cp.m_values);
+      std::swap(m_resource, cp.m_resource);
       return *this;
     }
     Table<Args...>& operator=(Table<Args...> const& iOther) {
@@ -188,11 +208,8 @@ namespace soa {
     
     void resize(unsigned int iNewSize) {
       if(m_size == iNewSize) { return;}
-      resizeFromTo<0>(m_size,iNewSize,m_values);
-      if(m_size < iNewSize) {
-        //initialize the extra values
-        resetStartingAt<0>(m_size, iNewSize,m_values);
-      }
+      //the extra values are value initialized
+      resizeFromTo<0>(m_size,iNewSize,m_values,m_resource);
       m_size = iNewSize;
     }
     
@@ -207,7 +224,7 @@ namespace soa {
     
     template<typename U>
     ColumnValues<typename U::type> column() const {
-      return ColumnValues<typename U::type>{static_cast<typename U::type*>(columnAddress<U>()), m_size};
+      return ColumnValues<typename U::type>{static_cast<typename U::type const*>(columnAddress<U>()), m_size};
     }
     template<typename U>
     MutableColumnValues<typename U::type> column() {
@@ -243,11 +260,16 @@ namespace soa {
       return m_values[iIndex];
     }
     
+    ColumnMemoryResource* memoryResource() const {
+      return m_resource;
+    }
+    
   private:
     
     // Member data
     unsigned int m_size = 0;
     std::array<void *, sizeof...(Args)> m_values = {{nullptr}}; //! keep ROOT from trying to store this
+    ColumnMemoryResource* m_resource = defaultColumnMemoryResource(); //!
     
     template<typename U>
     void const* columnAddress() const {
@@ -261,28 +283,28 @@ namespace soa {
 
     //Recursive destructor handling
     template <int I>
-    static void dtr(std::array<void*, sizeof...(Args)>& iArray) {
+    static void dtr(std::array<void*, sizeof...(Args)>& iArray, size_t iSize, ColumnMemoryResource* iResource) {
       if constexpr(I<sizeof...(Args)) {
         using Type = typename std::tuple_element<I,Layout>::type::type;
-        delete [] static_cast<Type*>(iArray[I]);
-        dtr<I+1>(iArray);
+        impl::deallocateColumn(iResource, static_cast<Type*>(iArray[I]), iSize);
+        dtr<I+1>(iArray, iSize, iResource);
       }
     }
 
     //Construct the Table using a container per column
     struct CtrFillerFromContainers {
       template<typename T, typename... U>
-      static size_t fill(std::array<void *, sizeof...(Args)>& oValues, T const& iContainer, U... iArgs) {
+      static size_t fill(std::array<void *, sizeof...(Args)>& oValues, ColumnMemoryResource* iResource, T const& iContainer, U... iArgs) {
         static_assert( sizeof...(Args) == sizeof...(U)+1, "Wrong number of arguments passed to Table constructor");
-        ctrFiller<0>(oValues,iContainer.size(), iContainer,std::forward<U>(iArgs)...);
+        ctrFiller<0>(oValues,iResource,iContainer.size(), iContainer,std::forward<U>(iArgs)...);
         return iContainer.size();
       }
     private:
       template<int I, typename T, typename... U>
-      static void ctrFiller(std::array<void *, sizeof...(Args)>& oValues, size_t iSize, T const& iContainer, U... iU) {
+      static void ctrFiller(std::array<void *, sizeof...(Args)>& oValues, ColumnMemoryResource* iResource, size_t iSize, T const& iContainer, U... iU) {
         assert(iContainer.size() == iSize);
         using Type = typename std::tuple_element<I,Layout>::type::type;
-        Type  * temp = new Type [iSize];
+        Type  * temp = impl::allocateColumn<Type>(iResource, iSize);
         unsigned int index = 0;
         for( auto const& v: iContainer) {
           temp[index] = v;
@@ -290,19 +312,19 @@ namespace soa {
         }
         oValues[I] = temp;
         
-        ctrFiller<I+1>(oValues, iSize, std::forward<U>(iU)... );
+        ctrFiller<I+1>(oValues, iResource, iSize, std::forward<U>(iU)... );
       }
       
       template<int I>
-      static void ctrFiller(std::array<void *, sizeof...(Args)>& , size_t  ) {}
+      static void ctrFiller(std::array<void *, sizeof...(Args)>& , ColumnMemoryResource*, size_t  ) {}
       
     };
     
     //Construct the Table using one container with each entry representing a row
     struct CtrFillerFromAOS {
       template<typename T>
-      static size_t fill(std::array<void *, sizeof...(Args)>& oValues, T const& iContainer) {
-        presize<0>(oValues,iContainer.size());
+      static size_t fill(std::array<void *, sizeof...(Args)>& oValues, T const& iContainer, ColumnMemoryResource* iResource) {
+        presize<0>(oValues,iContainer.size(),iResource);
         unsigned index=0;
         for(auto&& item: iContainer) {
           fillElement<0>(item,index,oValues);
@@ -312,8 +334,8 @@ namespace soa {
       }
       
       template<typename T, typename F>
-      static size_t fillUsingFiller(F& iFiller, std::array<void *, sizeof...(Args)>& oValues, T const& iContainer) {
-        presize<0>(oValues,iContainer.size());
+      static size_t fillUsingFiller(F& iFiller, std::array<void *, sizeof...(Args)>& oValues, T const& iContainer, ColumnMemoryResource* iResource) {
+        presize<0>(oValues,iContainer.size(),iResource);
         unsigned index=0;
         for(auto&& item: iContainer) {
           fillElementUsingFiller<0>(iFiller, item,index,oValues);
@@ -325,12 +347,12 @@ namespace soa {
 
     private:
       template<int I>
-      static void presize(std::array<void *, sizeof...(Args)>& oValues, size_t iSize) {
+      static void presize(std::array<void *, sizeof...(Args)>& oValues, size_t iSize, ColumnMemoryResource* iResource) {
         if constexpr(I<sizeof...(Args)) {
           using Layout = std::tuple<Args...>;
           using Type = typename std::tuple_element<I,Layout>::type::type;
-          oValues[I] = new Type[iSize];
-          presize<I+1>(oValues,iSize);
+          oValues[I] = impl::allocateColumn<Type>(iResource, iSize);
+          presize<I+1>(oValues,iSize,iResource);
         }
       }
       
@@ -361,48 +383,39 @@ namespace soa {
 
     template<size_t... I>
     static void copyFromToWithResizeAll(size_t iNElements, std::array<void *, sizeof...(Args)> const& iFrom, std::array<void*, sizeof...(Args)>& oTo,
-                                        std::index_sequence<I...>) {
-      (copyFromToWithResize<I>(iNElements, iFrom, oTo), ...);
+                                        ColumnMemoryResource* iResource, std::index_sequence<I...>) {
+      (copyFromToWithResize<I>(iNElements, iFrom, oTo, iResource), ...);
     }
     
+    //oTo must not hold any memory
     template<int I>
-    static void copyFromToWithResize(size_t iNElements, std::array<void *, sizeof...(Args)> const& iFrom, std::array<void*, sizeof...(Args)>& oTo) {
+    static void copyFromToWithResize(size_t iNElements, std::array<void *, sizeof...(Args)> const& iFrom, std::array<void*, sizeof...(Args)>& oTo,
+                                     ColumnMemoryResource* iResource) {
       using Layout = std::tuple<Args...>;
       using Type = typename std::tuple_element<I,Layout>::type::type;
-      Type* oldPtr = static_cast<Type*>(oTo[I]);
-      Type* ptr = new Type[iNElements];
+      assert(oTo[I] == nullptr);
+      Type* ptr = impl::allocateColumn<Type>(iResource, iNElements);
       oTo[I]=ptr;
       std::copy(static_cast<Type const*>(iFrom[I]), static_cast<Type const*>(iFrom[I])+iNElements, ptr);
-      delete [] oldPtr;
     }
     
     template<int I>
-    static void resizeFromTo(size_t iOldSize, size_t iNewSize, std::array<void *, sizeof...(Args)>& ioArray) {
+    static void resizeFromTo(size_t iOldSize, size_t iNewSize, std::array<void *, sizeof...(Args)>& ioArray, ColumnMemoryResource* iResource) {
       if constexpr(I < sizeof...(Args)) {
         using Layout = std::tuple<Args...>;
         using Type = typename std::tuple_element<I,Layout>::type::type;
         Type* oldPtr = static_cast<Type*>(ioArray[I]);
-        auto ptr = new Type[iNewSize];
+        auto ptr = impl::allocateColumn<Type>(iResource, iNewSize);
         auto nToCopy = std::min(iOldSize,iNewSize);
-        std::copy(static_cast<Type const*>(ioArray[I]), static_cast<Type const*>(ioArray[I])+nToCopy, ptr);
-        resizeFromTo<I+1>(iOldSize, iNewSize, ioArray );
+        if(nToCopy != 0) {
+          std::copy(oldPtr, oldPtr+nToCopy, ptr);
+        }
+        resizeFromTo<I+1>(iOldSize, iNewSize, ioArray, iResource);
         
-        delete [] oldPtr;
+        impl::deallocateColumn(iResource, oldPtr, iOldSize);
         ioArray[I]=ptr;
       }
     }
-    
-    template<int I>
-    static void resetStartingAt(size_t iStartIndex, size_t iEndIndex,std::array<void *, sizeof...(Args)>& ioArray) {
-      if constexpr(I < sizeof...(Args)) {
-        using Layout = std::tuple<Args...>;
-        using Type = typename std::tuple_element<I,Layout>::type::type;
-        auto ptr = static_cast<Type*>(ioArray[I]);
-        auto temp = Type{};
-        std::fill(ptr+iStartIndex, ptr+iEndIndex, temp);
-        resetStartingAt<I+1>(iStartIndex, iEndIndex, ioArray);
-      }
-    }
 
   };
   
@@ -0,0 +1,176 @@
+/*----------------------------------------------------------------------
+
+Test program for the column operations and memory resources of edm::soa::Table
+
+ ----------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include "FWCore/SOA/interface/Column.h"
+#include "FWCore/SOA/interface/ColumnMemoryResource.h"
+#include "FWCore/SOA/interface/ColumnOperations.h"
+#include "FWCore/SOA/interface/Table.h"
+#include "FWCore/SOA/interface/TableView.h"
+
+class testColumnOperations: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testColumnOperations);
+
+  CPPUNIT_TEST(alignmentTest);
+  CPPUNIT_TEST(arenaTest);
+  CPPUNIT_TEST(evaluateTest);
+  CPPUNIT_TEST(selectTest);
+  CPPUNIT_TEST(gatherScatterTest);
+  CPPUNIT_TEST(sortTest);
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void setUp(){}
+  void tearDown(){}
+
+  void alignmentTest();
+  void arenaTest();
+  void evaluateTest();
+  void selectTest();
+  void gatherScatterTest();
+  void sortTest();
+};
+
+namespace tco {
+  SOA_DECLARE_COLUMN(Pt, float, "pt");
+  SOA_DECLARE_COLUMN(Eta, float, "eta");
+  SOA_DECLARE_COLUMN(Label, std::string, "label");
+
+  using JetTable = edm::soa::Table<Pt, Eta, Label>;
+
+  JetTable makeJets() {
+    std::vector<float> pt = {10.f, 30.f, 50.f, 25.f, 40.f};
+    std::vector<float> eta = {0.1f, 3.0f, -1.0f, 2.0f, -2.2f};
+    std::vector<std::string> label = {"a", "b", "c", "d", "e"};
+    return JetTable{pt, eta, label};
+  }
+
+  bool isAligned(void const* iPtr) {
+    return reinterpret_cast<std::uintptr_t>(iPtr) % edm::soa::kColumnAlignment == 0;
+  }
+}
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testColumnOperations);
+
+void testColumnOperations::alignmentTest()
+{
+  using namespace tco;
+  auto jets = makeJets();
+  CPPUNIT_ASSERT(isAligned(jets.column<Pt>().begin()));
+  CPPUNIT_ASSERT(isAligned(jets.column<Eta>().begin()));
+  CPPUNIT_ASSERT(isAligned(jets.column<Label>().begin()));
+
+  jets.resize(17);
+  CPPUNIT_ASSERT(isAligned(jets.column<Pt>().begin()));
+  CPPUNIT_ASSERT(jets.get<Label>(4) == "e");
+  CPPUNIT_ASSERT(jets.get<Label>(16).empty());
+}
+
+void testColumnOperations::arenaTest()
+{
+  using namespace tco;
+  edm::soa::ArenaColumnMemoryResource arena(1024);
+  {
+    JetTable jets{arena, 3};
+    CPPUNIT_ASSERT(jets.size() == 3);
+    CPPUNIT_ASSERT(jets.memoryResource() == &arena);
+    CPPUNIT_ASSERT(jets.get<Pt>(2) == 0.f);
+    CPPUNIT_ASSERT(isAligned(jets.column<Eta>().begin()));
+    jets.get<Label>(1) = "x";
+
+    //a copy does not use the arena
+    JetTable copy{jets};
+    CPPUNIT_ASSERT(copy.memoryResource() == edm::soa::defaultColumnMemoryResource());
+    CPPUNIT_ASSERT(copy.get<Label>(1) == "x");
+
+    //each column is larger than a block
+    JetTable big{arena, 1000};
+    CPPUNIT_ASSERT(arena.numberOfBlocks() == 4);
+  }
+  CPPUNIT_ASSERT(arena.bytesAllocated() > 0);
+  arena.release();
+  CPPUNIT_ASSERT(arena.bytesAllocated() == 0);
+  CPPUNIT_ASSERT(arena.numberOfBlocks() == 0);
+}
+
+void testColumnOperations::evaluateTest()
+{
+  using namespace tco;
+  using namespace edm::soa;
+  auto jets = makeJets();
+
+  auto mask = evaluate<Pt, Eta>(jets, [](float pt, float eta) { return (pt > 20.f) & (std::abs(eta) < 2.4f); });
+  CPPUNIT_ASSERT((mask == RowMask{0, 0, 1, 1, 1}));
+  CPPUNIT_ASSERT(countSelected(mask) == 3);
+
+  TableView<Pt> view{jets};
+  evaluateAnd<Pt>(view, [](float pt) { return pt < 45.f; }, mask);
+  CPPUNIT_ASSERT((mask == RowMask{0, 0, 0, 1, 1}));
+  CPPUNIT_ASSERT((selectedRows(mask) == RowIndices{3, 4}));
+}
+
+void testColumnOperations::selectTest()
+{
+  using namespace tco;
+  using namespace edm::soa;
+  auto jets = makeJets();
+
+  auto selected = select(jets, evaluate<Eta>(jets, [](float eta) { return eta < 0.f; }));
+  CPPUNIT_ASSERT(selected.size() == 2);
+  CPPUNIT_ASSERT(selected.get<Label>(0) == "c");
+  CPPUNIT_ASSERT(selected.get<Label>(1) == "e");
+  CPPUNIT_ASSERT(selected.get<Pt>(1) == 40.f);
+
+  auto none = select(jets, RowMask(jets.size(), 0));
+  CPPUNIT_ASSERT(none.size() == 0);
+}
+
+void testColumnOperations::gatherScatterTest()
+{
+  using namespace tco;
+  using namespace edm::soa;
+  auto jets = makeJets();
+  ArenaColumnMemoryResource arena;
+
+  auto gathered = gather(jets, RowIndices{4, 0, 4}, arena);
+  CPPUNIT_ASSERT(gathered.memoryResource() == &arena);
+  CPPUNIT_ASSERT(gathered.size() == 3);
+  CPPUNIT_ASSERT(gathered.get<Label>(0) == "e");
+  CPPUNIT_ASSERT(gathered.get<Label>(1) == "a");
+  CPPUNIT_ASSERT(gathered.get<Eta>(2) == -2.2f);
+
+  JetTable target{arena, 5};
+  scatter(gathered, RowIndices{1, 3, 0}, target);
+  CPPUNIT_ASSERT(target.get<Label>(1) == "e");
+  CPPUNIT_ASSERT(target.get<Label>(3) == "a");
+  CPPUNIT_ASSERT(target.get<Label>(0) == "e");
+  CPPUNIT_ASSERT(target.get<Label>(2).empty());
+}
+
+void testColumnOperations::sortTest()
+{
+  using namespace tco;
+  using namespace edm::soa;
+  auto jets = makeJets();
+
+  CPPUNIT_ASSERT((sortedRows<Pt>(jets) == RowIndices{0, 3, 1, 4, 2}));
+
+  auto ordered = sortByColumn<Pt>(jets, std::greater<>());
+  CPPUNIT_ASSERT(ordered.size() == jets.size());
+  CPPUNIT_ASSERT(ordered.get<Label>(0) == "c");
+  CPPUNIT_ASSERT(ordered.get<Label>(4) == "a");
+  for(unsigned int i = 1; i < ordered.size(); ++i) {
+    CPPUNIT_ASSERT(ordered.get<Pt>(i-1) >= ordered.get<Pt>(i));
+  }
+}
+
+#include <Utilities/Testing/interface/CppUnit_testdriver.icpp>
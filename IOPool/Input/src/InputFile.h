@@ -46,6 +46,8 @@ namespace edm {
     TObject* Get(char const* name) {return file_->Get(name);}
     TFileCacheRead* GetCacheRead() const {return file_->GetCacheRead();}
     void SetCacheRead(TFileCacheRead* tfcr) {file_->SetCacheRead(tfcr, nullptr, TFile::kDoNotDisconnect);}
+    // Returns true if the storage cannot prefetch the given range.
+    bool ReadBufferAsync(Long64_t offset, Int_t len) {return file_->ReadBufferAsync(offset, len);}
     void logFileAction(char const* msg, char const* fileName) const;
   private:
     edm::propagate_const<std::unique_ptr<TFile>> file_;
@@ -1465,6 +1465,7 @@ namespace edm {
 
     // We're not done ... so prepare the EventPrincipal
     eventTree_.insertEntryForIndex(principal.transitionIndex());
+    eventTree_.prefetchAfterCurrentEntry();
     principal.fillEventPrincipal(eventAux(),
                                  *processHistoryRegistry_,
                                  std::move(eventSelectionIDs_),
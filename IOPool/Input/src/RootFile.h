@@ -157,6 +157,7 @@ namespace edm {
     void close();
     bool readCurrentEvent(EventPrincipal& cache);
     void readEvent(EventPrincipal& cache);
+    void enableEventPrefetching(unsigned int nEventsAhead) {eventTree_.enableEntryPrefetching(nEventsAhead, file_);}
 
     std::shared_ptr<LuminosityBlockAuxiliary> readLuminosityBlockAuxiliary_();
     std::shared_ptr<RunAuxiliary> readRunAuxiliary_();
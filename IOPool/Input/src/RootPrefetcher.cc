@@ -0,0 +1,133 @@
+#include "RootPrefetcher.h"
+#include "InputFile.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "TBranch.h"
+#include "TMath.h"
+#include "TObjArray.h"
+
+#include <algorithm>
+
+namespace edm {
+
+  RootPrefetcher::RootPrefetcher(std::shared_ptr<InputFile> filePtr,
+                                 std::string const& fileName,
+                                 unsigned int nEntriesAhead,
+                                 EntryNumber entries) :
+    filePtr_(filePtr),
+    fileName_(fileName),
+    nEntriesAhead_(nEntriesAhead),
+    entries_(entries),
+    coveredUpTo_(),
+    windowBegin_(0),
+    lastCurrent_(-1),
+    disabled_(false),
+    hits_(0U),
+    misses_(0U),
+    requests_(0U),
+    bytes_(0U) {
+  }
+
+  RootPrefetcher::~RootPrefetcher() {
+  }
+
+  void
+  RootPrefetcher::branchRead(TBranch* branch, EntryNumber entry) {
+    auto it = coveredUpTo_.find(branch);
+    if(it == coveredUpTo_.end()) {
+      // First read of this branch; it will be prefetched from now on.
+      coveredUpTo_.emplace(branch, -1);
+      ++misses_;
+    } else if(entry >= windowBegin_ && entry <= it->second) {
+      ++hits_;
+    } else {
+      ++misses_;
+    }
+  }
+
+  void
+  RootPrefetcher::reset(EntryNumber current) {
+    for(auto& covered : coveredUpTo_) {
+      covered.second = -1;
+    }
+    windowBegin_ = current + 1;
+  }
+
+  void
+  RootPrefetcher::prefetchAfter(EntryNumber current) {
+    if(current < 0 || coveredUpTo_.empty() || disabled_ || !filePtr_) {
+      return;
+    }
+    // Anything but moving forward within the window invalidates what was requested before.
+    if(current < lastCurrent_ || current > lastCurrent_ + static_cast<EntryNumber>(nEntriesAhead_)) {
+      reset(current);
+    }
+    lastCurrent_ = current;
+
+    EntryNumber const last = std::min(current + static_cast<EntryNumber>(nEntriesAhead_), entries_ - 1);
+    Requests requests;
+    for(auto& covered : coveredUpTo_) {
+      EntryNumber const first = std::max(current + 1, covered.second + 1);
+      if(first <= last) {
+        collectBaskets(covered.first, first, last, requests);
+        covered.second = last;
+      }
+    }
+    if(requests.empty()) {
+      return;
+    }
+    // Coalesce duplicates coming from baskets which span window boundaries.
+    std::sort(requests.begin(), requests.end());
+    requests.erase(std::unique(requests.begin(), requests.end()), requests.end());
+
+    // Called while the source reads the event, so the file is not used by anybody else.
+    // ReadBufferAsync only queues the request in the storage layer and does not wait for the data.
+    try {
+      for(auto const& request : requests) {
+        // ReadBufferAsync returns kTRUE if the storage cannot prefetch.
+        if(filePtr_->ReadBufferAsync(request.first, request.second)) {
+          disabled_ = true;
+          break;
+        }
+        ++requests_;
+        bytes_ += request.second;
+      }
+    } catch(...) {
+      // Prefetching is only a hint.  Any error will show up again on the actual read.
+      disabled_ = true;
+    }
+  }
+
+  void
+  RootPrefetcher::collectBaskets(TBranch* branch, EntryNumber first, EntryNumber last, Requests& requests) {
+    Int_t const nBaskets = branch->GetWriteBasket();
+    if(nBaskets > 0) {
+      Long64_t const* basketEntry = branch->GetBasketEntry();
+      Int_t const* basketBytes = branch->GetBasketBytes();
+      // basketEntry holds the first entry of each basket, including the one being written.
+      Long64_t basket = TMath::BinarySearch(static_cast<Long64_t>(nBaskets + 1), basketEntry, first);
+      for(; basket < nBaskets && basketEntry[basket] <= last; ++basket) {
+        Long64_t const seek = branch->GetBasketSeek(basket);
+        if(seek != 0 && basketBytes[basket] > 0) {
+          requests.emplace_back(seek, basketBytes[basket]);
+        }
+      }
+    }
+    TObjArray* subBranches = branch->GetListOfBranches();
+    for(Int_t i = 0, n = subBranches->GetEntriesFast(); i < n; ++i) {
+      collectBaskets(static_cast<TBranch*>(subBranches->UncheckedAt(i)), first, last, requests);
+    }
+  }
+
+  void
+  RootPrefetcher::close() {
+    filePtr_.reset();
+    LogInfo("PoolSource")
+      << "Event prefetching for file " << fileName_ << ": "
+      << coveredUpTo_.size() << " branches prefetched up to " << nEntriesAhead_ << " entries ahead, "
+      << hits_ << " reads of prefetched entries (hits), " << misses_ << " other reads (misses), "
+      << requests_ << " requests for " << bytes_ << " bytes"
+      << (disabled_ ? ", disabled because the storage does not support prefetching." : ".");
+  }
+}
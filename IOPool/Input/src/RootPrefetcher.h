@@ -0,0 +1,83 @@
+#ifndef IOPool_Input_RootPrefetcher_h
+#define IOPool_Input_RootPrefetcher_h
+
+/*----------------------------------------------------------------------
+
+RootPrefetcher: asynchronously requests from the storage layer the baskets
+of the entries following the current one in an event tree.
+
+Only the branches that were actually read from the tree (i.e. the products
+consumed by the modules of the job) are prefetched.  The requests are issued
+when an event is read, i.e. on the thread and under the serialization of all
+the other reads of the source from the same file, which is required since the
+TFile and the storage underneath are not thread safe.  The storage layer is
+only given a hint (TFile::ReadBufferAsync), which returns at once, so that the
+latency of remote storage overlaps with the processing of the current entries.
+The data are still read through the regular ROOT path, and through the
+TTreeCache if there is one.
+
+Hit and miss counts of branch reads with respect to the prefetched entries
+are kept per file and reported when the file is closed.
+----------------------------------------------------------------------*/
+
+#include "DataFormats/Provenance/interface/IndexIntoFile.h"
+
+#include "Rtypes.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class TBranch;
+
+namespace edm {
+  class InputFile;
+
+  class RootPrefetcher {
+  public:
+    typedef IndexIntoFile::EntryNumber_t EntryNumber;
+
+    RootPrefetcher(std::shared_ptr<InputFile> filePtr,
+                   std::string const& fileName,
+                   unsigned int nEntriesAhead,
+                   EntryNumber entries);
+    ~RootPrefetcher();
+
+    RootPrefetcher(RootPrefetcher const&) = delete; // Disallow copying and moving
+    RootPrefetcher& operator=(RootPrefetcher const&) = delete; // Disallow copying and moving
+
+    // Called for every read of a product branch.  Learns the set of consumed branches
+    // and counts whether the entry had been prefetched.
+    void branchRead(TBranch* branch, EntryNumber entry);
+
+    // Requests the entries (current, current + nEntriesAhead] of the consumed branches.
+    // Must be called with the same serialization as the other reads from the file.
+    void prefetchAfter(EntryNumber current);
+
+    // Reports the statistics.  Must be called before the file is closed.
+    void close();
+
+  private:
+    typedef std::vector<std::pair<Long64_t, Int_t> > Requests;
+
+    static void collectBaskets(TBranch* branch, EntryNumber first, EntryNumber last, Requests& requests);
+    void reset(EntryNumber current);
+
+    std::shared_ptr<InputFile> filePtr_;
+    std::string const fileName_;
+    unsigned int const nEntriesAhead_;
+    EntryNumber const entries_;
+    // Consumed branches and the last entry requested for each of them.
+    std::unordered_map<TBranch*, EntryNumber> coveredUpTo_;
+    EntryNumber windowBegin_;
+    EntryNumber lastCurrent_;
+    bool disabled_;
+    unsigned long long hits_;
+    unsigned long long misses_;
+    unsigned long long requests_;
+    unsigned long long bytes_;
+  };
+}
+#endif
@@ -33,7 +33,8 @@ namespace edm {
     treeCacheSize_(noEventSort_ ? pset.getUntrackedParameter<unsigned int>("cacheSize") : 0U),
     duplicateChecker_(new DuplicateChecker(pset)),
     usingGoToEvent_(false),
-    enablePrefetching_(false) {
+    enablePrefetching_(false),
+    prefetchEvents_(pset.getUntrackedParameter<unsigned int>("prefetchEvents")) {
 
     // The SiteLocalConfig controls the TTreeCache size and the prefetching settings.
     Service<SiteLocalConfig> pSLC;
@@ -114,7 +115,7 @@ namespace edm {
   RootPrimaryFileSequence::RootFileSharedPtr
   RootPrimaryFileSequence::makeRootFile(std::shared_ptr<InputFile> filePtr) {
       size_t currentIndexIntoFile = sequenceNumberOfFile();
-      return std::make_shared<RootFile>(
+      auto rootFile = std::make_shared<RootFile>(
           fileName(),
           input_.processConfiguration(),
           logicalFileName(),
@@ -144,6 +145,8 @@ namespace edm {
           input_.labelRawDataLikeMC(),
           usingGoToEvent_,
           enablePrefetching_);
+      rootFile->enableEventPrefetching(prefetchEvents_);
+      return rootFile;
   }
 
   bool RootPrimaryFileSequence::nextFile() {
@@ -330,6 +333,10 @@ namespace edm {
                      "Note 3: Any sorting occurs independently in each input file (no sorting across input files).");
     desc.addUntracked<unsigned int>("cacheSize", roottree::defaultCacheSize)
         ->setComment("Size of ROOT TTree prefetch cache.  Affects performance.");
+    desc.addUntracked<unsigned int>("prefetchEvents", 0U)
+        ->setComment("If non-zero, the baskets of the branches read by the job are requested asynchronously from the storage\n"
+                     "for this many entries following the event being read, so that remote read latency overlaps with processing.\n"
+                     "Prefetch hit and miss statistics are reported when each file is closed.  0 disables prefetching.");
     std::string defaultString("permissive");
     desc.addUntracked<std::string>("branchesMustMatch", defaultString)
         ->setComment("'strict':     Branches in each input file must match those in the first file.\n"
@@ -1,5 +1,6 @@
 #include "RootTree.h"
 #include "RootDelayedReader.h"
+#include "RootPrefetcher.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
@@ -59,6 +60,7 @@ namespace edm {
     enablePrefetching_(enablePrefetching),
     enableTriggerCache_(branchType_ == InEvent),
     rootDelayedReader_(new RootDelayedReader(*this, filePtr, inputType)),
+    prefetcher_(),
     branchEntryInfoBranch_(metaTree_ ? getProductProvenanceBranch(metaTree_, branchType_) : (tree_ ? getProductProvenanceBranch(tree_, branchType_) : nullptr)),
     infoTree_(dynamic_cast<TTree*>(filePtr_.get() != nullptr ? filePtr->Get(BranchTypeToInfoTreeName(branchType).c_str()) : nullptr)) // backward compatibility
     {
@@ -369,6 +371,9 @@ namespace edm {
   void
   RootTree::getEntry(TBranch* branch, EntryNumber entryNumber) const {
     try {
+      if(prefetcher_) {
+        prefetcher_->branchRead(branch, entryNumber);
+      }
       TTreeCache * cache = selectCache(branch, entryNumber);
       filePtr_->SetCacheRead(cache);
       branch->GetEntry(entryNumber);
@@ -450,6 +455,11 @@ namespace edm {
     // The TFile is about to be closed, and destructed.
     // Just to play it safe, zero all pointers to quantities that are owned by the TFile.
     auxBranch_  = branchEntryInfoBranch_ = nullptr;
+    // Reports the prefetch statistics while the TFile is still open.
+    if(prefetcher_) {
+      prefetcher_->close();
+      prefetcher_.reset();
+    }
     tree_ = metaTree_ = infoTree_ = nullptr;
     // We own the treeCache_.
     // We make sure the treeCache_ is detached from the file,
@@ -497,6 +507,21 @@ namespace edm {
  
   }
   
+  void
+  RootTree::enableEntryPrefetching(unsigned int nEntriesAhead, std::string const& fileName) {
+    if(nEntriesAhead == 0U || entries_ <= 1) {
+      return;
+    }
+    prefetcher_ = std::make_unique<RootPrefetcher>(filePtr_, fileName, nEntriesAhead, entries_);
+  }
+
+  void
+  RootTree::prefetchAfterCurrentEntry() {
+    if(prefetcher_) {
+      prefetcher_->prefetchAfter(entryNumber_);
+    }
+  }
+
   void
   RootTree::setSignals(signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadSource,
                        signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadSource) {
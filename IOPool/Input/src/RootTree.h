@@ -31,6 +31,7 @@ class TTreeCache;
 namespace edm {
   class BranchKey;
   class RootDelayedReader;
+  class RootPrefetcher;
   class InputFile;
   class RootTree;
 
@@ -188,6 +189,8 @@ namespace edm {
     inline TTreeCache* selectCache(TBranch* branch, EntryNumber entryNumber) const;
     void trainCache(char const* branchNames);
     void resetTraining() {trainNow_ = true;}
+    void enableEntryPrefetching(unsigned int nEntriesAhead, std::string const& fileName);
+    void prefetchAfterCurrentEntry();
 
     BranchType branchType() const {return branchType_;}
     
@@ -234,6 +237,8 @@ namespace edm {
     bool enablePrefetching_;
     bool enableTriggerCache_;
     std::unique_ptr<RootDelayedReader> rootDelayedReader_;
+    // Requests the baskets of the next entries from the storage ahead of time.  Event tree of primary input only.
+    std::unique_ptr<RootPrefetcher> prefetcher_;
 
     TBranch* branchEntryInfoBranch_; //backwards compatibility
     // below for backward compatibility
@@ -0,0 +1,30 @@
+# Dumps the content of the products read from PoolInputTest.root and PoolInputOther.root,
+# with prefetching of the following events set by the first argument (0 disables it).
+# The dump must not depend on prefetching.
+
+import FWCore.ParameterSet.Config as cms
+from sys import argv
+from string import atoi
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.INFO.limit = 100
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+
+process.source = cms.Source("PoolSource",
+    setRunNumber = cms.untracked.uint32(621),
+    prefetchEvents = cms.untracked.uint32(atoi(argv[2])),
+    fileNames = cms.untracked.vstring('file:PoolInputTest.root',
+        'file:PoolInputOther.root')
+)
+
+process.dump = cms.EDAnalyzer("EventContentAnalyzer",
+    verboseForModuleLabels = cms.untracked.vstring('Thing'),
+    getDataForModuleLabels = cms.untracked.vstring('Thing')
+)
+
+process.p = cms.Path(process.dump)
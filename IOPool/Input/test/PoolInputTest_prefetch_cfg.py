@@ -0,0 +1,29 @@
+# Same as PoolInputTest_cfg.py, with asynchronous prefetching of the following events enabled
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.INFO.limit = 100
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer")
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer")
+
+process.source = cms.Source("PoolSource",
+    setRunNumber = cms.untracked.uint32(621),
+    prefetchEvents = cms.untracked.uint32(5),
+    fileNames = cms.untracked.vstring('file:PoolInputTest.root',
+        'file:PoolInputOther.root')
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis)
@@ -9,6 +9,15 @@ cmsRun ${LOCAL_TEST_DIR}/PrePoolInputTest_cfg.py PoolInputTest.root 11 561 7 6 3
 cp PoolInputTest.root PoolInputOther.root
 
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputTest_cfg.py || die 'Failure using PoolInputTest_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_prefetch_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputTest_prefetch_cfg.txt || die 'Failure using PoolInputTest_prefetch_cfg.py' $?
+grep 'Event prefetching for file' ${LOCAL_TMP_DIR}/PoolInputTest_prefetch_cfg.txt || die 'Failure in PoolInputTest_prefetch_cfg.py, no prefetch statistics reported' 1
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_prefetchCompare_cfg.py 0 >& ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_0.txt || die 'Failure using PoolInputTest_prefetchCompare_cfg.py without prefetching' $?
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_prefetchCompare_cfg.py 3 >& ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_3.txt || die 'Failure using PoolInputTest_prefetchCompare_cfg.py with prefetching' $?
+grep '^++' ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_0.txt > ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_0.dump
+grep '^++' ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_3.txt > ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_3.dump
+[ `grep -c '^++Event' ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_0.dump` -eq 22 ] || die 'Failure in PoolInputTest_prefetchCompare_cfg.py, not all events read' 1
+diff ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_0.dump ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_3.dump || die 'Failure in PoolInputTest_prefetchCompare_cfg.py, events read with prefetching differ' 1
+grep 'Event prefetching for file' ${LOCAL_TMP_DIR}/PoolInputTest_prefetchCompare_3.txt || die 'Failure in PoolInputTest_prefetchCompare_cfg.py, prefetching not enabled' 1
 cmsRun  ${LOCAL_TEST_DIR}/PoolInputTest_noDelay_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt || die 'Failure using PoolInputTest_noDelay_cfg.py' $?
 grep 'event delayed read from source' ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt && die 'Failure in PoolInputTest_noDelay_cfg.py, found delay reads from source' 1
 
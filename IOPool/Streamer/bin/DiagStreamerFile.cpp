@@ -27,6 +27,7 @@
 #include "IOPool/Streamer/interface/EventMessage.h"
 #include "IOPool/Streamer/interface/InitMessage.h"
 #include "IOPool/Streamer/interface/MsgTools.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
 #include "IOPool/Streamer/interface/StreamerInputFile.h"
 #include "IOPool/Streamer/interface/StreamerOutputFile.h"
 
@@ -269,13 +270,15 @@ bool test_chksum(EventMsgView const* eview) {
 bool test_uncompress(EventMsgView const* eview, std::vector<unsigned char> &dest) {
   unsigned long origsize = eview->origDataSize();
   bool success = false;
-  if(origsize != 0 && origsize != 78)
+  // only zlib is checked here, ZSTD and LZ4 may need the dictionary
+  // of the INIT message and are checked when the file is read back
+  if(eview->compressionAlgorithm() == StreamerCompression::ZLIB)
   {
     // compressed
     success = uncompressBuffer(const_cast<unsigned char*>((unsigned char const*)eview->eventData()),
                                    eview->eventLength(), dest, origsize);
   } else {
-    // uncompressed anyway
+    // uncompressed or not checked
     success = true;
   }
   return success;
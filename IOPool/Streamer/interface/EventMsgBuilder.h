@@ -2,6 +2,7 @@
 #define IOPool_Streamer_EventMsgBuilder_h
 
 #include "IOPool/Streamer/interface/MsgTools.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
 
 // ------------------ event message builder ----------------
 
@@ -13,7 +14,8 @@ public:
                   uint32 droppedEventsCount,
                   std::vector<bool>& l1_bits,
                   uint8* hlt_bits, uint32 hlt_bit_count, 
-                  uint32 adler32_chksum, const char* host_name);
+                  uint32 adler32_chksum, const char* host_name,
+                  uint8 compression_algorithm = StreamerCompression::UNCOMPRESSED);
 
   void setOrigDataSize(uint32);
   uint8* startAddress() const { return buf_; }
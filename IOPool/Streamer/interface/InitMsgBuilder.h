@@ -3,6 +3,7 @@
 
 #include "IOPool/Streamer/interface/MsgTools.h"
 #include "IOPool/Streamer/interface/InitMessage.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
 
 // ----------------- init -------------------
 
@@ -18,7 +19,10 @@ public:
                  const Strings& hlt_names,
                  const Strings& hlt_selections,
                  const Strings& l1_names,
-                 uint32 adler32_chksum);
+                 uint32 adler32_chksum,
+                 uint8 compression_algorithm = StreamerCompression::ZLIB,
+                 const uint8* dictionary = nullptr,
+                 uint32 dictionary_len = 0);
 
   uint8* startAddress() const { return buf_; }
   void setDataLength(uint32 registry_length);
@@ -17,6 +17,12 @@
 #include "DataFormats/Provenance/interface/ParameterSetID.h"
 #include "DataFormats/Provenance/interface/SelectedProducts.h"
 #include "FWCore/Utilities/interface/get_underlying_safe.h"
+#include "FWCore/Utilities/interface/propagate_const.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_CDict_s;
+union LZ4_stream_u;
 
 const int init_size = 1024*1024;
 
@@ -33,7 +39,8 @@ struct SerializeDataBuffer
     ptr_((unsigned char*)rootbuf_.Buffer()),
     header_buf_(),
     bufs_(),
-    adler32_chksum_(0)
+    adler32_chksum_(0),
+    compression_algorithm_(StreamerCompression::UNCOMPRESSED)
   { }
 
   // This object caches the results of the last INIT or event 
@@ -45,6 +52,7 @@ struct SerializeDataBuffer
   unsigned int currentSpaceUsed() const { return curr_space_used_; }
   unsigned int currentEventSize() const { return curr_event_size_; }
   uint32_t adler32_chksum() const { return adler32_chksum_; }
+  uint8 compressionAlgorithm() const { return compression_algorithm_; }
 
   std::vector<unsigned char> comp_buf_; // space for compressed data
   unsigned int curr_event_size_;
@@ -54,6 +62,7 @@ struct SerializeDataBuffer
   SBuffer header_buf_; // place for INIT message creation
   SBuffer bufs_;       // place for EVENT message creation
   uint32_t  adler32_chksum_; // adler32 check sum for the (compressed) data
+  uint8 compression_algorithm_; // codec actually applied to the last event
 };
 
 class EventMsgBuilder;
@@ -71,15 +80,29 @@ namespace edm
   public:
 
     StreamSerializer(SelectedProducts const* selections);
+    ~StreamSerializer();
+    StreamSerializer(StreamSerializer const&) = delete;
+    StreamSerializer& operator=(StreamSerializer const&) = delete;
 
     int serializeRegistry(SerializeDataBuffer &data_buffer,
                           const BranchIDLists &branchIDLists,
                           ThinnedAssociationsHelper const& thinnedAssociationsHelper);
 
     int serializeEvent(EventForOutput const& event, ParameterSetID const& selectorConfig,
-                       bool use_compression, int compression_level,
+                       StreamerCompression::Algorithm compression_algorithm,
+                       int compression_level,
                        SerializeDataBuffer &data_buffer);
 
+    /**
+     * Builds a compression dictionary from the layout of the selected
+     * products, i.e. a serialized event in which all products are absent.
+     * The dictionary is used by subsequent ZSTD and LZ4 event compression
+     * and has to be shipped to the reader in the INIT message.
+     */
+    void buildCompressionDictionary(StreamerCompression::Algorithm compression_algorithm,
+                                    int compression_level);
+    std::vector<unsigned char> const& compressionDictionary() const { return dictionary_; }
+
     /**
      * Compresses the data in the specified input buffer into the
      * specified output buffer.  Returns the size of the compressed data
@@ -92,8 +115,23 @@ namespace edm
 
   private:
 
+    unsigned int compressBufferZSTD(unsigned char *inputBuffer,
+                                    unsigned int inputSize,
+                                    std::vector<unsigned char> &outputBuffer,
+                                    int compressionLevel);
+
+    unsigned int compressBufferLZ4(unsigned char *inputBuffer,
+                                   unsigned int inputSize,
+                                   std::vector<unsigned char> &outputBuffer);
+
     SelectedProducts const* selections_;
     edm::propagate_const<TClass*> tc_;
+
+    std::vector<unsigned char> dictionary_;
+    // compression contexts, owned and created on first use
+    ZSTD_CCtx_s* zstdCCtx_;
+    ZSTD_CDict_s* zstdCDict_;
+    LZ4_stream_u* lz4Stream_;
   };
 
 }
@@ -0,0 +1,34 @@
+#ifndef IOPool_Streamer_StreamerCompression_h
+#define IOPool_Streamer_StreamerCompression_h
+
+/**
+ * StreamerCompression.h
+ *
+ * Codecs that can be used for the event data blob of a streamer
+ * EVENT message. Starting with protocol version 12 the codec is recorded
+ * in both the INIT message (default codec and optional dictionary for the
+ * stream) and in every EVENT message. Older messages are always zlib
+ * (or uncompressed if the original data size is zero).
+ */
+
+#include "IOPool/Streamer/interface/MsgTools.h"
+
+#include <string>
+
+namespace StreamerCompression {
+
+  enum Algorithm : uint8 { UNCOMPRESSED = 0, ZLIB = 1, ZSTD = 2, LZ4 = 3 };
+
+  /**
+   * Translates the configuration name of an algorithm ("ZLIB", "ZSTD",
+   * "LZ4" or "UNCOMPRESSED") into its code. Throws for unknown names.
+   */
+  Algorithm algorithmFromName(std::string const& name);
+
+  /**
+   * Returns the configuration name of an algorithm code, or "UNKNOWN".
+   */
+  char const* algorithmName(uint32 algorithm);
+}
+
+#endif
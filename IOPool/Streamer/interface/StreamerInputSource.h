@@ -23,6 +23,8 @@
 
 class InitMsgView;
 class EventMsgView;
+struct ZSTD_DCtx_s;
+struct ZSTD_DDict_s;
 
 namespace edm {
   class BranchIDListHelper;
@@ -61,6 +63,20 @@ namespace edm {
                                          unsigned int inputSize,
                                          std::vector<unsigned char>& outputBuffer,
                                          unsigned int expectedFullSize);
+
+    /**
+     * Same as uncompressBuffer, for data compressed with zstd or LZ4.
+     * The compression dictionary of the last INIT message is used if
+     * there was one.
+     */
+    unsigned int uncompressBufferZSTD(unsigned char* inputBuffer,
+                                      unsigned int inputSize,
+                                      std::vector<unsigned char>& outputBuffer,
+                                      unsigned int expectedFullSize);
+    unsigned int uncompressBufferLZ4(unsigned char* inputBuffer,
+                                     unsigned int inputSize,
+                                     std::vector<unsigned char>& outputBuffer,
+                                     unsigned int expectedFullSize);
   protected:
     static void declareStreamers(SendDescs const& descs);
     static void buildClassCache(SendDescs const& descs);
@@ -95,6 +111,8 @@ namespace edm {
 
     std::unique_ptr<FileBlock> readFile_() override;
 
+    void setCompressionDictionary(InitMsgView const& initView);
+
     edm::propagate_const<TClass*> tc_;
     std::vector<unsigned char> dest_;
     TBufferFile xbuf_;
@@ -105,6 +123,12 @@ namespace edm {
 
     std::string processName_;
     unsigned int protocolVersion_;
+
+    // compression dictionary from the INIT message and zstd contexts,
+    // owned and created on first use
+    std::vector<unsigned char> dictionary_;
+    ZSTD_DCtx_s* zstdDCtx_;
+    ZSTD_DDict_s* zstdDDict_;
   }; //end-of-class-def
 } // end of namespace-edm
   
@@ -47,6 +47,8 @@ namespace edm {
     int maxEventSize_;
     bool useCompression_;
     int compressionLevel_;
+    StreamerCompression::Algorithm compressionAlgorithm_;
+    bool useCompressionDictionary_;
 
     // test luminosity sections
     int lumiSectionInterval_;  
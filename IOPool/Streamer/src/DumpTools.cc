@@ -9,6 +9,7 @@
 #include <iterator>
 #include "DataFormats/Streamer/interface/StreamedProducts.h"
 #include "IOPool/Streamer/interface/ClassFiller.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
 
 #include "TBufferFile.h"
 
@@ -36,6 +37,11 @@ void dumpInitHeader(const InitMsgView* view)
     std::cout << "Checksum for Registry data = " << view->adler32_chksum()
               << " Hostname = " << view->hostName() << std::endl;
   }
+  if (view->protocolVersion() >= 12) {
+    std::cout << "Compression algorithm = "
+              << StreamerCompression::algorithmName(view->compressionAlgorithm())
+              << " dictionary length = " << view->compressionDictionaryLength() << std::endl;
+  }
 
   //PSet 16 byte non-printable representation, stored in message.
   uint8 vpset[16];
@@ -154,6 +160,7 @@ void dumpEventHeader(const EventMsgView* eview)
        << "adler32 chksum= " << eview->adler32_chksum() << "\n"
        << "host name= " << eview->hostName() << "\n"
        << "event length=" << eview->eventLength() << "\n"
+       << "compression=" << StreamerCompression::algorithmName(eview->compressionAlgorithm()) << "\n"
        << "droppedEventsCount=" << eview->droppedEventsCount() << "\n";
 
   std::vector<bool> l1_out;
@@ -1,9 +1,11 @@
 #include "IOPool/Streamer/interface/EventMessage.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
 
 EventMsgView::EventMsgView(void* buf):
   buf_((uint8*)buf),head_(buf),
+  compression_algorithm_(StreamerCompression::UNCOMPRESSED),
   v2Detected_(false)
 { 
   // 29-Jan-2008, KAB - adding an explicit version number.
@@ -15,9 +17,10 @@ EventMsgView::EventMsgView(void* buf):
 
   // 18-Jul-2008, wmtan - payload changed for version 7.
   // So we no longer support previous formats.
-  if (protocolVersion() != 11) {
+  // Version 12 only adds the compression algorithm, so we keep reading 11.
+  if (protocolVersion() != 11 && protocolVersion() != 12) {
     throw cms::Exception("EventMsgView", "Invalid Message Version:")
-      << "Only message version 10 is currently supported \n"
+      << "Only message versions 11 and 12 are currently supported \n"
       << "(invalid value = " << protocolVersion() << ").\n"
       << "We support only reading and converting streamer files\n"
       << "using the same version of CMSSW used to created the\n"
@@ -60,6 +63,16 @@ EventMsgView::EventMsgView(void* buf):
   host_name_len_ = *host_name_start_;
   host_name_start_ += sizeof(uint8);
   event_start_ = host_name_start_ + host_name_len_;
+  if (protocolVersion() > 11) {
+    compression_algorithm_ = *event_start_;
+    event_start_ += sizeof(uint8);
+  } else {
+    // before version 12 the only codec was zlib, and 78 was a dummy
+    // value used to flag uncompressed data
+    uint32 origsize = origDataSize();
+    compression_algorithm_ = (origsize != 78 && origsize != 0) ?
+      StreamerCompression::ZLIB : StreamerCompression::UNCOMPRESSED;
+  }
   event_len_ = convert32(event_start_); 
   event_start_ += sizeof(char_uint32); 
 }
@@ -11,11 +11,12 @@ EventMsgBuilder::EventMsgBuilder(void* buf, uint32 size,
                                  uint32 outModId, uint32 droppedEventsCount,
                                  std::vector<bool>& l1_bits,
                                  uint8* hlt_bits, uint32 hlt_bit_count, 
-                                 uint32 adler_chksum, const char* host_name):
+                                 uint32 adler_chksum, const char* host_name,
+                                 uint8 compression_algorithm):
   buf_((uint8*)buf),size_(size)
 {
   EventHeader* h = (EventHeader*)buf_;
-  h->protocolVersion_ = 11;
+  h->protocolVersion_ = 12;
   convert(run,h->run_);
   convert(event,h->event_);
   convert(lumi,h->lumi_);
@@ -76,6 +77,9 @@ EventMsgBuilder::EventMsgBuilder(void* buf, uint32 size,
   }
   pos += host_name_len;
 
+  // compression algorithm of the event data blob
+  *pos++ = compression_algorithm;
+
   event_addr_ = pos + sizeof(char_uint32);
   setEventLength(0);
 }
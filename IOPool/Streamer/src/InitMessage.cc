@@ -1,4 +1,5 @@
 #include "IOPool/Streamer/interface/InitMessage.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include <iostream>
 #include <iterator>
@@ -26,6 +27,9 @@ InitMsgView::InitMsgView(void* buf) :
   adler32_chksum_(0),
   host_name_start_(nullptr),
   host_name_len_(0),
+  compression_algorithm_(StreamerCompression::ZLIB),
+  dictionary_start_(nullptr),
+  dictionary_len_(0),
   desc_start_(nullptr),
   desc_len_(0) {
   if (protocolVersion() == 2) {
@@ -96,6 +100,14 @@ InitMsgView::InitMsgView(void* buf) :
     }
   }
 
+  if (protocolVersion() > 11) {
+    compression_algorithm_ = *pos;
+    pos += sizeof(uint8);
+    dictionary_len_ = convert32(pos);
+    dictionary_start_ = pos + sizeof(char_uint32);
+    pos = dictionary_start_ + dictionary_len_;
+  }
+
   desc_start_ = pos;
   desc_len_ = convert32(desc_start_);
   desc_start_ += sizeof(char_uint32);
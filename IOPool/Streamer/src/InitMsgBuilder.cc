@@ -15,7 +15,10 @@ InitMsgBuilder::InitMsgBuilder(void* buf, uint32 size,
                                const Strings& hlt_names,
                                const Strings& hlt_selections,
                                const Strings& l1_names,
-                               uint32 adler_chksum):
+                               uint32 adler_chksum,
+                               uint8 compression_algorithm,
+                               const uint8* dictionary,
+                               uint32 dictionary_len):
   buf_((uint8*)buf),size_(size)
 {
   InitHeader* h = (InitHeader*)buf_;
@@ -59,6 +62,17 @@ InitMsgBuilder::InitMsgBuilder(void* buf, uint32 size,
   convert(adler_chksum, pos);
   pos = pos + sizeof(uint32);
 
+  // default compression algorithm of the event data blobs
+  *pos++ = compression_algorithm;
+
+  // compression dictionary shared by all events of the stream
+  convert(dictionary_len, pos);
+  pos = pos + sizeof(char_uint32);
+  if(dictionary_len != 0) {
+    memcpy(pos, dictionary, dictionary_len);
+    pos += dictionary_len;
+  }
+
   data_addr_ = pos + sizeof(char_uint32);
   setDataLength(0);
 
@@ -22,6 +22,8 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 
 #include "zlib.h"
+#include "zstd.h"
+#include "lz4.h"
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
@@ -34,7 +36,54 @@ namespace edm {
    */
   StreamSerializer::StreamSerializer(SelectedProducts const* selections):
     selections_(selections),
-    tc_(getTClass(typeid(SendEvent))) {
+    tc_(getTClass(typeid(SendEvent))),
+    dictionary_(),
+    zstdCCtx_(nullptr),
+    zstdCDict_(nullptr),
+    lz4Stream_(nullptr) {
+  }
+
+  StreamSerializer::~StreamSerializer() {
+    ZSTD_freeCDict(zstdCDict_);
+    ZSTD_freeCCtx(zstdCCtx_);
+    if(lz4Stream_ != nullptr) LZ4_freeStream(lz4Stream_);
+  }
+
+  /**
+   * Serializes an event without products, which is what every event
+   * written with the current selections starts from, and keeps it as
+   * the raw-content compression dictionary. The class and branch
+   * descriptions it contains are repeated in every event blob.
+   */
+  void StreamSerializer::buildCompressionDictionary(StreamerCompression::Algorithm compression_algorithm,
+                                                    int compression_level) {
+    SendEvent se(EventAuxiliary(), ProcessHistory(), EventSelectionIDVector(), BranchListIndexes());
+    for(auto const& selection : *selections_) {
+      se.products().push_back(StreamedProduct(*selection.first));
+    }
+
+    TBufferFile rootbuf(TBuffer::kWrite, init_size);
+    RootDebug tracer(10,10);
+    if(rootbuf.WriteObjectAny(&se, tc_) != 1) {
+      throw cms::Exception("StreamTranslation","Dictionary serialization failed")
+        << "StreamSerializer failed to serialize the product layout\n"
+        << "used as compression dictionary\n";
+    }
+    unsigned char const* start = (unsigned char const*)rootbuf.Buffer();
+    dictionary_.assign(start, start + rootbuf.Length());
+
+    ZSTD_freeCDict(zstdCDict_);
+    zstdCDict_ = nullptr;
+    if(compression_algorithm == StreamerCompression::ZSTD) {
+      zstdCDict_ = ZSTD_createCDict(&dictionary_[0], dictionary_.size(), compression_level);
+      if(zstdCDict_ == nullptr) {
+        throw cms::Exception("StreamTranslation","Dictionary creation failed")
+          << "ZSTD_createCDict failed for a dictionary of "
+          << dictionary_.size() << " bytes\n";
+      }
+    }
+    FDEBUG(6) << "StreamSerializer compression dictionary size = "
+              << dictionary_.size() << std::endl;
   }
 
   /**
@@ -127,7 +176,8 @@ namespace edm {
    */
   int StreamSerializer::serializeEvent(EventForOutput const& event,
                                        ParameterSetID const& selectorConfig,
-                                       bool use_compression, int compression_level,
+                                       StreamerCompression::Algorithm compression_algorithm,
+                                       int compression_level,
                                        SerializeDataBuffer& data_buffer) {
 
     EventSelectionIDVector selectionIDs = event.eventSelectionIDs();
@@ -222,12 +272,26 @@ namespace edm {
     // compress before return if we need to
     // should test if compressed already - should never be?
     //   as double compression can have problems
-    if(use_compression) {
-      unsigned int dest_size =
-        compressBuffer(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+    data_buffer.compression_algorithm_ = StreamerCompression::UNCOMPRESSED;
+    if(compression_algorithm != StreamerCompression::UNCOMPRESSED) {
+      unsigned int dest_size = 0;
+      switch(compression_algorithm) {
+        case StreamerCompression::ZLIB:
+          dest_size = compressBuffer(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        case StreamerCompression::ZSTD:
+          dest_size = compressBufferZSTD(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        case StreamerCompression::LZ4:
+          dest_size = compressBufferLZ4(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_);
+          break;
+        default:
+          break;
+      }
       if(dest_size != 0) {
         data_buffer.ptr_ = &data_buffer.comp_buf_[0]; // reset to point at compressed area
         data_buffer.curr_space_used_ = dest_size;
+        data_buffer.compression_algorithm_ = compression_algorithm;
       }
     }
     // calculate the adler32 checksum and fill it into the struct
@@ -278,4 +342,84 @@ namespace edm {
 
     return resultSize;
   }
+
+  /**
+   * Compresses the data with zstd, using the product layout dictionary
+   * if one was built. Returns the size of the compressed data or zero
+   * if compression failed.
+   */
+  unsigned int
+  StreamSerializer::compressBufferZSTD(unsigned char *inputBuffer,
+                                       unsigned int inputSize,
+                                       std::vector<unsigned char> &outputBuffer,
+                                       int compressionLevel) {
+    size_t dest_size = ZSTD_compressBound(inputSize);
+    if(outputBuffer.size() < dest_size) outputBuffer.resize(dest_size);
+
+    // the context is reused so that its work space is allocated only once
+    if(zstdCCtx_ == nullptr) {
+      zstdCCtx_ = ZSTD_createCCtx();
+      if(zstdCCtx_ == nullptr) {
+        throw cms::Exception("StreamTranslation","Compression context creation failed")
+          << "ZSTD_createCCtx failed\n";
+      }
+    }
+
+    size_t ret;
+    if(zstdCDict_ != nullptr) {
+      ret = ZSTD_compress_usingCDict(zstdCCtx_, &outputBuffer[0], dest_size,
+                                     inputBuffer, inputSize, zstdCDict_);
+    } else {
+      ret = ZSTD_compressCCtx(zstdCCtx_, &outputBuffer[0], dest_size,
+                              inputBuffer, inputSize, compressionLevel);
+    }
+
+    if(ZSTD_isError(ret)) {
+      std::cerr << "ZSTD compression error: " << ZSTD_getErrorName(ret) << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << ret
+              << " ratio = " << double(ret)/double(inputSize)
+              << std::endl;
+    return (unsigned int) ret;
+  }
+
+  /**
+   * Compresses the data with LZ4 at its default (fastest) setting, using
+   * the product layout dictionary if one was built. Returns the size of
+   * the compressed data or zero if compression failed.
+   */
+  unsigned int
+  StreamSerializer::compressBufferLZ4(unsigned char *inputBuffer,
+                                      unsigned int inputSize,
+                                      std::vector<unsigned char> &outputBuffer) {
+    int dest_size = LZ4_compressBound(inputSize);
+    if(dest_size <= 0) {
+      std::cerr << "LZ4 compression error: input of " << inputSize << " bytes is too large" << std::endl;
+      return 0;
+    }
+    if(outputBuffer.size() < (unsigned int)dest_size) outputBuffer.resize(dest_size);
+
+    int ret;
+    if(!dictionary_.empty()) {
+      if(lz4Stream_ == nullptr) lz4Stream_ = LZ4_createStream();
+      // LZ4_loadDict resets the stream, so every event is independent
+      LZ4_loadDict(lz4Stream_, (char const*)&dictionary_[0], dictionary_.size());
+      ret = LZ4_compress_fast_continue(lz4Stream_, (char const*)inputBuffer,
+                                       (char*)&outputBuffer[0], inputSize, dest_size, 1);
+    } else {
+      ret = LZ4_compress_default((char const*)inputBuffer, (char*)&outputBuffer[0], inputSize, dest_size);
+    }
+
+    if(ret <= 0) {
+      std::cerr << "LZ4 compression error: return value " << ret << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << ret
+              << " ratio = " << double(ret)/double(inputSize)
+              << std::endl;
+    return (unsigned int) ret;
+  }
 }
@@ -0,0 +1,25 @@
+#include "IOPool/Streamer/interface/StreamerCompression.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+namespace StreamerCompression {
+
+  Algorithm algorithmFromName(std::string const& name) {
+    if(name == "ZLIB") return ZLIB;
+    if(name == "ZSTD") return ZSTD;
+    if(name == "LZ4") return LZ4;
+    if(name == "UNCOMPRESSED") return UNCOMPRESSED;
+    throw cms::Exception("Configuration", "StreamerCompression")
+      << "Unknown compression algorithm '" << name << "'.\n"
+      << "Allowed values are ZLIB, ZSTD, LZ4 and UNCOMPRESSED.\n";
+  }
+
+  char const* algorithmName(uint32 algorithm) {
+    switch(algorithm) {
+      case UNCOMPRESSED: return "UNCOMPRESSED";
+      case ZLIB: return "ZLIB";
+      case ZSTD: return "ZSTD";
+      case LZ4: return "LZ4";
+      default: return "UNKNOWN";
+    }
+  }
+}
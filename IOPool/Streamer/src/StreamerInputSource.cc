@@ -3,6 +3,7 @@
 #include "IOPool/Streamer/interface/EventMessage.h"
 #include "IOPool/Streamer/interface/InitMessage.h"
 #include "IOPool/Streamer/interface/ClassFiller.h"
+#include "IOPool/Streamer/interface/StreamerCompression.h"
 
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/Framework/interface/FileBlock.h"
@@ -17,6 +18,8 @@
 #include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
 
 #include "zlib.h"
+#include "zstd.h"
+#include "lz4.h"
 
 #include "DataFormats/Common/interface/RefCoreStreamer.h"
 #include "FWCore/Utilities/interface/WrappedClassName.h"
@@ -51,10 +54,16 @@ namespace edm {
     eventPrincipalHolder_(),
     adjustEventToNewProductRegistry_(false),
     processName_(),
-    protocolVersion_(0U) {
+    protocolVersion_(0U),
+    dictionary_(),
+    zstdDCtx_(nullptr),
+    zstdDDict_(nullptr) {
   }
 
-  StreamerInputSource::~StreamerInputSource() {}
+  StreamerInputSource::~StreamerInputSource() {
+    ZSTD_freeDDict(zstdDDict_);
+    ZSTD_freeDCtx(zstdDCtx_);
+  }
 
   // ---------------------------------------
   std::unique_ptr<FileBlock>
@@ -171,9 +180,33 @@ namespace edm {
     }
 
     sd->initializeTransients();
+    setCompressionDictionary(initView);
     return sd;
   }
 
+  /**
+   * Keeps the compression dictionary of the INIT message (if any) for
+   * the events that follow it.
+   */
+  void
+  StreamerInputSource::setCompressionDictionary(InitMsgView const& initView) {
+    ZSTD_freeDDict(zstdDDict_);
+    zstdDDict_ = nullptr;
+    uint8 const* start = initView.compressionDictionary();
+    dictionary_.assign(start, start + initView.compressionDictionaryLength());
+    if(!dictionary_.empty() && initView.compressionAlgorithm() == StreamerCompression::ZSTD) {
+      zstdDDict_ = ZSTD_createDDict(&dictionary_[0], dictionary_.size());
+      if(zstdDDict_ == nullptr) {
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+          << "ZSTD_createDDict failed for a dictionary of "
+          << dictionary_.size() << " bytes\n";
+      }
+    }
+    FDEBUG(10) << "StreamerInputSource compression algorithm = "
+               << StreamerCompression::algorithmName(initView.compressionAlgorithm())
+               << " dictionary size = " << dictionary_.size() << std::endl;
+  }
+
   /**
    * Deserializes the specified init message into a SendJobHeader object
    * and merges registries.
@@ -212,8 +245,8 @@ namespace edm {
          << eventView.eventData()
          << std::endl;
     // uncompress if we need to
-    // 78 was a dummy value (for no uncompressed) - should be 0 for uncompressed
-    // need to get rid of this when 090 MTCC streamers are gotten rid of
+    // the view maps the pre-version 12 convention (78 or 0 for
+    // uncompressed, zlib otherwise) onto the compression algorithm
     unsigned long origsize = eventView.origDataSize();
     unsigned long dest_size; //(should be >= eventView.origDataSize())
 
@@ -227,17 +260,31 @@ namespace edm {
         << " chksum from event = " << adler32_chksum << " from header = "
         << eventView.adler32_chksum() << " host name = " << eventView.hostName() << std::endl;
     }
-    if(origsize != 78 && origsize != 0) {
-      // compressed
-      dest_size = uncompressBuffer(const_cast<unsigned char*>((unsigned char const*)eventView.eventData()),
-                                   eventView.eventLength(), dest_, origsize);
-    } else { // not compressed
-      // we need to copy anyway the buffer as we are using dest in xbuf
-      dest_size = eventView.eventLength();
-      dest_.resize(dest_size);
-      unsigned char* pos = (unsigned char*) &dest_[0];
-      unsigned char const* from = (unsigned char const*) eventView.eventData();
-      std::copy(from,from+dest_size,pos);
+    unsigned char* eventData = const_cast<unsigned char*>((unsigned char const*)eventView.eventData());
+    switch(eventView.compressionAlgorithm()) {
+      case StreamerCompression::ZLIB:
+        dest_size = uncompressBuffer(eventData, eventView.eventLength(), dest_, origsize);
+        break;
+      case StreamerCompression::ZSTD:
+        dest_size = uncompressBufferZSTD(eventData, eventView.eventLength(), dest_, origsize);
+        break;
+      case StreamerCompression::LZ4:
+        dest_size = uncompressBufferLZ4(eventData, eventView.eventLength(), dest_, origsize);
+        break;
+      case StreamerCompression::UNCOMPRESSED:
+      {
+        // we need to copy anyway the buffer as we are using dest in xbuf
+        dest_size = eventView.eventLength();
+        dest_.resize(dest_size);
+        unsigned char* pos = (unsigned char*) &dest_[0];
+        unsigned char const* from = (unsigned char const*) eventView.eventData();
+        std::copy(from,from+dest_size,pos);
+        break;
+      }
+      default:
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+          << "unknown compression algorithm " << eventView.compressionAlgorithm()
+          << " for event " << eventView.event() << "\n";
     }
     //TBuffer xbuf(TBuffer::kRead, dest_size,
     //             (char const*) &dest[0],kFALSE);
@@ -387,6 +434,67 @@ namespace edm {
     return (unsigned int) uncompressedSize;
   }
 
+  unsigned int
+  StreamerInputSource::uncompressBufferZSTD(unsigned char* inputBuffer,
+                                            unsigned int inputSize,
+                                            std::vector<unsigned char>& outputBuffer,
+                                            unsigned int expectedFullSize) {
+    FDEBUG(1) << "Uncompress ZSTD: original size = " << expectedFullSize
+              << ", compressed size = " << inputSize
+              << std::endl;
+    outputBuffer.resize(expectedFullSize);
+    if(zstdDCtx_ == nullptr) {
+      zstdDCtx_ = ZSTD_createDCtx();
+      if(zstdDCtx_ == nullptr) {
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+          << "ZSTD_createDCtx failed\n";
+      }
+    }
+    size_t ret;
+    if(zstdDDict_ != nullptr) {
+      ret = ZSTD_decompress_usingDDict(zstdDCtx_, &outputBuffer[0], expectedFullSize,
+                                       inputBuffer, inputSize, zstdDDict_);
+    } else {
+      ret = ZSTD_decompressDCtx(zstdDCtx_, &outputBuffer[0], expectedFullSize,
+                                inputBuffer, inputSize);
+    }
+    if(ZSTD_isError(ret)) {
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+            << "ZSTD error = " << ZSTD_getErrorName(ret) << "\n ";
+    }
+    if(ret != expectedFullSize) {
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+          << "mismatch event lengths should be" << expectedFullSize << " got "
+          << ret << "\n";
+    }
+    return (unsigned int) ret;
+  }
+
+  unsigned int
+  StreamerInputSource::uncompressBufferLZ4(unsigned char* inputBuffer,
+                                           unsigned int inputSize,
+                                           std::vector<unsigned char>& outputBuffer,
+                                           unsigned int expectedFullSize) {
+    FDEBUG(1) << "Uncompress LZ4: original size = " << expectedFullSize
+              << ", compressed size = " << inputSize
+              << std::endl;
+    outputBuffer.resize(expectedFullSize);
+    int ret = LZ4_decompress_safe_usingDict((char const*)inputBuffer, (char*)&outputBuffer[0],
+                                            inputSize, expectedFullSize,
+                                            dictionary_.empty() ? nullptr : (char const*)&dictionary_[0],
+                                            dictionary_.size());
+    if(ret < 0) {
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+            << "LZ4 error code = " << ret << "\n ";
+    }
+    if((unsigned int)ret != expectedFullSize) {
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+          << "mismatch event lengths should be" << expectedFullSize << " got "
+          << ret << "\n";
+    }
+    return (unsigned int) ret;
+  }
+
   void StreamerInputSource::resetAfterEndRun() {
      // called from an online streamer source to reset after a stop command
      // so an enable command will work
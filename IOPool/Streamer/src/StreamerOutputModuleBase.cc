@@ -8,6 +8,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 #include "FWCore/Utilities/interface/DebugMacros.h"
+#include "FWCore/Utilities/interface/Exception.h"
 //#include "FWCore/Utilities/interface/Digest.h"
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 #include "DataFormats/Common/interface/TriggerResults.h"
@@ -61,6 +62,8 @@ namespace edm {
     maxEventSize_(ps.getUntrackedParameter<int>("max_event_size")),
     useCompression_(ps.getUntrackedParameter<bool>("use_compression")),
     compressionLevel_(ps.getUntrackedParameter<int>("compression_level")),
+    compressionAlgorithm_(StreamerCompression::algorithmFromName(ps.getUntrackedParameter<std::string>("compression_algorithm"))),
+    useCompressionDictionary_(ps.getUntrackedParameter<bool>("compression_dictionary")),
     lumiSectionInterval_(ps.getUntrackedParameter<int>("lumiSection_interval")),
     serializer_(selections_),
     serializeDataBuffer_(),
@@ -82,17 +85,33 @@ namespace edm {
     timeInSecSinceUTC = static_cast<double>(now.tv_sec) + (static_cast<double>(now.tv_usec)/1000000.0);
 
     if(useCompression_ == true) {
-      if(compressionLevel_ <= 0) {
+      // LZ4 ignores the level, so a level of 0 would only turn it off behind the user's back
+      if(compressionLevel_ <= 0 && compressionAlgorithm_ == StreamerCompression::LZ4) {
+        throw cms::Exception("Configuration")
+          << "StreamerOutputModuleBase: compression_level " << compressionLevel_
+          << " is not valid with compression_algorithm LZ4. Use a positive level, or set"
+          << " use_compression to False to write uncompressed events.\n";
+      }
+      // zstd accepts levels up to 22, zlib up to 9; LZ4 ignores the level
+      int const maxLevel = compressionAlgorithm_ == StreamerCompression::ZSTD ? 22 : 9;
+      if(compressionLevel_ <= 0 || compressionAlgorithm_ == StreamerCompression::UNCOMPRESSED) {
         FDEBUG(9) << "Compression Level = " << compressionLevel_
                   << " no compression" << std::endl;
         compressionLevel_ = 0;
         useCompression_ = false;
-      } else if(compressionLevel_ > 9) {
+      } else if(compressionLevel_ > maxLevel) {
         FDEBUG(9) << "Compression Level = " << compressionLevel_
-                  << " using max compression level 9" << std::endl;
-        compressionLevel_ = 9;
+                  << " using max compression level " << maxLevel << std::endl;
+        compressionLevel_ = maxLevel;
       }
     }
+    if(!useCompression_) {
+      compressionAlgorithm_ = StreamerCompression::UNCOMPRESSED;
+    }
+    // zlib has no dictionary support in the streamer format
+    if(compressionAlgorithm_ != StreamerCompression::ZSTD && compressionAlgorithm_ != StreamerCompression::LZ4) {
+      useCompressionDictionary_ = false;
+    }
     serializeDataBuffer_.bufs_.resize(maxEventSize_);
     int got_host = gethostname(host_name_, 255);
     if(got_host != 0) strncpy(host_name_, "noHostNameFoundOrTooLong", sizeof(host_name_));
@@ -144,10 +163,15 @@ namespace edm {
 
     serializer_.serializeRegistry(serializeDataBuffer_, *branchIDLists(), *thinnedAssociationsHelper());
 
+    if(useCompressionDictionary_) {
+      serializer_.buildCompressionDictionary(compressionAlgorithm_, compressionLevel_);
+    }
+    std::vector<unsigned char> const& dictionary = serializer_.compressionDictionary();
+
     // resize bufs_ to reflect space used in serializer_ + header
     // I just added an overhead for header of 50000 for now
     unsigned int src_size = serializeDataBuffer_.currentSpaceUsed();
-    unsigned int new_size = src_size + 50000;
+    unsigned int new_size = src_size + dictionary.size() + 50000;
     if(serializeDataBuffer_.header_buf_.size() < new_size) serializeDataBuffer_.header_buf_.resize(new_size);
 
     //Build the INIT Message
@@ -188,7 +212,9 @@ namespace edm {
                            getReleaseVersion().c_str() , processName.c_str(),
                            moduleLabel.c_str(), outputModuleId_,
                            hltTriggerNames, hltTriggerSelections_, l1_names,
-                           (uint32)serializeDataBuffer_.adler32_chksum());
+                           (uint32)serializeDataBuffer_.adler32_chksum(),
+                           compressionAlgorithm_,
+                           dictionary.empty() ? nullptr : &dictionary[0], dictionary.size());
 
     // copy data into the destination message
     unsigned char* src = serializeDataBuffer_.bufferPointer();
@@ -264,7 +290,7 @@ namespace edm {
       setLumiSection();
     }
 
-    serializer_.serializeEvent(e, selectorConfig(), useCompression_, compressionLevel_, serializeDataBuffer_);
+    serializer_.serializeEvent(e, selectorConfig(), compressionAlgorithm_, compressionLevel_, serializeDataBuffer_);
 
     // resize bufs_ to reflect space used in serializer_ + header
     // I just added an overhead for header of 50000 for now
@@ -276,7 +302,8 @@ namespace edm {
                               &serializeDataBuffer_.bufs_[0], serializeDataBuffer_.bufs_.size(), e.id().run(),
                               e.id().event(), lumi_, outputModuleId_, 0,
                               l1bit_, (uint8*)&hltbits_[0], hltsize_,
-                              (uint32)serializeDataBuffer_.adler32_chksum(), host_name_);
+                              (uint32)serializeDataBuffer_.adler32_chksum(), host_name_,
+                              serializeDataBuffer_.compressionAlgorithm());
     msg->setOrigDataSize(origSize_); // we need this set to zero
 
     // copy data into the destination message
@@ -291,7 +318,9 @@ namespace edm {
     unsigned char* src = serializeDataBuffer_.bufferPointer();
     std::copy(src,src + src_size, msg->eventAddr());
     msg->setEventLength(src_size);
-    if(useCompression_) msg->setOrigDataSize(serializeDataBuffer_.currentEventSize());
+    if(serializeDataBuffer_.compressionAlgorithm() != StreamerCompression::UNCOMPRESSED) {
+      msg->setOrigDataSize(serializeDataBuffer_.currentEventSize());
+    }
 
     l1bit_.clear();  //Clear up for the next event to come.
     return msg;
@@ -304,7 +333,13 @@ namespace edm {
     desc.addUntracked<bool>("use_compression", true)
         ->setComment("If True, compression will be used to write streamer file.");
     desc.addUntracked<int>("compression_level", 1)
-        ->setComment("ROOT compression level to use.");
+        ->setComment("Compression level to use (1-9 for ZLIB, 1-22 for ZSTD, ignored for LZ4).\n"
+                     "0 or less disables ZLIB and ZSTD compression, and is rejected with LZ4.");
+    desc.addUntracked<std::string>("compression_algorithm", "ZLIB")
+        ->setComment("Compression algorithm: ZLIB, ZSTD, LZ4 or UNCOMPRESSED.");
+    desc.addUntracked<bool>("compression_dictionary", false)
+        ->setComment("If True, ZSTD and LZ4 compression use a dictionary built from the layout\n"
+                     "of the selected products, which is stored in the INIT message.");
     desc.addUntracked<int>("lumiSection_interval", 0)
         ->setComment("If 0, use lumi section number from event.\n"
                      "If not 0, the interval in seconds between fake lumi sections.");
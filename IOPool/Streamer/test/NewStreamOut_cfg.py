@@ -33,5 +33,16 @@ process.out = cms.OutputModule("EventStreamFileWriter",
     max_event_size = cms.untracked.int32(7000000)
 )
 
+process.outZSTD = process.out.clone(
+    fileName = 'teststreamfile_zstd.dat',
+    compression_algorithm = cms.untracked.string('ZSTD'),
+    compression_dictionary = cms.untracked.bool(True)
+)
+
+process.outLZ4 = process.out.clone(
+    fileName = 'teststreamfile_lz4.dat',
+    compression_algorithm = cms.untracked.string('LZ4')
+)
+
 process.p1 = cms.Path(process.m1*process.a1*process.m2)
-process.end = cms.EndPath(process.out)
+process.end = cms.EndPath(process.out*process.outZSTD*process.outLZ4)
@@ -12,7 +12,6 @@
 #include "DetectorDescription/Core/interface/DDCompactView.h"
 
 #include <vector>
-#include <atomic>
 
 class MagBLayer;
 class MagESector;
@@ -62,7 +61,9 @@ private:
 
   bool inBarrel(const GlobalPoint& gp) const;
 
-  mutable std::atomic<MagVolume const*> lastVolume; // Cache last volume found
+  // Serial number of this geometry; the last volume found is cached
+  // per thread and per geometry (see findVolume)
+  const unsigned int theId;
 
   std::vector<MagBLayer const*> theBLayers;
   std::vector<MagESector const*> theESectors;
@@ -17,9 +17,36 @@
 #include "MagneticField/Layers/interface/MagVerbosity.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <atomic>
+
 using namespace std;
 using namespace edm;
 
+namespace {
+  // Last volume found by each thread, for a few geometries at a time.
+  // Geometries are keyed by serial number rather than by address, as a new
+  // geometry may be allocated where a deleted one was.
+  struct LastVolumeCache {
+    static constexpr unsigned int nSlots = 4;
+    unsigned int geomId[nSlots] = {0, 0, 0, 0};
+    MagVolume const* volume[nSlots] = {nullptr, nullptr, nullptr, nullptr};
+    unsigned int next = 0;
+
+    MagVolume const* & slot(unsigned int id) {
+      for (unsigned int i = 0; i < nSlots; ++i)
+	if (geomId[i] == id) return volume[i];
+      unsigned int i = next;
+      next = (next+1) % nSlots;
+      geomId[i] = id;
+      volume[i] = nullptr;
+      return volume[i];
+    }
+  };
+
+  thread_local LastVolumeCache lastVolumeCache;
+  std::atomic<unsigned int> nextGeometryId{1};
+}
+
 MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer *>& tbl,
 			 const std::vector<MagESector *>& tes,
 			 const std::vector<MagVolume6Faces*>& tbv,
@@ -31,7 +58,7 @@ MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer const*>& t
 			 const std::vector<MagESector const*>& tes,
 			 const std::vector<MagVolume6Faces const*>& tbv,
 			 const std::vector<MagVolume6Faces const*>& tev) : 
-  lastVolume(nullptr), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
+  theId(nextGeometryId++), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
 {
   vector<double> rBorders;
 
@@ -136,9 +163,9 @@ MagGeometry::findVolume1(const GlobalPoint & gp, double tolerance) const {
 MagVolume const* 
 MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
   // Check volume cache
-  auto lastVolumeCheck = lastVolume.load(std::memory_order_acquire);
-  if (lastVolumeCheck!=nullptr && lastVolumeCheck->inside(gp)){
-    return lastVolumeCheck;
+  MagVolume const* & lastVolume = lastVolumeCache.slot(theId);
+  if (lastVolume!=nullptr && lastVolume->inside(gp)){
+    return lastVolume;
   }
 
   MagVolume const* result=nullptr;
@@ -175,7 +202,7 @@ MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
     result = findVolume(gp, 0.03);
   }
 
-  if (cacheLastVolume) lastVolume.store(result,std::memory_order_release);
+  if (cacheLastVolume) lastVolume = result;
 
   return result;
 }
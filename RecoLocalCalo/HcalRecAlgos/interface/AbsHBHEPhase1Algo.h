@@ -51,6 +51,23 @@ public:
                                    const HcalRecoParam* params,
                                    const HcalCalibrations& calibs,
                                    bool isRealData) = 0;
+
+    // Reconstructs "n" channels at once, with the same conventions
+    // as above. The i-th rechit is made from infos[i], params[i]
+    // and calibs[i], and "rechits" must have room for "n" rechits.
+    // Algorithms which can fit several channels together should
+    // override this; by default, the channels are done one by one.
+    //
+    inline virtual void reconstructBatch(const HBHEChannelInfo* infos,
+                                         const HcalRecoParam* const* params,
+                                         const HcalCalibrations* const* calibs,
+                                         const unsigned n,
+                                         const bool isRealData,
+                                         HBHERecHit* rechits)
+    {
+        for (unsigned i=0; i<n; ++i)
+            rechits[i] = reconstruct(infos[i], params[i], *calibs[i], isRealData);
+    }
 };
 
 #endif // RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
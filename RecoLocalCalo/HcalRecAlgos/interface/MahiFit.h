@@ -14,6 +14,11 @@
 
 #include <Math/Functor.h>
 
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+
 struct MahiNnlsWorkspace {
 
   unsigned int nPulseTot;
@@ -115,11 +120,20 @@ struct MahiDebugInfo {
   
 };
 
+struct MahiFitResult {
+
+  float energy;
+  float time;
+  bool  useTriple;
+  float chi2;
+
+};
+
 class MahiFit
 {
  public:
   MahiFit();
-  ~MahiFit() { };
+  ~MahiFit();
 
   void setParameters(bool iDynamicPed, double iTS4Thresh, double chiSqSwitch, 
 		     bool iApplyTimeSlew, HcalTimeSlew::BiasSetting slewFlavor,
@@ -136,13 +150,28 @@ class MahiFit
   void phase1Debug(const HBHEChannelInfo& channelData,
 		   MahiDebugInfo& mdi) const;
 
+  // Same results as setPulseShapeTemplate and phase1Apply called for each
+  // channel with its reco shape, but the minimizations of batchLanes channels
+  // with the same number of samples are done together, vectorized across the
+  // channels.
+  void phase1ApplyBatch(const HBHEChannelInfo* channels,
+			const HcalPulseShapes& pulseShapes,
+			const HcalTimeSlew* hcalTimeSlewDelay,
+			unsigned int nChannels,
+			MahiFitResult* results);
+
+  static constexpr unsigned int batchLanes = 8;
+
+  // state of the channels fitted together, see MahiFit.cc
+  struct Block;
+
   void doFit(std::array<float,3> &correctedOutput, const int nbx) const;
 
-  void setPulseShapeTemplate  (const HcalPulseShapes::Shape& ps,const HcalTimeSlew * hcalTimeSlewDelay);
-  void resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps);
+  void setPulseShapeTemplate  (int pulseShapeId, const HcalPulseShapes& ps, const HcalTimeSlew * hcalTimeSlewDelay);
+  void resetPulseShapeTemplate(int pulseShapeId, const HcalPulseShapes& ps);
 
   typedef BXVector::Index Index;
-  const HcalPulseShapes::Shape* currentPulseShape_=nullptr;
+  int currentPulseShapeId_=-1;
   const HcalTimeSlew* hcalTimeSlewDelay_=nullptr;
 
  private:
@@ -159,6 +188,23 @@ class MahiFit
   void nnls() const;
   void resetWorkspace() const;
 
+  // fills the workspace with the samples and noise of the channel,
+  // returns whether the channel is above the fit threshold
+  bool setupChannel(const HBHEChannelInfo& channelData) const;
+  // sets up the pulses of the fit with nbx BXs (see doFit)
+  void setupFit(const int nbx) const;
+  void storeFitResult(std::array<float,3> &correctedOutput, double chiSq) const;
+  void nnlsSolve() const;
+
+  // batched fits
+  void fitBatch(const HBHEChannelInfo* channels, const HcalPulseShapes& pulseShapes,
+		const HcalTimeSlew* hcalTimeSlewDelay, const std::vector<unsigned int>& indices, const int nbx,
+		std::vector<std::array<float,3> >& correctedOutputs);
+  void loadLane(Block& b, unsigned int lane) const;
+  // sets the workspace from the fitted lane, as storeFitResult needs it
+  void unloadLane(const Block& b, unsigned int lane) const;
+  void minimizeBlock(Block& b) const;
+
   void nnlsUnconstrainParameter(Index idxp) const;
   void nnlsConstrainParameter(Index minratioidx) const;
 
@@ -202,8 +248,21 @@ class MahiFit
 
   //for pulse shapes
   int cntsetPulseShape_;
-  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
-  std::unique_ptr<ROOT::Math::Functor> pfunctor_;
+
+  // the functor of each pulse shape id, and the pulses it computed for each
+  // arrival time and time constraint, so that they are not recomputed when
+  // switching between shapes or for pulses arriving at the same time (no
+  // time slew, below 1 fC, or in the saturated range of the time slew)
+  struct PulseShapeTemplate {
+    std::unique_ptr<FitterFuncs::PulseShapeFunctor> psf;
+    std::unique_ptr<ROOT::Math::Functor> functor;
+    std::map<std::pair<float,double>, std::array<std::array<double,MaxSVSize>,3> > pulses;
+  };
+  std::map<int, PulseShapeTemplate> pulseShapeTemplates_;
+  PulseShapeTemplate* psTemplate_=nullptr;
+  static constexpr unsigned int maxCachedPulses_ = 4096;
+
+  std::unique_ptr<Block> block_;
 
 }; 
 #endif
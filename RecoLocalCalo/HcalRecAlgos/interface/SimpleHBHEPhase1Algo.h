@@ -61,6 +61,15 @@ public:
                                    const HcalRecoParam* params,
                                    const HcalCalibrations& calibs,
                                    bool isRealData) override;
+
+    // With Mahi, the fits of all the channels are done together
+    void reconstructBatch(const HBHEChannelInfo* infos,
+                          const HcalRecoParam* const* params,
+                          const HcalCalibrations* const* calibs,
+                          unsigned n,
+                          bool isRealData,
+                          HBHERecHit* rechits) override;
+
     // Basic accessors
     inline int getFirstSampleShift() const {return firstSampleShift_;}
     inline int getSamplesToAdd() const {return samplesToAdd_;}
@@ -90,6 +99,14 @@ protected:
                  const HcalCalibrations& calibs,
                  int nSamplesToExamine) const;
 private:
+    // Rechit reconstruction. If "mahiResult" is not null, it is
+    // used instead of running Mahi for this channel.
+    HBHERecHit reconstructChannel(const HBHEChannelInfo& info,
+                                  const HcalRecoParam* params,
+                                  const HcalCalibrations& calibs,
+                                  bool isRealData,
+                                  const MahiFitResult* mahiResult);
+
     HcalPulseContainmentManager pulseCorr_;
 
     int firstSampleShift_;
@@ -109,6 +126,9 @@ private:
     std::unique_ptr<MahiFit> mahiOOTpuCorr_;
 
     HcalPulseShapes theHcalPulseShapes_;
+
+    // Buffer for the batch reconstruction
+    std::vector<MahiFitResult> batchMahiResults_;
 };
 
 #endif // RecoLocalCalo_HcalRecAlgos_SimpleHBHEPhase1Algo_h_
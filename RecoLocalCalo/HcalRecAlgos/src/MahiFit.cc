@@ -1,11 +1,15 @@
 #include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h" 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <algorithm>
+
 MahiFit::MahiFit() :
   fullTSSize_(19), 
   fullTSofInterest_(8)
 {}
 
+MahiFit::~MahiFit() {}
+
 void MahiFit::setParameters(bool iDynamicPed, double iTS4Thresh, double chiSqSwitch, 
 			    bool iApplyTimeSlew, HcalTimeSlew::BiasSetting slewFlavor,
 			    double iMeanTime, double iTimeSigmaHPD, double iTimeSigmaSiPM, 
@@ -47,6 +51,39 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
 
   resetWorkspace();
 
+  std::array<float,3> reconstructedVals {{ 0.0, -9999, -9999 }};
+
+  if(setupChannel(channelData)) {
+
+    useTriple=false;
+
+    // only do pre-fit with 1 pulse if chiSq threshold is positive
+    if (chiSqSwitch_>0) {
+      doFit(reconstructedVals,1);
+      if (reconstructedVals[2]>chiSqSwitch_) {
+	doFit(reconstructedVals,0); //nbx=0 means use configured BXs
+	useTriple=true;
+      }
+    }
+    else {
+      doFit(reconstructedVals,0);
+      useTriple=true;
+    }
+  }
+  else{
+    reconstructedVals.at(0) = 0.; //energy
+    reconstructedVals.at(1) = -9999.; //time
+    reconstructedVals.at(2) = -9999.; //chi2
+  }
+  
+  reconstructedEnergy = reconstructedVals[0]*channelData.tsGain(0);
+  reconstructedTime = reconstructedVals[1];
+  chi2 = reconstructedVals[2];
+
+}
+
+bool MahiFit::setupChannel(const HBHEChannelInfo& channelData) const {
+
   nnlsWork_.tsSize = channelData.nSamples();
   nnlsWork_.tsOffset = channelData.soi();
   nnlsWork_.fullTSOffset = fullTSofInterest_ - nnlsWork_.tsOffset;
@@ -66,8 +103,6 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
   nnlsWork_.amplitudes.resize(nnlsWork_.tsSize);
   nnlsWork_.noiseTerms.resize(nnlsWork_.tsSize);
 
-  std::array<float,3> reconstructedVals {{ 0.0, -9999, -9999 }};
-  
   double tsTOT = 0, tstrig = 0; // in GeV
   for(unsigned int iTS=0; iTS<nnlsWork_.tsSize; ++iTS){
     double charge = channelData.tsRawCharge(iTS);
@@ -96,36 +131,21 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
     }
   }
 
-  if(tstrig >= ts4Thresh_ && tsTOT > 0) {
+  return tstrig >= ts4Thresh_ && tsTOT > 0;
 
-    useTriple=false;
+}
 
-    // only do pre-fit with 1 pulse if chiSq threshold is positive
-    if (chiSqSwitch_>0) {
-      doFit(reconstructedVals,1);
-      if (reconstructedVals[2]>chiSqSwitch_) {
-	doFit(reconstructedVals,0); //nbx=0 means use configured BXs
-	useTriple=true;
-      }
-    }
-    else {
-      doFit(reconstructedVals,0);
-      useTriple=true;
-    }
-  }
-  else{
-    reconstructedVals.at(0) = 0.; //energy
-    reconstructedVals.at(1) = -9999.; //time
-    reconstructedVals.at(2) = -9999.; //chi2
-  }
-  
-  reconstructedEnergy = reconstructedVals[0]*channelData.tsGain(0);
-  reconstructedTime = reconstructedVals[1];
-  chi2 = reconstructedVals[2];
+void MahiFit::doFit(std::array<float,3> &correctedOutput, int nbx) const {
+
+  setupFit(nbx);
 
+  double chiSq = minimize(); 
+
+  storeFitResult(correctedOutput, chiSq);
+  
 }
 
-void MahiFit::doFit(std::array<float,3> &correctedOutput, int nbx) const {
+void MahiFit::setupFit(const int nbx) const {
 
   unsigned int bxSize=1;
 
@@ -187,7 +207,9 @@ void MahiFit::doFit(std::array<float,3> &correctedOutput, int nbx) const {
   nnlsWork_.aTbVec.setZero(nnlsWork_.nPulseTot);
   nnlsWork_.updateWork.setZero(nnlsWork_.nPulseTot);
 
-  double chiSq = minimize(); 
+}
+
+void MahiFit::storeFitResult(std::array<float,3> &correctedOutput, double chiSq) const {
 
   bool foundintime = false;
   unsigned int ipulseintime = 0;
@@ -260,18 +282,31 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
   nnlsWork_.pulseM.fill(0);
   nnlsWork_.pulseP.fill(0);
 
-  const double xx[4]={t0, 1.0, 0.0, 3};
-  const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
-  const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
+  const auto key = std::make_pair(t0, nnlsWork_.dt);
+  const auto cached = psTemplate_->pulses.find(key);
+  if (cached != psTemplate_->pulses.end()) {
+    nnlsWork_.pulseN = cached->second[0];
+    nnlsWork_.pulseM = cached->second[1];
+    nnlsWork_.pulseP = cached->second[2];
+  }
+  else {
+    const double xx[4]={t0, 1.0, 0.0, 3};
+    const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
+    const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
 
-  (*pfunctor_)(&xx[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseN);
+    (*psTemplate_->functor)(&xx[0]);
+    psTemplate_->psf->getPulseShape(nnlsWork_.pulseN);
 
-  (*pfunctor_)(&xxm[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseM);
+    (*psTemplate_->functor)(&xxm[0]);
+    psTemplate_->psf->getPulseShape(nnlsWork_.pulseM);
   
-  (*pfunctor_)(&xxp[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseP);
+    (*psTemplate_->functor)(&xxp[0]);
+    psTemplate_->psf->getPulseShape(nnlsWork_.pulseP);
+
+    // the arrival times with time slew are continuous: bound the memory
+    if (psTemplate_->pulses.size()>=maxCachedPulses_) psTemplate_->pulses.clear();
+    psTemplate_->pulses.emplace(key, std::array<std::array<double,MaxSVSize>,3>{{nnlsWork_.pulseN, nnlsWork_.pulseM, nnlsWork_.pulseP}});
+  }
 
   //in the 2018+ case where the sample of interest (SOI) is in TS3, add an extra offset to align 
   //with previous SOI=TS4 case assumed by psfPtr_->getPulseShape()
@@ -358,6 +393,13 @@ void MahiFit::nnls() const {
   nnlsWork_.invcovp = nnlsWork_.covDecomp.matrixL().solve(nnlsWork_.pulseMat);
   nnlsWork_.aTaMat = nnlsWork_.invcovp.transpose().lazyProduct(nnlsWork_.invcovp);
   nnlsWork_.aTbVec = nnlsWork_.invcovp.transpose().lazyProduct(nnlsWork_.covDecomp.matrixL().solve(nnlsWork_.amplitudes));
+
+  nnlsSolve();
+
+}
+
+void MahiFit::nnlsSolve() const {
+  const unsigned int npulse = nnlsWork_.nPulseTot;
   
   int iter = 0;
   Index idxwmax = 0;
@@ -460,27 +502,33 @@ double MahiFit::calculateChiSq() const {
   return (nnlsWork_.covDecomp.matrixL().solve(nnlsWork_.pulseMat*nnlsWork_.ampVec - nnlsWork_.amplitudes)).squaredNorm();
 }
 
-void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalTimeSlew* hcalTimeSlewDelay) {
+void MahiFit::setPulseShapeTemplate(int pulseShapeId, const HcalPulseShapes& ps, const HcalTimeSlew* hcalTimeSlewDelay) {
 
-  if (!(&ps == currentPulseShape_ ))
+  if (!(pulseShapeId == currentPulseShapeId_ ))
     {
 
       hcalTimeSlewDelay_ = hcalTimeSlewDelay;
       tsDelay1GeV_= hcalTimeSlewDelay->delay(1.0, slewFlavor_);
 
-      resetPulseShapeTemplate(ps);
-      currentPulseShape_ = &ps;
+      auto it = pulseShapeTemplates_.find(pulseShapeId);
+      if (it == pulseShapeTemplates_.end()) resetPulseShapeTemplate(pulseShapeId, ps);
+      else psTemplate_ = &it->second;
+      currentPulseShapeId_ = pulseShapeId;
     }
 }
 
-void MahiFit::resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps) { 
+void MahiFit::resetPulseShapeTemplate(int pulseShapeId, const HcalPulseShapes& ps) { 
   ++ cntsetPulseShape_;
 
+  PulseShapeTemplate& psTemplate = pulseShapeTemplates_[pulseShapeId];
+
   // only the pulse shape itself from PulseShapeFunctor is used for Mahi
   // the uncertainty terms calculated inside PulseShapeFunctor are used for Method 2 only
-  psfPtr_.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
-						   1,0,0,10));
-  pfunctor_ = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psfPtr_.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+  psTemplate.psf.reset(new FitterFuncs::PulseShapeFunctor(ps.getShape(pulseShapeId),false,false,false,
+							  1,0,0,10));
+  psTemplate.functor = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psTemplate.psf.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+  psTemplate.pulses.clear();
+  psTemplate_ = &psTemplate;
 
 
 }
@@ -671,3 +719,403 @@ void MahiFit::resetWorkspace() const {
 
 
 }
+
+//
+// Batched fits: the state of batchLanes channels is kept in arrays with the
+// channel (lane) as last index, so that the covariance update, the Cholesky
+// decomposition, the triangular solves and the normal equations of all the
+// channels are computed together with vector instructions. The active set
+// iterations of the NNLS differ from channel to channel and are done one
+// channel at a time with nnlsSolve. The pulses are kept in the order of the
+// BXs, the permutation of each channel made by nnlsSolve is kept aside.
+//
+namespace {
+  constexpr unsigned int L = MahiFit::batchLanes;
+}
+
+struct MahiFit::Block {
+  unsigned int tsSize;
+  unsigned int nPulse;
+  int bxOffset;
+  int maxoffset;
+  int bxs[MaxPVSize];
+
+  alignas(64) double amplitudes[MaxSVSize][L];
+  alignas(64) double noiseTerms[MaxSVSize][L];
+  alignas(64) double pedConstraint[L];
+  alignas(64) double pulseMat[MaxSVSize][MaxPVSize][L];
+  alignas(64) double pulseCov[MaxPVSize][MaxSVSize][MaxSVSize][L];
+  alignas(64) double amp[MaxPVSize][L];
+  // pulse derivatives used for the arrival time, see unloadLane
+  alignas(64) double pulseDeriv[MaxSVSize][MaxPVSize][L];
+
+  // lower triangle of the Cholesky decomposition of the covariance
+  alignas(64) double chol[MaxSVSize][MaxSVSize][L];
+  alignas(64) double lPulse[MaxPVSize][MaxSVSize][L];
+  alignas(64) double lAmplitudes[MaxSVSize][L];
+  alignas(64) double aTa[MaxPVSize][MaxPVSize][L];
+  alignas(64) double aTb[MaxPVSize][L];
+  alignas(64) double newChiSq[L];
+
+  // per channel state
+  unsigned int perm[L][MaxPVSize];
+  double chiSq[L];
+  double oldChiSq[L];
+  bool active[L];
+  bool failed[L];
+};
+
+namespace {
+
+  typedef MahiFit::Block Block;
+
+  void updateBlockCov(Block &b) {
+    const unsigned int ts = b.tsSize;
+    for (unsigned int i=0; i<ts; ++i)
+      for (unsigned int j=0; j<=i; ++j)
+        for (unsigned int l=0; l<L; ++l)
+          b.chol[i][j][l] = (i==j ? b.noiseTerms[i][l] : 0.) + b.pedConstraint[l];
+
+    // the covariance of the pedestal "pulse" is zero
+    for (unsigned int k=0; k<b.nPulse; ++k) {
+      double ampSq[L];
+      for (unsigned int l=0; l<L; ++l) ampSq[l] = b.amp[k][l]*b.amp[k][l];
+      for (unsigned int i=0; i<ts; ++i)
+        for (unsigned int j=0; j<=i; ++j)
+          for (unsigned int l=0; l<L; ++l)
+            b.chol[i][j][l] += ampSq[l]*b.pulseCov[k][i][j][l];
+    }
+  }
+
+  // same steps as the unblocked Eigen::LLT, flags the lanes with a non positive pivot
+  void cholesky(Block &b, bool (&failed)[L]) {
+    const unsigned int ts = b.tsSize;
+    for (unsigned int l=0; l<L; ++l) failed[l] = false;
+    for (unsigned int k=0; k<ts; ++k) {
+      double diag[L];
+      for (unsigned int l=0; l<L; ++l) diag[l] = b.chol[k][k][l];
+      for (unsigned int m=0; m<k; ++m)
+        for (unsigned int l=0; l<L; ++l)
+          diag[l] -= b.chol[k][m][l]*b.chol[k][m][l];
+      double invDiag[L];
+      for (unsigned int l=0; l<L; ++l) {
+        failed[l] |= !(diag[l]>0.);
+        const double d = diag[l]>0. ? std::sqrt(diag[l]) : 1.;
+        b.chol[k][k][l] = d;
+        invDiag[l] = 1./d;
+      }
+      for (unsigned int i=k+1; i<ts; ++i) {
+        double v[L];
+        for (unsigned int l=0; l<L; ++l) v[l] = b.chol[i][k][l];
+        for (unsigned int m=0; m<k; ++m)
+          for (unsigned int l=0; l<L; ++l)
+            v[l] -= b.chol[i][m][l]*b.chol[k][m][l];
+        for (unsigned int l=0; l<L; ++l) b.chol[i][k][l] = v[l]*invDiag[l];
+      }
+    }
+  }
+
+  // solves chol*out = in by forward substitution
+  void forwardSolve(const Block &b, const double (&in)[MaxSVSize][L], double (&out)[MaxSVSize][L]) {
+    for (unsigned int i=0; i<b.tsSize; ++i) {
+      double v[L];
+      for (unsigned int l=0; l<L; ++l) v[l] = in[i][l];
+      for (unsigned int m=0; m<i; ++m)
+        for (unsigned int l=0; l<L; ++l)
+          v[l] -= b.chol[i][m][l]*out[m][l];
+      for (unsigned int l=0; l<L; ++l) out[i][l] = v[l]/b.chol[i][i][l];
+    }
+  }
+
+  void normalEquations(Block &b) {
+    const unsigned int ts = b.tsSize;
+    forwardSolve(b, b.amplitudes, b.lAmplitudes);
+    for (unsigned int k=0; k<b.nPulse; ++k) {
+      double col[MaxSVSize][L];
+      for (unsigned int i=0; i<ts; ++i)
+        for (unsigned int l=0; l<L; ++l)
+          col[i][l] = b.pulseMat[i][k][l];
+      forwardSolve(b, col, b.lPulse[k]);
+    }
+    for (unsigned int k=0; k<b.nPulse; ++k) {
+      for (unsigned int m=0; m<=k; ++m) {
+        double v[L] = {};
+        for (unsigned int i=0; i<ts; ++i)
+          for (unsigned int l=0; l<L; ++l)
+            v[l] += b.lPulse[k][i][l]*b.lPulse[m][i][l];
+        for (unsigned int l=0; l<L; ++l) {
+          b.aTa[k][m][l] = v[l];
+          b.aTa[m][k][l] = v[l];
+        }
+      }
+      double v[L] = {};
+      for (unsigned int i=0; i<ts; ++i)
+        for (unsigned int l=0; l<L; ++l)
+          v[l] += b.lPulse[k][i][l]*b.lAmplitudes[i][l];
+      for (unsigned int l=0; l<L; ++l) b.aTb[k][l] = v[l];
+    }
+  }
+
+  void calculateBlockChiSq(Block &b) {
+    const unsigned int ts = b.tsSize;
+    double residuals[MaxSVSize][L];
+    for (unsigned int i=0; i<ts; ++i) {
+      double v[L] = {};
+      for (unsigned int k=0; k<b.nPulse; ++k)
+        for (unsigned int l=0; l<L; ++l)
+          v[l] += b.pulseMat[i][k][l]*b.amp[k][l];
+      for (unsigned int l=0; l<L; ++l) residuals[i][l] = v[l] - b.amplitudes[i][l];
+    }
+    double lResiduals[MaxSVSize][L];
+    forwardSolve(b, residuals, lResiduals);
+    double chiSq[L] = {};
+    for (unsigned int i=0; i<ts; ++i)
+      for (unsigned int l=0; l<L; ++l)
+        chiSq[l] += lResiduals[i][l]*lResiduals[i][l];
+    for (unsigned int l=0; l<L; ++l) b.newChiSq[l] = chiSq[l];
+  }
+
+}
+
+void MahiFit::phase1ApplyBatch(const HBHEChannelInfo* channels,
+			       const HcalPulseShapes& pulseShapes,
+			       const HcalTimeSlew* hcalTimeSlewDelay,
+			       unsigned int nChannels,
+			       MahiFitResult* results) {
+
+  if (!block_) block_ = std::make_unique<Block>();
+
+  std::vector<std::array<float,3> > reconstructedVals(nChannels, {{ 0.0, -9999, -9999 }});
+  std::vector<unsigned int> fitted;
+  fitted.reserve(nChannels);
+
+  for (unsigned int i=0; i<nChannels; ++i) {
+    assert(channels[i].nSamples()==8||channels[i].nSamples()==10);
+    resetWorkspace();
+    if (setupChannel(channels[i])) fitted.push_back(i);
+    results[i].useTriple = false;
+  }
+
+  // only do pre-fit with 1 pulse if chiSq threshold is positive
+  if (chiSqSwitch_>0) {
+    fitBatch(channels, pulseShapes, hcalTimeSlewDelay, fitted, 1, reconstructedVals);
+    std::vector<unsigned int> refitted;
+    for (unsigned int i : fitted) {
+      if (reconstructedVals[i][2]>chiSqSwitch_) refitted.push_back(i);
+    }
+    fitBatch(channels, pulseShapes, hcalTimeSlewDelay, refitted, 0, reconstructedVals); //nbx=0 means use configured BXs
+    for (unsigned int i : refitted) results[i].useTriple = true;
+  }
+  else {
+    fitBatch(channels, pulseShapes, hcalTimeSlewDelay, fitted, 0, reconstructedVals);
+    for (unsigned int i : fitted) results[i].useTriple = true;
+  }
+
+  for (unsigned int i=0; i<nChannels; ++i) {
+    results[i].energy = reconstructedVals[i][0]*channels[i].tsGain(0);
+    results[i].time = reconstructedVals[i][1];
+    results[i].chi2 = reconstructedVals[i][2];
+  }
+}
+
+void MahiFit::fitBatch(const HBHEChannelInfo* channels, const HcalPulseShapes& pulseShapes,
+		       const HcalTimeSlew* hcalTimeSlewDelay, const std::vector<unsigned int>& indices, const int nbx,
+		       std::vector<std::array<float,3> >& correctedOutputs) {
+
+  // channels with the same number of samples are fitted together
+  std::vector<unsigned int> sorted(indices);
+  std::stable_sort(sorted.begin(), sorted.end(), [channels](unsigned int i, unsigned int j) {
+      return channels[i].nSamples() < channels[j].nSamples(); });
+
+  // only done once per channel, unless its fit is redone by minimize()
+  auto setup = [&](unsigned int i) {
+    setPulseShapeTemplate(channels[i].recoShape(), pulseShapes, hcalTimeSlewDelay);
+    resetWorkspace();
+    setupChannel(channels[i]);
+    setupFit(nbx);
+  };
+
+  Block& b = *block_;
+  unsigned int channelOfLane[L];
+  for (auto first = sorted.begin(); first != sorted.end(); ) {
+    const unsigned int tsSize = channels[*first].nSamples();
+    unsigned int nLanes = 0;
+    for (; first != sorted.end() && nLanes<L && channels[*first].nSamples()==tsSize; ++first) {
+      channelOfLane[nLanes] = *first;
+      setup(*first);
+      loadLane(b, nLanes);
+      ++nLanes;
+    }
+    // the remaining lanes are left inactive, with a trivial covariance
+    for (unsigned int l=nLanes; l<L; ++l) {
+      for (unsigned int i=0; i<b.tsSize; ++i) {
+        b.amplitudes[i][l] = 0.;
+        b.noiseTerms[i][l] = 1.;
+        for (unsigned int k=0; k<b.nPulse; ++k) {
+          b.pulseMat[i][k][l] = 0.;
+          for (unsigned int j=0; j<b.tsSize; ++j) b.pulseCov[k][i][j][l] = 0.;
+        }
+      }
+      b.pedConstraint[l] = 0.;
+      for (unsigned int k=0; k<b.nPulse; ++k) b.amp[k][l] = 0.;
+      b.active[l] = false;
+      b.failed[l] = false;
+    }
+
+    minimizeBlock(b);
+
+    for (unsigned int l=0; l<nLanes; ++l) {
+      const unsigned int i = channelOfLane[l];
+      if (b.failed[l]) {
+        // the decomposition of the covariance broke down: redo the fit as phase1Apply does
+        setup(i);
+        double chiSq = minimize();
+        storeFitResult(correctedOutputs[i], chiSq);
+        continue;
+      }
+      unloadLane(b, l);
+      storeFitResult(correctedOutputs[i], b.chiSq[l]);
+    }
+  }
+}
+
+void MahiFit::loadLane(Block& b, unsigned int l) const {
+
+  const unsigned int ts = nnlsWork_.tsSize;
+  b.tsSize = ts;
+  b.nPulse = nnlsWork_.nPulseTot;
+  b.bxOffset = nnlsWork_.bxOffset;
+  b.maxoffset = nnlsWork_.maxoffset;
+
+  for (unsigned int i=0; i<ts; ++i) {
+    b.amplitudes[i][l] = nnlsWork_.amplitudes.coeff(i);
+    b.noiseTerms[i][l] = nnlsWork_.noiseTerms.coeff(i);
+  }
+  b.pedConstraint[l] = nnlsWork_.pedConstraint.coeff(0,0);
+
+  for (unsigned int k=0; k<b.nPulse; ++k) {
+    const int offset = nnlsWork_.bxs.coeff(k);
+    b.bxs[k] = offset;
+    b.amp[k][l] = nnlsWork_.ampVec.coeff(k);
+    b.perm[l][k] = k;
+    for (unsigned int i=0; i<ts; ++i) {
+      b.pulseMat[i][k][l] = nnlsWork_.pulseMat.coeff(i,k);
+      b.pulseDeriv[i][k][l] = offset==pedestalBX_ ? 0. :
+	nnlsWork_.pulseDerivArray.at(offset+nnlsWork_.bxOffset).coeff(nnlsWork_.maxoffset-offset+i);
+      for (unsigned int j=0; j<ts; ++j) {
+	b.pulseCov[k][i][j][l] = offset==pedestalBX_ ? 0. :
+	  nnlsWork_.pulseCovArray.at(offset+nnlsWork_.bxOffset).coeff(nnlsWork_.maxoffset-offset+i, nnlsWork_.maxoffset-offset+j);
+      }
+    }
+  }
+
+  b.chiSq[l] = 9999;
+  b.oldChiSq[l] = 9999;
+  b.active[l] = true;
+  b.failed[l] = false;
+}
+
+void MahiFit::unloadLane(const Block& b, unsigned int l) const {
+
+  // what storeFitResult reads, with the pulses in the order of the permutation of the lane
+  const unsigned int ts = b.tsSize;
+  const unsigned int nPulse = b.nPulse;
+  nnlsWork_.tsSize = ts;
+  nnlsWork_.nPulseTot = nPulse;
+  nnlsWork_.bxOffset = b.bxOffset;
+  nnlsWork_.maxoffset = b.maxoffset;
+
+  nnlsWork_.amplitudes.resize(ts);
+  for (unsigned int i=0; i<ts; ++i) nnlsWork_.amplitudes.coeffRef(i) = b.amplitudes[i][l];
+
+  nnlsWork_.bxs.resize(nPulse);
+  nnlsWork_.ampVec.resize(nPulse);
+  nnlsWork_.pulseMat.resize(ts, nPulse);
+  for (unsigned int k=0; k<nPulse; ++k) {
+    const unsigned int ipulse = b.perm[l][k];
+    nnlsWork_.bxs.coeffRef(k) = b.bxs[ipulse];
+    nnlsWork_.ampVec.coeffRef(k) = b.amp[ipulse][l];
+    for (unsigned int i=0; i<ts; ++i) nnlsWork_.pulseMat.coeffRef(i,k) = b.pulseMat[i][ipulse][l];
+
+    const int offset = b.bxs[k];
+    if (offset==pedestalBX_) continue;
+    FullSampleVector& pulseDeriv = nnlsWork_.pulseDerivArray.at(offset+b.bxOffset);
+    pulseDeriv.setZero(ts + b.maxoffset + b.bxOffset);
+    for (unsigned int i=0; i<ts; ++i) pulseDeriv.coeffRef(b.maxoffset-offset+i) = b.pulseDeriv[i][k][l];
+  }
+}
+
+void MahiFit::minimizeBlock(Block& b) const {
+
+  const unsigned int nPulse = b.nPulse;
+
+  for( int iter=1; iter<nMaxItersMin_ ; ++iter) {
+
+    updateBlockCov(b);
+
+    bool failed[L];
+    cholesky(b, failed);
+    for (unsigned int l=0; l<L; ++l) {
+      if (b.active[l] && failed[l]) {
+	b.active[l] = false;
+	b.failed[l] = true;
+      }
+    }
+
+    normalEquations(b);
+
+    for (unsigned int l=0; l<L; ++l) {
+      if (!b.active[l]) continue;
+
+      if (nPulse>1) {
+	// nnlsSolve works on the pulses in the order of the permutation of the lane
+	const unsigned int* perm = b.perm[l];
+	nnlsWork_.nPulseTot = nPulse;
+	nnlsWork_.tsSize = b.tsSize;
+	nnlsWork_.aTaMat.resize(nPulse, nPulse);
+	nnlsWork_.aTbVec.resize(nPulse);
+	nnlsWork_.ampVec.resize(nPulse);
+	nnlsWork_.bxs.resize(nPulse);
+	nnlsWork_.pulseMat.resize(b.tsSize, nPulse);
+	for (unsigned int k=0; k<nPulse; ++k) {
+	  for (unsigned int m=0; m<nPulse; ++m) nnlsWork_.aTaMat.coeffRef(k,m) = b.aTa[perm[k]][perm[m]][l];
+	  nnlsWork_.aTbVec.coeffRef(k) = b.aTb[perm[k]][l];
+	  nnlsWork_.ampVec.coeffRef(k) = b.amp[perm[k]][l];
+	  nnlsWork_.bxs.coeffRef(k) = b.bxs[perm[k]];
+	}
+
+	nnlsSolve();
+
+	for (unsigned int k=0; k<nPulse; ++k) {
+	  const unsigned int ipulse = std::find(b.bxs, b.bxs+nPulse, nnlsWork_.bxs.coeff(k)) - b.bxs;
+	  b.perm[l][k] = ipulse;
+	  b.amp[ipulse][l] = nnlsWork_.ampVec.coeff(k);
+	}
+      }
+      else {
+	b.amp[0][l] = std::max(0., b.aTb[0][l]/b.aTa[0][0][l]);
+      }
+    }
+
+    calculateBlockChiSq(b);
+
+    bool anyActive = false;
+    for (unsigned int l=0; l<L; ++l) {
+      if (!b.active[l]) continue;
+
+      double newChiSq = b.newChiSq[l];
+      double deltaChiSq = newChiSq - b.chiSq[l];
+
+      if (newChiSq==b.oldChiSq[l] && newChiSq<b.chiSq[l]) {
+	b.active[l] = false;
+	continue;
+      }
+      b.oldChiSq[l] = b.chiSq[l];
+      b.chiSq[l] = newChiSq;
+
+      if (std::abs(deltaChiSq)<deltaChiSqThresh_) b.active[l] = false;
+      else anyActive = true;
+    }
+    if (!anyActive) break;
+  }
+}
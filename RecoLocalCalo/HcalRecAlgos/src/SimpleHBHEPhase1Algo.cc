@@ -60,6 +60,37 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
                                              const HcalRecoParam* params,
                                              const HcalCalibrations& calibs,
                                              const bool isData)
+{
+    return reconstructChannel(info, params, calibs, isData, nullptr);
+}
+
+void SimpleHBHEPhase1Algo::reconstructBatch(const HBHEChannelInfo* infos,
+                                            const HcalRecoParam* const* params,
+                                            const HcalCalibrations* const* calibs,
+                                            const unsigned n,
+                                            const bool isData,
+                                            HBHERecHit* rechits)
+{
+    if (!mahiOOTpuCorr_)
+    {
+        AbsHBHEPhase1Algo::reconstructBatch(infos, params, calibs, n, isData, rechits);
+        return;
+    }
+
+    batchMahiResults_.resize(n);
+    mahiOOTpuCorr_->phase1ApplyBatch(infos, theHcalPulseShapes_, hcalTimeSlew_delay_,
+                                     n, batchMahiResults_.data());
+
+    for (unsigned i=0; i<n; ++i)
+        rechits[i] = reconstructChannel(infos[i], params[i], *calibs[i], isData,
+                                        &batchMahiResults_[i]);
+}
+
+HBHERecHit SimpleHBHEPhase1Algo::reconstructChannel(const HBHEChannelInfo& info,
+                                                    const HcalRecoParam* params,
+                                                    const HcalCalibrations& calibs,
+                                                    const bool isData,
+                                                    const MahiFitResult* mahiResult)
 {
     HBHERecHit rh;
 
@@ -112,8 +143,16 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
     const MahiFit* mahi = mahiOOTpuCorr_.get();
 
     if (mahi) {
-      mahiOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()),hcalTimeSlew_delay_);
-      mahi->phase1Apply(info,m4E,m4T,m4UseTriple,m4chi2);
+      if (mahiResult) {
+        m4E = mahiResult->energy;
+        m4T = mahiResult->time;
+        m4UseTriple = mahiResult->useTriple;
+        m4chi2 = mahiResult->chi2;
+      }
+      else {
+        mahiOOTpuCorr_->setPulseShapeTemplate(info.recoShape(),theHcalPulseShapes_,hcalTimeSlew_delay_);
+        mahi->phase1Apply(info,m4E,m4T,m4UseTriple,m4chi2);
+      }
       m4E *= hbminusCorrectionFactor(channelId, m4E, isData);
     }
 
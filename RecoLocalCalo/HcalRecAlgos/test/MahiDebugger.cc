@@ -245,7 +245,7 @@ void MahiDebugger::analyze(const edm::Event& iEvent, const edm::EventSetup& iSet
      const bool isRealData = true;
 
      const MahiFit* mahi = mahi_.get();
-     mahi_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(hci.recoShape()),hcalTimeSlewDelay);
+     mahi_->setPulseShapeTemplate(hci.recoShape(),theHcalPulseShapes_,hcalTimeSlewDelay);
      MahiDebugInfo mdi;
      mahi->phase1Debug(hci, mdi);
 
@@ -0,0 +1,223 @@
+// Compares MahiFit::phase1ApplyBatch with MahiFit::phase1Apply on simulated
+// HB/HE channels, and reports the time taken by both. The channels mix HPD
+// (10 samples) and SiPM (8 samples) readouts, channels below threshold or
+// without charge, and channels without any noise term, for which the batch
+// decomposition of the covariance breaks down and the scalar fit is redone.
+// The timing excludes the latter: without noise, the NNLS of phase1Apply
+// runs to its iteration limit, which would dominate the time of both.
+//
+// usage: testMahiFitBatch [number of events, default 1]
+
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
+#include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
+#include "DataFormats/HcalDetId/interface/HcalDetId.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+  // not a multiple of MahiFit::batchLanes, so that the last blocks are partially filled
+  constexpr unsigned int nChannels = 5003;
+
+  // defaults of HBHEMahiParameters_cfi and HBHEMethod2Parameters_cfi
+  constexpr bool dynamicPed = true;
+  constexpr double ts4Thresh = 0.0;
+  constexpr double chiSqSwitch = 15.0;
+  constexpr bool applyTimeSlew = true;
+  constexpr double meanTime = 0.;
+  constexpr double timeSigmaHPD = 5.;
+  constexpr double timeSigmaSiPM = 2.5;
+  const std::vector<int> activeBXs = {-1, 0, 1};
+  constexpr int nMaxItersMin = 500;
+  constexpr int nMaxItersNNLS = 500;
+  constexpr double deltaChiSqThresh = 1e-3;
+  constexpr double nnlsThresh = 1e-11;
+
+  // reco pulse shapes of the HPD and SiPM channels
+  constexpr int hpdShape = 105;
+  constexpr int sipmShape = 206;
+
+  enum ChannelKind { Signal, BelowThreshold, NoCharge, NoNoise, nKinds };
+  const char* const kindNames[nKinds] = {"signal", "below threshold", "no charge", "no noise"};
+
+  bool close(double a, double b, double tolerance) {
+    if (std::isnan(a) && std::isnan(b)) return true;
+    return std::abs(a-b) <= tolerance*std::max(1.,std::max(std::abs(a),std::abs(b)));
+  }
+
+  HBHEChannelInfo makeChannel(const HcalPulseShapes::Shape& shape, bool isSiPM, ChannelKind kind, std::mt19937& rng) {
+    std::uniform_int_distribution<int> iphi(1, 72);
+    std::uniform_int_distribution<int> capid(0, 3);
+    std::uniform_real_distribution<double> phase(-5., 5.);
+    std::exponential_distribution<double> signal(1./(isSiPM ? 2000. : 200.));
+    std::exponential_distribution<double> pileup(1./(isSiPM ? 100. : 10.));
+    std::normal_distribution<double> gauss;
+
+    const unsigned int nSamples = isSiPM ? 8 : 10;
+    const unsigned int soi = isSiPM ? 3 : 4;
+    const double pedestal = isSiPM ? 20. : 3.;
+    const double pedestalWidth = kind==NoNoise ? 0. : (isSiPM ? 3. : 0.8);
+    const float dFcPerADC = kind==NoNoise ? 0.f : (isSiPM ? 10.f : 2.6f);
+    const double gain = isSiPM ? 0.0015 : 0.18;
+    const double fcByPE = kind==NoNoise ? 0. : (isSiPM ? 40. : 0.3);
+
+    HBHEChannelInfo info(isSiPM, isSiPM);
+    info.setChannelInfo(HcalDetId(isSiPM ? HcalEndcap : HcalBarrel, isSiPM ? 20 : 5, iphi(rng), 1),
+                        isSiPM ? sipmShape : hpdShape, nSamples, soi, capid(rng),
+                        0., fcByPE, 0., false, false, false);
+
+    double charge[10] = {0.};
+    if (kind!=NoCharge) {
+      const double t0 = phase(rng);
+      for (int bx=-1; bx<=1; ++bx) {
+        double amplitude = bx==0 ? signal(rng) : pileup(rng);
+        if (kind==BelowThreshold && bx==0) amplitude = 0.;
+        for (unsigned int ts=0; ts<nSamples; ++ts) {
+          const double t = 25.*(int(ts)-int(soi)-bx) + t0;
+          charge[ts] += amplitude*shape.integrate(t, t+25.);
+        }
+      }
+      // a channel below threshold has a negative charge in its sample of interest
+      if (kind==BelowThreshold) charge[soi] = -2.*pedestalWidth - 1.;
+    }
+
+    for (unsigned int ts=0; ts<nSamples; ++ts) {
+      const double noise = kind==NoNoise ? 0. : pedestalWidth*gauss(rng);
+      const double q = kind==NoCharge ? pedestal : pedestal + charge[ts] + noise;
+      info.setSample(ts, uint8_t(std::min(255., std::max(0., q/dFcPerADC))), dFcPerADC, q,
+                     pedestal, pedestalWidth, gain, 0., -1.f);
+    }
+    return info;
+  }
+
+  // fits the channels with phase1Apply and with phase1ApplyBatch, returns the time taken by both
+  std::pair<double,double> fitAll(MahiFit& scalar, MahiFit& batch, const HcalPulseShapes& pulseShapes,
+                                  const HcalTimeSlew& timeSlew, const std::vector<HBHEChannelInfo>& channels,
+                                  std::vector<MahiFitResult>& scalarResults, std::vector<MahiFitResult>& batchResults) {
+    const unsigned int n = channels.size();
+    // phase1Apply does not set useTriple for the channels it does not fit
+    scalarResults.assign(n, MahiFitResult());
+    batchResults.assign(n, MahiFitResult());
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int ichannel=0; ichannel<n; ++ichannel) {
+      MahiFitResult& r = scalarResults[ichannel];
+      scalar.setPulseShapeTemplate(channels[ichannel].recoShape(), pulseShapes, &timeSlew);
+      scalar.phase1Apply(channels[ichannel], r.energy, r.time, r.useTriple, r.chi2);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    const double scalarTime = std::chrono::duration<double>(stop-start).count();
+
+    start = std::chrono::steady_clock::now();
+    batch.phase1ApplyBatch(channels.data(), pulseShapes, &timeSlew, n, batchResults.data());
+    stop = std::chrono::steady_clock::now();
+    return {scalarTime, std::chrono::duration<double>(stop-start).count()};
+  }
+}
+
+int main(int argc, char **argv) {
+  const unsigned int nEvents = argc>1 ? std::atoi(argv[1]) : 1;
+
+  HcalPulseShapes pulseShapes;
+  HcalTimeSlew timeSlew;
+  // defaults of HcalTimeSlew_cff: slow, medium and fast bias settings
+  timeSlew.addM2ParameterSet(23.960177, -3.178648, 16.00);
+  timeSlew.addM2ParameterSet(13.307784, -1.556668, 10.00);
+  timeSlew.addM2ParameterSet(9.109694, -1.075824, 6.25);
+
+  MahiFit scalar;
+  MahiFit batch;
+  for (MahiFit* mahi : {&scalar, &batch}) {
+    mahi->setParameters(dynamicPed, ts4Thresh, chiSqSwitch, applyTimeSlew, HcalTimeSlew::Medium,
+                        meanTime, timeSigmaHPD, timeSigmaSiPM, activeBXs,
+                        nMaxItersMin, nMaxItersNNLS, deltaChiSqThresh, nnlsThresh);
+  }
+
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int> readout(0, 1);
+  std::discrete_distribution<int> kindOf({90., 5., 4., 0.3});
+
+  double scalarTime = 0.;
+  double batchTime = 0.;
+  unsigned int nTimed = 0;
+  unsigned int nMismatches = 0;
+  unsigned int nOfKind[nKinds] = {0};
+  unsigned int nMismatchesOfKind[nKinds] = {0};
+  unsigned int nTriple = 0;
+
+  std::vector<HBHEChannelInfo> channels;
+  std::vector<HBHEChannelInfo> timedChannels;
+  std::vector<ChannelKind> kinds;
+  std::vector<MahiFitResult> scalarResults;
+  std::vector<MahiFitResult> batchResults;
+  for (unsigned int ievent=0; ievent<nEvents; ++ievent) {
+    channels.clear();
+    timedChannels.clear();
+    kinds.clear();
+    for (unsigned int ichannel=0; ichannel<nChannels; ++ichannel) {
+      const bool isSiPM = readout(rng);
+      const ChannelKind kind = static_cast<ChannelKind>(kindOf(rng));
+      const HcalPulseShapes::Shape& shape = pulseShapes.getShape(isSiPM ? sipmShape : hpdShape);
+      channels.push_back(makeChannel(shape, isSiPM, kind, rng));
+      if (kind!=NoNoise) timedChannels.push_back(channels.back());
+      kinds.push_back(kind);
+      ++nOfKind[kind];
+    }
+
+    const auto times = fitAll(scalar, batch, pulseShapes, timeSlew, timedChannels, scalarResults, batchResults);
+    scalarTime += times.first;
+    batchTime += times.second;
+    nTimed += timedChannels.size();
+
+    // the comparison is done with all the channels fitted together
+    fitAll(scalar, batch, pulseShapes, timeSlew, channels, scalarResults, batchResults);
+    for (unsigned int ichannel=0; ichannel<nChannels; ++ichannel) {
+      const MahiFitResult& s = scalarResults[ichannel];
+      const MahiFitResult& b = batchResults[ichannel];
+      if (s.useTriple) ++nTriple;
+      // channels which are not fitted must give exactly the defaults of phase1Apply
+      const bool fitted = s.chi2!=-9999.f;
+      const double tolerance = fitted ? 1e-4 : 0.;
+      if (s.useTriple!=b.useTriple ||
+          !close(b.energy, s.energy, tolerance) ||
+          !close(b.time, s.time, tolerance) ||
+          !close(b.chi2, s.chi2, tolerance)) {
+        if (nMismatches<10) {
+          std::cout << "channel " << ichannel << " (" << kindNames[kinds[ichannel]] << ", "
+                    << channels[ichannel].nSamples() << " samples)"
+                    << " energy " << b.energy << " / " << s.energy
+                    << " time " << b.time << " / " << s.time
+                    << " chi2 " << b.chi2 << " / " << s.chi2
+                    << " triple " << b.useTriple << " / " << s.useTriple << std::endl;
+        }
+        ++nMismatches;
+        ++nMismatchesOfKind[kinds[ichannel]];
+      }
+    }
+  }
+
+  const unsigned int nTotal = nEvents*nChannels;
+  std::cout << "fitted " << nTotal << " HB/HE channels, " << nTriple << " refitted with all the pulses" << std::endl
+            << "timed on the " << nTimed << " channels with noise:" << std::endl
+            << "phase1Apply      " << scalarTime*1e6/nTimed << " us per channel" << std::endl
+            << "phase1ApplyBatch " << batchTime*1e6/nTimed << " us per channel" << std::endl;
+  for (unsigned int kind=0; kind<nKinds; ++kind) {
+    std::cout << "  " << kindNames[kind] << ": " << nOfKind[kind] << " channels, "
+              << nMismatchesOfKind[kind] << " differ" << std::endl;
+  }
+  std::cout << nMismatches << " channels differ" << std::endl;
+
+  // the channels which are not fitted, or whose fit falls back to the scalar
+  // minimization, must agree exactly; the others within the rounding of the
+  // reordered pulses
+  if (nMismatchesOfKind[BelowThreshold]+nMismatchesOfKind[NoCharge]+nMismatchesOfKind[NoNoise] > 0) return 1;
+  return nMismatches*1000 > nTotal ? 1 : 0;
+}
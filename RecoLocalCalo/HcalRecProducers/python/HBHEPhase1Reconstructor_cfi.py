@@ -30,6 +30,10 @@ hbheprereco = cms.EDProducer(
     # store "effective" pedestal including SiPM dark current contribution
     saveEffectivePedestal = cms.bool(False),
 
+    # Reconstruct all the channels of the event together? With Mahi,
+    # the fits of several channels are then vectorized
+    batchReconstruction = cms.bool(False),
+
     # Drop zero-suppressed channels?
     dropZSmarkedPassed = cms.bool(True),
 
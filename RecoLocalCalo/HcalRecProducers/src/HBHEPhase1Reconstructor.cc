@@ -21,6 +21,7 @@
 #include <cmath>
 #include <utility>
 #include <algorithm>
+#include <vector>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -301,6 +302,7 @@ private:
     bool tsFromDB_;
     bool recoParamsFromDB_;
     bool saveEffectivePedestal_;
+    bool batchReconstruction_;
     int sipmQTSShift_;
     int sipmQNTStoSum_;
 
@@ -326,6 +328,12 @@ private:
     std::unique_ptr<HBHEPulseShapeFlagSetter> hbhePulseShapeFlagSetterQIE8_;
     std::unique_ptr<HBHEPulseShapeFlagSetter> hbhePulseShapeFlagSetterQIE11_;
 
+    // Channels waiting for the batch reconstruction
+    std::vector<HBHEChannelInfo> batchInfos_;
+    std::vector<const HcalRecoParam*> batchParams_;
+    std::vector<const HcalCalibrations*> batchCalibs_;
+    std::vector<HBHERecHit> batchRecHits_;
+
     // For the function below, arguments "infoColl" and/or "rechits"
     // are allowed to be null.
     template<class DataFrame, class Collection>
@@ -365,6 +373,7 @@ HBHEPhase1Reconstructor::HBHEPhase1Reconstructor(const edm::ParameterSet& conf)
       tsFromDB_(conf.getParameter<bool>("tsFromDB")),
       recoParamsFromDB_(conf.getParameter<bool>("recoParamsFromDB")),
       saveEffectivePedestal_(conf.getParameter<bool>("saveEffectivePedestal")),
+      batchReconstruction_(conf.getParameter<bool>("batchReconstruction")),
       sipmQTSShift_(conf.getParameter<int>("sipmQTSShift")),
       sipmQNTStoSum_(conf.getParameter<int>("sipmQNTStoSum")),
       setNegativeFlagsQIE8_(conf.getParameter<bool>("setNegativeFlagsQIE8")),
@@ -444,6 +453,20 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
     // not going to be constructed from such channels.
     const bool skipDroppedChannels = !(infos && saveDroppedInfos_);
 
+    // In the batch mode, the rechits are reconstructed together
+    // after all the channels have been decoded. The frames (which,
+    // for QIE11, are views returned by value) are kept to set the
+    // status bits afterwards.
+    const bool batch = rechits && batchReconstruction_;
+    std::vector<DFrame> batchFrames;
+    if (batch)
+    {
+        batchInfos_.clear();
+        batchParams_.clear();
+        batchCalibs_.clear();
+        batchFrames.reserve(coll.size());
+    }
+
     // Iterate over the input collection
     for (typename Collection::const_iterator it = coll.begin();
          it != coll.end(); ++it)
@@ -544,6 +567,14 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
             const HcalRecoParam* pptr = nullptr;
             if (recoParamsFromDB_)
                 pptr = param_ts;
+            if (batch)
+            {
+                batchInfos_.push_back(*channelInfo);
+                batchParams_.push_back(pptr);
+                batchCalibs_.push_back(&calib);
+                batchFrames.push_back(frame);
+                continue;
+            }
             HBHERecHit rh = reco_->reconstruct(*channelInfo, pptr, calib, isRealData);
             if (rh.id().rawId())
             {
@@ -553,6 +584,30 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
             }
         }
     }
+
+    if (batch)
+    {
+        const unsigned n = batchInfos_.size();
+        batchRecHits_.resize(n);
+        reco_->reconstructBatch(batchInfos_.data(), batchParams_.data(),
+                                batchCalibs_.data(), n, isRealData,
+                                batchRecHits_.data());
+        for (unsigned i=0; i<n; ++i)
+        {
+            HBHERecHit& rh(batchRecHits_[i]);
+            if (rh.id().rawId())
+            {
+                const HcalCalibrations& calib(*batchCalibs_[i]);
+                const HcalDetId cell(batchFrames[i].id());
+                const HcalQIECoder* channelCoder = cond.getHcalCoder(cell);
+                const HcalQIEShape* shape = cond.getHcalShape(channelCoder);
+                const HcalCoderDb coder(*channelCoder, *shape);
+                setAsicSpecificBits(batchFrames[i], coder, batchInfos_[i], calib, &rh);
+                setCommonStatusBits(batchInfos_[i], calib, &rh);
+                rechits->push_back(rh);
+            }
+        }
+    }
 }
 
 void HBHEPhase1Reconstructor::setCommonStatusBits(
@@ -765,6 +820,7 @@ HBHEPhase1Reconstructor::fillDescriptions(edm::ConfigurationDescriptions& descri
     desc.add<bool>("tsFromDB");
     desc.add<bool>("recoParamsFromDB");
     desc.add<bool>("saveEffectivePedestal", false);
+    desc.add<bool>("batchReconstruction", false);
     desc.add<int>("sipmQTSShift", 0);
     desc.add<int>("sipmQNTStoSum", 3);
     desc.add<bool>("setNegativeFlagsQIE8");
@@ -3,6 +3,7 @@
 
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
 #include "DataFormats/ParticleFlowReco/interface/PFBlockElement.h"
+#include "RecoParticleFlow/PFProducer/interface/PFRecHitSpatialIndex.h"
 
 #include <vector>
 
@@ -47,13 +48,18 @@ class KDTreeLinkerBase
   // With this method, we create the list of elements that we want to link.
   virtual void insertTargetElt(reco::PFBlockElement		*target) = 0;
 
-  // Here, we create the list of cluster that we want to link. From cluster
-  // and fraction, we will create a second list of rechits that will be used to
-  // build the KDTree.
-  virtual void insertFieldClusterElt(reco::PFBlockElement	*cluster) = 0;  
+  // The clusters that we want to link, and the KDTrees of their rechits, are taken
+  // from the spatial index of the field type, which is shared by all the linkers
+  // with the same field type. It is built by PFBlockAlgo before process() is called.
+  void setSpatialIndex(const PFRecHitSpatialIndex *index) {
+    spatialIndex_ = index;
+  }
 
-  // The KDTree building from rechits list.
-  virtual void buildTree() = 0;
+  // The coordinates in which the linker searches the field rechits, as a mask of
+  // (1 << PFRecHitSpatialIndex::Coordinates). By default, eta/phi.
+  virtual unsigned int spatialIndexCoordinates() const {
+    return 1 << PFRecHitSpatialIndex::EtaPhi;
+  }
 
   // Here we will iterate over all target elements. For each one, we will search the closest
   // rechits in the KDTree, from rechits we will find the associated clusters and after that
@@ -67,7 +73,7 @@ class KDTreeLinkerBase
   // Here we free all allocated structures.
   virtual void clear() = 0;
 
-  // This method calls is the good order buildTree(), searchLinks(), 
+  // This method calls is the good order searchLinks(), 
   // updatePFBlockEltWithLinks() and clear()
   virtual void process();
 
@@ -86,6 +92,9 @@ class KDTreeLinkerBase
 
   // Debug boolean. Not used until now.
   bool			debug_;
+
+  // Spatial index of the field clusters rechits.
+  const PFRecHitSpatialIndex	*spatialIndex_;
 };
 
 
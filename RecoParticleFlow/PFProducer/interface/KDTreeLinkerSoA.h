@@ -0,0 +1,63 @@
+#ifndef KDTreeLinkerSoA_h
+#define KDTreeLinkerSoA_h
+
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerTools.h"
+
+#include <vector>
+
+// KDTree of 2D points stored as flat arrays (structure of arrays), with
+// iterative range searches. Unlike KDTreeLinkerAlgo, the points carry an
+// index rather than a rechit pointer, and the tree can be searched for many
+// boxes in one call.
+class KDTreeLinkerSoA
+{
+ public:
+  KDTreeLinkerSoA() {}
+
+  // Here we build the KD tree from the points (dim1[i], dim2[i]). The
+  // searches return ids[i] for the points found.
+  void build(const std::vector<double>		&dim1,
+	     const std::vector<double>		&dim2,
+	     const std::vector<unsigned int>	&ids);
+
+  // Appends to result the ids of all the points contained in the box,
+  // bounds included. The ids come in the order of the tree.
+  void search(const KDTreeBox			&searchBox,
+	      std::vector<unsigned int>		&result) const;
+
+  // Batch search: the ids of the points in searchBoxes[i] are
+  // result[offsets[i]] ... result[offsets[i+1]-1].
+  void search(const std::vector<KDTreeBox>	&searchBoxes,
+	      std::vector<unsigned int>		&offsets,
+	      std::vector<unsigned int>		&result) const;
+
+  bool empty() const { return ids_.empty(); }
+
+  // This method clears all allocated structures.
+  void clear();
+
+ private:
+  // Maximal number of points in a leaf.
+  static constexpr unsigned int leafSize_ = 8;
+
+  // Recursive builder of the nodes of the points [begin,end) of order_.
+  void recBuild(std::vector<unsigned int>	&order,
+		const std::vector<double>	&dim1,
+		const std::vector<double>	&dim2,
+		unsigned int			begin,
+		unsigned int			end,
+		int				depth);
+
+  // The points, in the order of the tree.
+  std::vector<double>		dim1_;
+  std::vector<double>		dim2_;
+  std::vector<unsigned int>	ids_;
+
+  // The nodes, in depth-first order: the left son of node n is n+1 and
+  // right_[n] is its right son, or 0 for a leaf. The node n holds the
+  // points [begin_[n], end_[n]), whose bounding box is given by min/max.
+  std::vector<double>		min1_, max1_, min2_, max2_;
+  std::vector<unsigned int>	begin_, end_, right_;
+};
+
+#endif /* !KDTreeLinkerSoA_h */
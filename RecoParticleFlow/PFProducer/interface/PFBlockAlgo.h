@@ -1,6 +1,7 @@
 #ifndef RecoParticleFlow_PFProducer_PFBlockAlgo_h
 #define RecoParticleFlow_PFProducer_PFBlockAlgo_h 
 
+#include <array>
 #include <set>
 #include <vector>
 #include <iostream>
@@ -32,6 +33,7 @@
 // Glowinski & Gouzevitch
 #include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"             
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h" 
+#include "RecoParticleFlow/PFProducer/interface/PFRecHitSpatialIndex.h"
 // !Glowinski & Gouzevitch
 
 // #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
@@ -96,6 +98,7 @@ class PFBlockAlgo {
   typedef std::unique_ptr<BlockElementImporterBase> ImporterPtr;
   typedef std::unique_ptr<BlockElementLinkerBase> LinkTestPtr;  
   typedef std::unique_ptr<KDTreeLinkerBase> KDTreePtr;
+  typedef std::unique_ptr<PFRecHitSpatialIndex> SpatialIndexPtr;
   /// define these in *Fwd files in DataFormats/ParticleFlowReco?
   typedef ElementList::iterator IE;
   typedef ElementList::const_iterator IEC;  
@@ -173,6 +176,8 @@ class PFBlockAlgo {
   unsigned int linkTestSquare_[reco::PFBlockElement::kNBETypes][reco::PFBlockElement::kNBETypes];
   
   std::vector<KDTreePtr> kdtrees_;
+  // rechit spatial indices of the KDTree field types, shared by the linkers
+  std::array<SpatialIndexPtr,reco::PFBlockElement::kNBETypes> spatialIndices_;
 };
 
 #include "DataFormats/ParticleFlowReco/interface/PFBlockElementGsfTrack.h"
@@ -0,0 +1,89 @@
+#ifndef RecoParticleFlow_PFProducer_PFRecHitSpatialIndex_h
+#define RecoParticleFlow_PFProducer_PFRecHitSpatialIndex_h
+
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockElement.h"
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerSoA.h"
+
+#include <algorithm>
+#include <vector>
+
+// Spatial index of the rechits of the cluster elements of one type (ECAL,
+// HCAL,...) of an event. It is filled and built once per event by PFBlockAlgo
+// and shared by all the KDTree linkers whose field is of this type, which
+// only query it.
+class PFRecHitSpatialIndex
+{
+ public:
+  // The coordinates in which the rechits can be searched.
+  enum Coordinates {
+    // eta/phi of all the rechits. Rechits close to phi = +-Pi are duplicated
+    // with phi -+ 2Pi, so that the boxes may extend over Pi by phiOffset.
+    EtaPhi = 0,
+    // x/y of the rechits of the endcap layers, on each side.
+    XYNeg = 1,
+    XYPos = 2,
+    kNCoordinates = 3
+  };
+
+  PFRecHitSpatialIndex();
+
+  // Request the trees which must be built, as a mask of (1 << Coordinates).
+  void requestCoordinates(unsigned int mask) { requested_ |= mask; }
+
+  // Phi range added on each side of [-Pi,Pi] in the EtaPhi coordinates.
+  void setPhiOffset(double phiOffset) { phiOffset_ = std::max(phiOffset_, phiOffset); }
+
+  // Adds the rechits of the cluster, with fraction above 1E-4.
+  void insertClusterElt(reco::PFBlockElement	*cluster);
+
+  // Builds the rechit to cluster associations and the requested trees.
+  void build();
+
+  // Here we free all allocated structures, before the next event.
+  void clear();
+
+  // All the cluster elements of the index.
+  const std::vector<reco::PFBlockElement*>& clusterElts() const { return clusters_; }
+
+  unsigned int nRecHits() const { return rechits_.size(); }
+  const reco::PFRecHit* recHit(unsigned int i) const { return rechits_[i]; }
+
+  // The cluster elements containing the rechit i, ordered as in a BlockEltSet.
+  reco::PFBlockElement* const * clustersBegin(unsigned int i) const { return rechitClusters_.data() + rechitOffsets_[i]; }
+  reco::PFBlockElement* const * clustersEnd(unsigned int i) const { return rechitClusters_.data() + rechitOffsets_[i+1]; }
+
+  // Appends to result the indices of the rechits in the box.
+  void search(Coordinates			coordinates,
+	      const KDTreeBox			&searchBox,
+	      std::vector<unsigned int>		&result) const {
+    trees_[coordinates].search(searchBox, result);
+  }
+
+  // Batch search: the indices of the rechits in searchBoxes[i] are
+  // result[offsets[i]] ... result[offsets[i+1]-1].
+  void search(Coordinates			coordinates,
+	      const std::vector<KDTreeBox>	&searchBoxes,
+	      std::vector<unsigned int>		&offsets,
+	      std::vector<unsigned int>		&result) const {
+    trees_[coordinates].search(searchBoxes, offsets, result);
+  }
+
+ private:
+  unsigned int requested_;
+  double phiOffset_;
+
+  std::vector<reco::PFBlockElement*> clusters_;
+
+  // (rechit, cluster) pairs, as inserted
+  std::vector<std::pair<const reco::PFRecHit*, reco::PFBlockElement*> > links_;
+
+  // The rechits, and their clusters in rechitClusters_[rechitOffsets_[i]] ...
+  std::vector<const reco::PFRecHit*> rechits_;
+  std::vector<unsigned int> rechitOffsets_;
+  std::vector<reco::PFBlockElement*> rechitClusters_;
+
+  KDTreeLinkerSoA trees_[kNCoordinates];
+};
+
+#endif /* !RecoParticleFlow_PFProducer_PFRecHitSpatialIndex_h */
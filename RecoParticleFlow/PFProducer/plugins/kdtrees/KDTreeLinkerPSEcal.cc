@@ -33,76 +33,13 @@ KDTreeLinkerPSEcal::insertTargetElt(reco::PFBlockElement	*psCluster)
 }
 
 
-void
-KDTreeLinkerPSEcal::insertFieldClusterElt(reco::PFBlockElement	*ecalCluster)
-{
-  const reco::PFClusterRef& clusterref = ecalCluster->clusterRef();
-
-  if (clusterref->layer() != PFLayer::ECAL_ENDCAP)
-    return;
-	  
-  const std::vector<reco::PFRecHitFraction> &fraction = clusterref->recHitFractions();
-
-  // We create a list of cluster
-  fieldClusterSet_.insert(ecalCluster);
-
-  double clusterz = clusterref->position().Z();
-  RecHitSet& rechitsSet = (clusterz < 0) ? rechitsNegSet_ : rechitsPosSet_;
-
-  for(size_t rhit = 0; rhit < fraction.size(); ++rhit) {
-    const reco::PFRecHitRef& rh = fraction[rhit].recHitRef();
-    double fract = fraction[rhit].fraction();
-
-    if ((rh.isNull()) || (fract < 1E-4))
-      continue;
-      
-    const reco::PFRecHit& rechit = *rh;
-      
-    // We save the links rechit to Clusters
-    rechit2ClusterLinks_[&rechit].insert(ecalCluster);
-    
-    // We create a liste of rechits
-    rechitsSet.insert(&rechit);
-  }
-}
-
-void 
-KDTreeLinkerPSEcal::buildTree()
-{
-  buildTree(rechitsNegSet_, treeNeg_);
-  buildTree(rechitsPosSet_, treePos_);
-}
-
-void 
-KDTreeLinkerPSEcal::buildTree(const RecHitSet	&rechitsSet,
-			      KDTreeLinkerAlgo	&tree)
-{
-  // List of pseudo-rechits that will be used to create the KDTree
-  std::vector<KDTreeNodeInfo> eltList;
-
-  // Filling of this eltList
-  for(RecHitSet::const_iterator it = rechitsSet.begin(); 
-      it != rechitsSet.end(); it++) {
-
-    const reco::PFRecHit* rh = *it;
-    const auto & posxyz = rh->position();
-        
-    KDTreeNodeInfo rhinfo (rh, posxyz.x(), posxyz.y());
-    eltList.push_back(rhinfo);
-  }
-
-  // xmin-xmax, ymain-ymax
-  KDTreeBox region(-150., 150., -150., 150.);
-
-  // We may now build the KDTree
-  tree.build(eltList, region);
-}
-
 void
 KDTreeLinkerPSEcal::searchLinks()
 {
   // Must of the code has been taken from LinkByRecHit.cc
 
+  std::vector<unsigned int> recHits;
+
   // We iterate over the PS clusters.
   for(BlockEltSet::iterator it = targetSet_.begin(); 
       it != targetSet_.end(); it++) {
@@ -154,31 +91,30 @@ KDTreeLinkerPSEcal::searchLinks()
     double rangeY = maxEcalRadius * (1 + (0.05 + 1.0 / maxEcalRadius * deltaY / 2.)) * inflation; 
     
     // We search for all candidate recHits, ie all recHits contained in the maximal size envelope.
-    std::vector<KDTreeNodeInfo> recHits;
     KDTreeBox trackBox(xPSonEcal - rangeX, xPSonEcal + rangeX, 
 		  yPSonEcal - rangeY, yPSonEcal + rangeY);
 
-    if (zPS < 0)
-      treeNeg_.search(trackBox, recHits);
-    else
-      treePos_.search(trackBox, recHits);
-
+    recHits.clear();
+    spatialIndex_->search(zPS < 0 ? PFRecHitSpatialIndex::XYNeg : PFRecHitSpatialIndex::XYPos,
+			  trackBox, recHits);
 
-    for(std::vector<KDTreeNodeInfo>::const_iterator rhit = recHits.begin(); 
+    for(std::vector<unsigned int>::const_iterator rhit = recHits.begin(); 
 	rhit != recHits.end(); ++rhit) {
            
-      const auto & corners = rhit->ptr->getCornersXYZ();
+      const reco::PFRecHit *rechit = spatialIndex_->recHit(*rhit);
+      const auto & corners = rechit->getCornersXYZ();
 
       // Find all clusters associated to given rechit
-      RecHit2BlockEltMap::iterator ret = rechit2ClusterLinks_.find(rhit->ptr);
-      
-      for(BlockEltSet::const_iterator clusterIt = ret->second.begin(); 
-	  clusterIt != ret->second.end(); clusterIt++) {
+      for(auto clusterIt = spatialIndex_->clustersBegin(*rhit); 
+	  clusterIt != spatialIndex_->clustersEnd(*rhit); clusterIt++) {
 	
 	reco::PFClusterRef clusterref = (*clusterIt)->clusterRef();
+	if (clusterref->layer() != PFLayer::ECAL_ENDCAP)
+	  continue;
+
 	double clusterz = clusterref->position().z();
 
-	const auto & posxyz = rhit->ptr->position() * zPS / clusterz;
+	const auto & posxyz = rechit->position() * zPS / clusterz;
 
 	double x[5];
 	double y[5];
@@ -231,14 +167,6 @@ void
 KDTreeLinkerPSEcal::clear()
 {
   targetSet_.clear();
-  fieldClusterSet_.clear();
 
-  rechitsNegSet_.clear();
-  rechitsPosSet_.clear();
-
-  rechit2ClusterLinks_.clear();
   target2ClusterLinks_.clear();
-
-  treeNeg_.clear();
-  treePos_.clear();
 }
@@ -3,7 +3,6 @@
 
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerTools.h"
-#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerAlgo.h"
 
 
 // This class is used to find all links between PreShower clusters and ECAL clusters
@@ -18,14 +17,6 @@ class KDTreeLinkerPSEcal : public KDTreeLinkerBase
   // With this method, we create the list of psCluster that we want to link.
   void insertTargetElt(reco::PFBlockElement		*psCluster) override;
 
-  // Here, we create the list of ecalCluster that we want to link. From ecalCluster
-  // and fraction, we will create a second list of rechits that will be used to
-  // build the KDTree.
-  void insertFieldClusterElt(reco::PFBlockElement	*ecalCluster) override;  
-
-  // The KDTree building from rechits list.
-  void buildTree() override;
-  
   // Here we will iterate over all psCluster. For each one, we will search the closest
   // rechits in the KDTree, from rechits we will find the ecalClusters and after that
   // we will check the links between the psCluster and all closest ecalClusters.
@@ -37,12 +28,12 @@ class KDTreeLinkerPSEcal : public KDTreeLinkerBase
   
   // Here we free all allocated structures.
   void clear() override;
-  
 
- private:
-  // This method allows us to build the "tree" from the "rechitsSet".
-  void buildTree(const RecHitSet	&rechitsSet,
-		   KDTreeLinkerAlgo	&tree);
+  // The ECAL rechits are searched in x/y.
+  unsigned int spatialIndexCoordinates() const override {
+    return (1 << PFRecHitSpatialIndex::XYNeg) | (1 << PFRecHitSpatialIndex::XYPos);
+  }
+  
 
  private:
   // Some const values. 
@@ -51,24 +42,13 @@ class KDTreeLinkerPSEcal : public KDTreeLinkerBase
   const double	ps1ToEcal_; // ratio : zEcal / zPS1
   const double	ps2ToEcal_; // ration : zEcal / zPS2
 
-  // Data used by the KDTree algorithm : sets of PS and ECAL clusters.
+  // Data used by the KDTree algorithm : set of PS clusters. The ECAL
+  // clusters and their rechits, in x/y on each side of the endcap, come
+  // from the spatial index.
   BlockEltSet		targetSet_;
-  BlockEltSet		fieldClusterSet_;
-
-  // Sets of rechits that compose the ECAL clusters. We differenctiate 
-  // the rechits by their Z value.
-  RecHitSet		rechitsNegSet_;
-  RecHitSet		rechitsPosSet_;
   
   // Map of linked PS/ECAL clusters.
   BlockElt2BlockEltMap	target2ClusterLinks_;
-
-  // Map of the ECAL clusters associated to a rechit.
-  RecHit2BlockEltMap	rechit2ClusterLinks_;
-    
-  // KD trees
-  KDTreeLinkerAlgo	treeNeg_;
-  KDTreeLinkerAlgo	treePos_;
 };
 
 #endif /* !KDTreeLinkerPSEcal_h */
@@ -9,6 +9,14 @@ DEFINE_EDM_PLUGIN(KDTreeLinkerFactory,
 		  KDTreeLinkerTrackEcal, 
 		  "KDTreeTrackAndECALLinker"); 
 
+namespace {
+  // Track quantities at ECAL shower max, used by the search and by the link checks.
+  struct TrackAtEcal {
+    reco::PFBlockElement *elt;
+    double pt, eta, phi, x, y, z;
+  };
+}
+
 
 KDTreeLinkerTrackEcal::KDTreeLinkerTrackEcal()
   : KDTreeLinkerBase()
@@ -28,84 +36,18 @@ KDTreeLinkerTrackEcal::insertTargetElt(reco::PFBlockElement	*track)
 }
 
 
-void
-KDTreeLinkerTrackEcal::insertFieldClusterElt(reco::PFBlockElement	*ecalCluster)
-{
-  const reco::PFClusterRef& clusterref = ecalCluster->clusterRef();
-
-  // This test is more or less done in PFBlockAlgo.h. In others cases, it should be switch on.
-  //   if (!((clusterref->layer() == PFLayer::ECAL_ENDCAP) ||
-  // 	(clusterref->layer() == PFLayer::ECAL_BARREL)))
-  //     return;
-
-  const std::vector<reco::PFRecHitFraction> &fraction = clusterref->recHitFractions();
-
-  // We create a list of ecalCluster
-  fieldClusterSet_.insert(ecalCluster);
-  for(size_t rhit = 0; rhit < fraction.size(); ++rhit) {
-    const reco::PFRecHitRef& rh = fraction[rhit].recHitRef();
-    double fract = fraction[rhit].fraction();
-
-    if ((rh.isNull()) || (fract < 1E-4))
-      continue;
-      
-    const reco::PFRecHit& rechit = *rh;
-      
-    // We save the links rechit to EcalClusters
-    rechit2ClusterLinks_[&rechit].insert(ecalCluster);
-    
-    // We create a liste of rechits
-    rechitsSet_.insert(&rechit);
-  }
-}
-
-void 
-KDTreeLinkerTrackEcal::buildTree()
-{
-  // List of pseudo-rechits that will be used to create the KDTree
-  std::vector<KDTreeNodeInfo> eltList;
-
-  // Filling of this list
-  for(RecHitSet::const_iterator it = rechitsSet_.begin(); 
-      it != rechitsSet_.end(); it++) {
-    
-    const reco::PFRecHit::REPPoint &posrep = (*it)->positionREP();
-    
-    KDTreeNodeInfo rh1 (*it, posrep.eta(), posrep.phi());
-    eltList.push_back(rh1);
-    
-    // Here we solve the problem of phi circular set by duplicating some rechits
-    // too close to -Pi (or to Pi) and adding (substracting) to them 2 * Pi.
-    if (rh1.dim2 > (M_PI - getPhiOffset())) {
-      double phi = rh1.dim2 - 2 * M_PI;
-      KDTreeNodeInfo rh2(*it, posrep.eta(), phi); 
-      eltList.push_back(rh2);
-    }
-
-    if (rh1.dim2 < (M_PI * -1.0 + getPhiOffset())) {
-      double phi = rh1.dim2 + 2 * M_PI;
-      KDTreeNodeInfo rh3(*it, posrep.eta(), phi); 
-      eltList.push_back(rh3);
-    }
-  }
-
-  // Here we define the upper/lower bounds of the 2D space (eta/phi).
-  double phimin = -1.0 * M_PI - getPhiOffset();
-  double phimax = M_PI + getPhiOffset();
-
-  // etamin-etamax, phimin-phimax
-  KDTreeBox region(-3.0, 3.0, phimin, phimax);
-
-  // We may now build the KDTree
-  tree_.build(eltList, region);
-}
-
 void
 KDTreeLinkerTrackEcal::searchLinks()
 {
   // Must of the code has been taken from LinkByRecHit.cc
 
-  // We iterate over the tracks.
+  // We iterate over the tracks, to find the envelopes in which the rechit
+  // candidates are searched all at once. The track quantities at ECAL are
+  // kept for the link checks.
+  std::vector<TrackAtEcal> tracks;
+  std::vector<KDTreeBox> trackBoxes;
+  tracks.reserve(targetSet_.size());
+  trackBoxes.reserve(targetSet_.size());
   for(BlockEltSet::iterator it = targetSet_.begin(); 
       it != targetSet_.end(); it++) {
 	
@@ -124,30 +66,46 @@ KDTreeLinkerTrackEcal::searchLinks()
     const reco::PFTrajectoryPoint& atVertex = 
       trackref->extrapolatedPoint( reco::PFTrajectoryPoint::ClosestApproach );
     
-    double trackPt = sqrt(atVertex.momentum().Vect().Perp2());
-    double tracketa = atECAL.positionREP().eta();
-    double trackphi = atECAL.positionREP().phi();
-    double trackx = atECAL.position().X();
-    double tracky = atECAL.position().Y();
-    double trackz = atECAL.position().Z();
+    TrackAtEcal track;
+    track.elt = *it;
+    track.pt = sqrt(atVertex.momentum().Vect().Perp2());
+    track.eta = atECAL.positionREP().eta();
+    track.phi = atECAL.positionREP().phi();
+    track.x = atECAL.position().X();
+    track.y = atECAL.position().Y();
+    track.z = atECAL.position().Z();
     
     // Estimate the maximal envelope in phi/eta that will be used to find rechit candidates.
     // Same envelope for cap et barrel rechits.
-    double range = getCristalPhiEtaMaxSize() * (2.0 + 1.0 / std::min(1., trackPt / 2.)); 
+    double range = getCristalPhiEtaMaxSize() * (2.0 + 1.0 / std::min(1., track.pt / 2.)); 
+
+    tracks.push_back(track);
+    trackBoxes.emplace_back(track.eta-range, track.eta+range, track.phi-range, track.phi+range);
+  }
+
+  // We search for all candidate recHits, ie all recHits contained in the maximal size envelope.
+  std::vector<unsigned int> offsets;
+  std::vector<unsigned int> recHits;
+  spatialIndex_->search(PFRecHitSpatialIndex::EtaPhi, trackBoxes, offsets, recHits);
 
-    // We search for all candidate recHits, ie all recHits contained in the maximal size envelope.
-    std::vector<KDTreeNodeInfo> recHits;
-    KDTreeBox trackBox(tracketa-range, tracketa+range, trackphi-range, trackphi+range);
-    tree_.search(trackBox, recHits);
+  for(unsigned int itrack = 0; itrack < tracks.size(); ++itrack) {
+
+    reco::PFBlockElement *track = tracks[itrack].elt;
+    const double trackPt = tracks[itrack].pt;
+    const double tracketa = tracks[itrack].eta;
+    const double trackphi = tracks[itrack].phi;
+    const double trackx = tracks[itrack].x;
+    const double tracky = tracks[itrack].y;
+    const double trackz = tracks[itrack].z;
     
     // Here we check all rechit candidates using the non-approximated method.
-    for(std::vector<KDTreeNodeInfo>::const_iterator rhit = recHits.begin(); 
-	rhit != recHits.end(); ++rhit) {
+    for(unsigned int irh = offsets[itrack]; irh < offsets[itrack+1]; ++irh) {
            
-      const auto & cornersxyz      = rhit->ptr->getCornersXYZ();
-      const auto & posxyz			   = rhit->ptr->position();
-      const auto &rhrep		   = rhit->ptr->positionREP();
-      const auto & corners = rhit->ptr->getCornersREP();
+      const reco::PFRecHit *rechit = spatialIndex_->recHit(recHits[irh]);
+      const auto & cornersxyz      = rechit->getCornersXYZ();
+      const auto & posxyz			   = rechit->position();
+      const auto &rhrep		   = rechit->positionREP();
+      const auto & corners = rechit->getCornersREP();
       
       double rhsizeeta = fabs(corners[3].eta() - corners[1].eta());
       double rhsizephi = fabs(corners[3].phi() - corners[1].phi());
@@ -158,10 +116,8 @@ KDTreeLinkerTrackEcal::searchLinks()
       if ( dphi > M_PI ) dphi = 2.*M_PI - dphi;
       
       // Find all clusters associated to given rechit
-      RecHit2BlockEltMap::iterator ret = rechit2ClusterLinks_.find(rhit->ptr);
-      
-      for(BlockEltSet::const_iterator clusterIt = ret->second.begin(); 
-	  clusterIt != ret->second.end(); clusterIt++) {
+      for(auto clusterIt = spatialIndex_->clustersBegin(recHits[irh]); 
+	  clusterIt != spatialIndex_->clustersEnd(recHits[irh]); clusterIt++) {
 	
 	reco::PFClusterRef clusterref = (*clusterIt)->clusterRef();
 	double clusterz = clusterref->position().z();
@@ -176,7 +132,7 @@ KDTreeLinkerTrackEcal::searchLinks()
 	  
 	  // Check if the track and the cluster are linked
 	  if(deta < (_rhsizeeta / 2.) && dphi < (_rhsizephi / 2.))
-	    target2ClusterLinks_[*it].insert(*clusterIt);
+	    target2ClusterLinks_[track].insert(*clusterIt);
 
 	  
 	} else { // ENDCAP
@@ -204,7 +160,7 @@ KDTreeLinkerTrackEcal::searchLinks()
 	  
 	  // Check if the track and the cluster are linked
 	  if( isinside )
-	    target2ClusterLinks_[*it].insert(*clusterIt);
+	    target2ClusterLinks_[track].insert(*clusterIt);
 	}
       }
     }
@@ -238,12 +194,6 @@ void
 KDTreeLinkerTrackEcal::clear()
 {
   targetSet_.clear();
-  fieldClusterSet_.clear();
 
-  rechitsSet_.clear();
-
-  rechit2ClusterLinks_.clear();
   target2ClusterLinks_.clear();
-
-  tree_.clear();
 }
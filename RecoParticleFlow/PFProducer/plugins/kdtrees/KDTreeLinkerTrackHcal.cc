@@ -9,6 +9,14 @@ DEFINE_EDM_PLUGIN(KDTreeLinkerFactory,
 		  KDTreeLinkerTrackHcal, 
 		  "KDTreeTrackAndHCALLinker"); 
 
+namespace {
+  // Track quantities at HCAL, used by the search and by the link checks.
+  struct TrackAtHcal {
+    reco::PFBlockElement *elt;
+    double eta, phi, dHeta, dHphi;
+  };
+}
+
 
 KDTreeLinkerTrackHcal::KDTreeLinkerTrackHcal()
   : KDTreeLinkerBase()
@@ -31,84 +39,18 @@ KDTreeLinkerTrackHcal::insertTargetElt(reco::PFBlockElement	*track)
 }
 
 
-void
-KDTreeLinkerTrackHcal::insertFieldClusterElt(reco::PFBlockElement	*hcalCluster)
-{
-  const reco::PFClusterRef& clusterref = hcalCluster->clusterRef();
-
-  // This test is more or less done in PFBlockAlgo.h. In others cases, it should be switch on.
-  //   if (!((clusterref->layer() == PFLayer::HCAL_ENDCAP) ||
-  // 	(clusterref->layer() == PFLayer::HCAL_BARREL1)))
-  //     return;
-
-  const std::vector<reco::PFRecHitFraction> &fraction = clusterref->recHitFractions();
-
-  // We create a list of hcalCluster
-  fieldClusterSet_.insert(hcalCluster);
-  for(size_t rhit = 0; rhit < fraction.size(); ++rhit) {
-    const reco::PFRecHitRef& rh = fraction[rhit].recHitRef();
-    double fract = fraction[rhit].fraction();
-
-    if ((rh.isNull()) || (fract < 1E-4))
-      continue;
-      
-    const reco::PFRecHit& rechit = *rh;
-      
-    // We save the links rechit to HcalClusters
-    rechit2ClusterLinks_[&rechit].insert(hcalCluster);
-    
-    // We create a liste of rechits
-    rechitsSet_.insert(&rechit);
-  }
-}
-
-void 
-KDTreeLinkerTrackHcal::buildTree()
-{
-  // List of pseudo-rechits that will be used to create the KDTree
-  std::vector<KDTreeNodeInfo> eltList;
-
-  // Filling of this list
-  for(RecHitSet::const_iterator it = rechitsSet_.begin(); 
-      it != rechitsSet_.end(); it++) {
-    
-    const reco::PFRecHit::REPPoint &posrep = (*it)->positionREP();
-    
-    KDTreeNodeInfo rh1 (*it, posrep.eta(), posrep.phi());
-    eltList.push_back(rh1);
-    
-    // Here we solve the problem of phi circular set by duplicating some rechits
-    // too close to -Pi (or to Pi) and adding (substracting) to them 2 * Pi.
-    if (rh1.dim2 > (M_PI - getPhiOffset())) {
-      double phi = rh1.dim2 - 2 * M_PI;
-      KDTreeNodeInfo rh2(*it, posrep.eta(), phi); 
-      eltList.push_back(rh2);
-    }
-
-    if (rh1.dim2 < (M_PI * -1.0 + getPhiOffset())) {
-      double phi = rh1.dim2 + 2 * M_PI;
-      KDTreeNodeInfo rh3(*it, posrep.eta(), phi); 
-      eltList.push_back(rh3);
-    }
-  }
-
-  // Here we define the upper/lower bounds of the 2D space (eta/phi).
-  double phimin = -1.0 * M_PI - getPhiOffset();
-  double phimax = M_PI + getPhiOffset();
-
-  // etamin-etamax, phimin-phimax
-  KDTreeBox region(-3.0, 3.0, phimin, phimax);
-
-  // We may now build the KDTree
-  tree_.build(eltList, region);
-}
-
 void
 KDTreeLinkerTrackHcal::searchLinks()
 {
   // Must of the code has been taken from LinkByRecHit.cc
 
-  // We iterate over the tracks.
+  // We iterate over the tracks, to find the envelopes in which the rechit
+  // candidates are searched all at once. The track quantities at HCAL are
+  // kept for the link checks.
+  std::vector<TrackAtHcal> tracks;
+  std::vector<KDTreeBox> trackBoxes;
+  tracks.reserve(targetSet_.size());
+  trackBoxes.reserve(targetSet_.size());
   for(BlockEltSet::iterator it = targetSet_.begin(); 
       it != targetSet_.end(); it++) {
 	
@@ -139,18 +81,30 @@ KDTreeLinkerTrackHcal::searchLinks()
     double rangeeta = (getCristalPhiEtaMaxSize() * (1.5 + 0.5) + 0.2 * fabs(dHeta)) * inflation; 
     double rangephi = (getCristalPhiEtaMaxSize() * (1.5 + 0.5) + 0.2 * fabs(dHphi)) * inflation; 
 
-    // We search for all candidate recHits, ie all recHits contained in the maximal size envelope.
-    std::vector<KDTreeNodeInfo> recHits;
-    KDTreeBox trackBox(tracketa - rangeeta, tracketa + rangeeta, 
-		       trackphi - rangephi, trackphi + rangephi);
-    tree_.search(trackBox, recHits);
-    
+    tracks.push_back(TrackAtHcal{*it, tracketa, trackphi, dHeta, dHphi});
+    trackBoxes.emplace_back(tracketa - rangeeta, tracketa + rangeeta, 
+			    trackphi - rangephi, trackphi + rangephi);
+  }
+
+  // We search for all candidate recHits, ie all recHits contained in the maximal size envelope.
+  std::vector<unsigned int> offsets;
+  std::vector<unsigned int> recHits;
+  spatialIndex_->search(PFRecHitSpatialIndex::EtaPhi, trackBoxes, offsets, recHits);
+
+  for(unsigned int itrack = 0; itrack < tracks.size(); ++itrack) {
+
+    reco::PFBlockElement *track = tracks[itrack].elt;
+    const double tracketa = tracks[itrack].eta;
+    const double trackphi = tracks[itrack].phi;
+    const double dHeta = tracks[itrack].dHeta;
+    const double dHphi = tracks[itrack].dHphi;
+
     // Here we check all rechit candidates using the non-approximated method.
-    for(std::vector<KDTreeNodeInfo>::const_iterator rhit = recHits.begin(); 
-	rhit != recHits.end(); ++rhit) {
+    for(unsigned int irh = offsets[itrack]; irh < offsets[itrack+1]; ++irh) {
 
-      const auto &rhrep		   = rhit->ptr->positionREP();
-      const auto & corners = rhit->ptr->getCornersREP();
+      const reco::PFRecHit *rechit = spatialIndex_->recHit(recHits[irh]);
+      const auto &rhrep		   = rechit->positionREP();
+      const auto & corners = rechit->getCornersREP();
       
       double rhsizeeta = fabs(corners[3].eta() - corners[1].eta());
       double rhsizephi = fabs(corners[3].phi() - corners[1].phi());
@@ -161,10 +115,8 @@ KDTreeLinkerTrackHcal::searchLinks()
       if ( dphi > M_PI ) dphi = 2.*M_PI - dphi;
       
       // Find all clusters associated to given rechit
-      RecHit2BlockEltMap::iterator ret = rechit2ClusterLinks_.find(rhit->ptr);
-      
-      for(BlockEltSet::iterator clusterIt = ret->second.begin(); 
-	  clusterIt != ret->second.end(); clusterIt++) {
+      for(auto clusterIt = spatialIndex_->clustersBegin(recHits[irh]); 
+	  clusterIt != spatialIndex_->clustersEnd(recHits[irh]); clusterIt++) {
 	
 	const reco::PFClusterRef clusterref = (*clusterIt)->clusterRef();
 	int fracsNbr = clusterref->recHitFractions().size();
@@ -174,7 +126,7 @@ KDTreeLinkerTrackHcal::searchLinks()
 	
 	// Check if the track and the cluster are linked
 	if(deta < (_rhsizeeta / 2.) && dphi < (_rhsizephi / 2.))
-	  cluster2TargetLinks_[*clusterIt].insert(*it);
+	  cluster2TargetLinks_[*clusterIt].insert(track);
       }
     }
   }
@@ -207,8 +159,9 @@ KDTreeLinkerTrackHcal::updatePFBlockEltWithLinks()
 
   // We set the multilinks flag of the track to true. It will allow us to 
   // use in an optimized way our algo results in the recursive linking algo.
-  for (BlockEltSet::iterator it = fieldClusterSet_.begin();
-       it != fieldClusterSet_.end(); ++it)
+  const std::vector<reco::PFBlockElement*>& clusters = spatialIndex_->clusterElts();
+  for (std::vector<reco::PFBlockElement*>::const_iterator it = clusters.begin();
+       it != clusters.end(); ++it)
     (*it)->setIsValidMultilinks(true);
 
 }
@@ -217,12 +170,6 @@ void
 KDTreeLinkerTrackHcal::clear()
 {
   targetSet_.clear();
-  fieldClusterSet_.clear();
 
-  rechitsSet_.clear();
-
-  rechit2ClusterLinks_.clear();
   cluster2TargetLinks_.clear();
-
-  tree_.clear();
 }
@@ -3,7 +3,6 @@
 
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerTools.h"
-#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerAlgo.h"
 
 
 // This class is used to find all links between Tracks and HCAL clusters
@@ -18,14 +17,6 @@ class KDTreeLinkerTrackHcal : public KDTreeLinkerBase
   // With this method, we create the list of psCluster that we want to link.
   void insertTargetElt(reco::PFBlockElement		*track) override;
 
-  // Here, we create the list of hcalCluster that we want to link. From hcalCluster
-  // and fraction, we will create a second list of rechits that will be used to
-  // build the KDTree.
-  void insertFieldClusterElt(reco::PFBlockElement	*hcalCluster) override;  
-
-  // The KDTree building from rechits list.
-  void buildTree() override;
-  
   // Here we will iterate over all tracks. For each track intersection point with HCAL, 
   // we will search the closest rechits in the KDTree, from rechits we will find the 
   // hcalClusters and after that we will check the links between the track and 
@@ -40,22 +31,13 @@ class KDTreeLinkerTrackHcal : public KDTreeLinkerBase
   void clear() override;
  
  private:
-  // Data used by the KDTree algorithm : sets of Tracks and HCAL clusters.
+  // Data used by the KDTree algorithm : set of Tracks. The HCAL clusters
+  // and their rechits come from the spatial index.
   BlockEltSet		targetSet_;
-  BlockEltSet		fieldClusterSet_;
-
-  // Sets of rechits that compose the HCAL clusters. 
-  RecHitSet		rechitsSet_;
   
   // Map of linked Track/HCAL clusters.
   BlockElt2BlockEltMap	cluster2TargetLinks_;
 
-  // Map of the HCAL clusters associated to a rechit.
-  RecHit2BlockEltMap	rechit2ClusterLinks_;
-    
-  // KD trees
-  KDTreeLinkerAlgo	tree_;
-
 };
 
 #endif /* !KDTreeLinkerTrackHcal_h */
@@ -6,7 +6,8 @@ KDTreeLinkerBase::KDTreeLinkerBase()
   : cristalPhiEtaMaxSize_ (0.04),
     cristalXYMaxSize_ (3.),
     phiOffset_ (0.25),
-    debug_ (false)
+    debug_ (false),
+    spatialIndex_ (nullptr)
 {
 }
 
@@ -59,7 +60,6 @@ KDTreeLinkerBase::getPhiOffset() const
 void
 KDTreeLinkerBase::process()
 {
-  buildTree();
   searchLinks();
   updatePFBlockEltWithLinks();
   clear();
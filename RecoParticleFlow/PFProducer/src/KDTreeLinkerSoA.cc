@@ -0,0 +1,136 @@
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerSoA.h"
+
+#include <algorithm>
+#include <cassert>
+
+void
+KDTreeLinkerSoA::build(const std::vector<double>	&dim1,
+		       const std::vector<double>	&dim2,
+		       const std::vector<unsigned int>	&ids)
+{
+  clear();
+  assert(dim1.size() == dim2.size() && dim1.size() == ids.size());
+  if (ids.empty())
+    return;
+
+  std::vector<unsigned int> order(ids.size());
+  for (unsigned int i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  const unsigned int nodes = 2 * (ids.size() / leafSize_ + 1);
+  min1_.reserve(nodes); max1_.reserve(nodes);
+  min2_.reserve(nodes); max2_.reserve(nodes);
+  begin_.reserve(nodes); end_.reserve(nodes); right_.reserve(nodes);
+
+  recBuild(order, dim1, dim2, 0, ids.size(), 0);
+
+  dim1_.resize(ids.size());
+  dim2_.resize(ids.size());
+  ids_.resize(ids.size());
+  for (unsigned int i = 0; i < order.size(); ++i) {
+    dim1_[i] = dim1[order[i]];
+    dim2_[i] = dim2[order[i]];
+    ids_[i] = ids[order[i]];
+  }
+}
+
+void
+KDTreeLinkerSoA::recBuild(std::vector<unsigned int>	&order,
+			  const std::vector<double>	&dim1,
+			  const std::vector<double>	&dim2,
+			  unsigned int			begin,
+			  unsigned int			end,
+			  int				depth)
+{
+  const unsigned int node = begin_.size();
+
+  double min1 = dim1[order[begin]], max1 = min1;
+  double min2 = dim2[order[begin]], max2 = min2;
+  for (unsigned int i = begin + 1; i < end; ++i) {
+    min1 = std::min(min1, dim1[order[i]]); max1 = std::max(max1, dim1[order[i]]);
+    min2 = std::min(min2, dim2[order[i]]); max2 = std::max(max2, dim2[order[i]]);
+  }
+  min1_.push_back(min1); max1_.push_back(max1);
+  min2_.push_back(min2); max2_.push_back(max2);
+  begin_.push_back(begin); end_.push_back(end); right_.push_back(0);
+
+  if (end - begin <= leafSize_)
+    return;
+
+  // The even depth is associated to dim1 dimension
+  // The odd one to dim2 dimension
+  const std::vector<double> &dim = (depth & 1) ? dim2 : dim1;
+  const unsigned int median = begin + (end - begin) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + median, order.begin() + end,
+		   [&dim](unsigned int a, unsigned int b) { return dim[a] < dim[b]; });
+
+  recBuild(order, dim1, dim2, begin, median, depth + 1);
+  right_[node] = begin_.size();
+  recBuild(order, dim1, dim2, median, end, depth + 1);
+}
+
+void
+KDTreeLinkerSoA::search(const KDTreeBox		&searchBox,
+			std::vector<unsigned int>	&result) const
+{
+  if (ids_.empty())
+    return;
+
+  // The depth of the tree is at most log2 of the number of points, so that
+  // the stack of nodes left to visit can not overflow.
+  unsigned int stack[64];
+  int size = 0;
+  stack[size++] = 0;
+
+  while (size > 0) {
+    const unsigned int node = stack[--size];
+
+    // The node region does not intersect the box
+    if ((min1_[node] > searchBox.dim1max) || (max1_[node] < searchBox.dim1min) ||
+	(min2_[node] > searchBox.dim2max) || (max2_[node] < searchBox.dim2min))
+      continue;
+
+    // The node region is fully contained in the box
+    if ((min1_[node] >= searchBox.dim1min) && (max1_[node] <= searchBox.dim1max) &&
+	(min2_[node] >= searchBox.dim2min) && (max2_[node] <= searchBox.dim2max)) {
+      result.insert(result.end(), ids_.begin() + begin_[node], ids_.begin() + end_[node]);
+      continue;
+    }
+
+    if (right_[node] == 0) { // leaf case
+      for (unsigned int i = begin_[node]; i < end_[node]; ++i) {
+	if ((dim1_[i] >= searchBox.dim1min) && (dim1_[i] <= searchBox.dim1max) &&
+	    (dim2_[i] >= searchBox.dim2min) && (dim2_[i] <= searchBox.dim2max))
+	  result.push_back(ids_[i]);
+      }
+      continue;
+    }
+
+    stack[size++] = right_[node];
+    stack[size++] = node + 1;
+  }
+}
+
+void
+KDTreeLinkerSoA::search(const std::vector<KDTreeBox>	&searchBoxes,
+			std::vector<unsigned int>	&offsets,
+			std::vector<unsigned int>	&result) const
+{
+  offsets.resize(searchBoxes.size() + 1);
+  offsets[0] = result.size();
+  for (unsigned int i = 0; i < searchBoxes.size(); ++i) {
+    search(searchBoxes[i], result);
+    offsets[i + 1] = result.size();
+  }
+}
+
+void
+KDTreeLinkerSoA::clear()
+{
+  dim1_.clear();
+  dim2_.clear();
+  ids_.clear();
+  min1_.clear(); max1_.clear();
+  min2_.clear(); max2_.clear();
+  begin_.clear(); end_.clear(); right_.clear();
+}
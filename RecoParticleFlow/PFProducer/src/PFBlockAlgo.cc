@@ -126,6 +126,11 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
 								linkerName) );
       kdtrees_.back()->setTargetType(std::min(type1,type2));
       kdtrees_.back()->setFieldType(std::max(type1,type2));
+      // the linkers with the same field type share one rechit index
+      SpatialIndexPtr& index = spatialIndices_[std::max(type1,type2)];
+      if( !index ) index.reset(new PFRecHitSpatialIndex);
+      index->requestCoordinates(kdtrees_.back()->spatialIndexCoordinates());
+      index->setPhiOffset(kdtrees_.back()->getPhiOffset());
     }
   }
 }
@@ -156,6 +161,9 @@ void PFBlockAlgo::findBlocks() {
   for( const auto& kdtree : kdtrees_ ) {
     kdtree->process();
   }  
+  for( const auto& index : spatialIndices_ ) {
+    if( index ) index->clear();
+  }
   // !Glowinski & Gouzevitch
   // the blocks have not been passed to the event, and need to be cleared
   if( blocks_.get() ) blocks_->clear();
@@ -372,10 +380,18 @@ void PFBlockAlgo::buildElements(const edm::Event& evt) {
       if( (*it)->type() == kdtree->targetType() ) {
 	kdtree->insertTargetElt(it->get());
       }
-      if( (*it)->type() == kdtree->fieldType() ) {
-	kdtree->insertFieldClusterElt(it->get());
-      }
     }    
+    // the field clusters are inserted once in the index of their type
+    if( spatialIndices_[(*it)->type()] ) {
+      spatialIndices_[(*it)->type()]->insertClusterElt(it->get());
+    }
+  }
+
+  for( const auto& index : spatialIndices_ ) {
+    if( index ) index->build();
+  }
+  for( const auto& kdtree : kdtrees_ ) {
+    kdtree->setSpatialIndex(spatialIndices_[kdtree->fieldType()].get());
   }
   //std::cout << "(new) imported: " << elements_.size() << " elements!" << std::endl;
 }
@@ -0,0 +1,103 @@
+#include "RecoParticleFlow/PFProducer/interface/PFRecHitSpatialIndex.h"
+
+#include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFLayer.h"
+
+#include <algorithm>
+#include <cmath>
+
+PFRecHitSpatialIndex::PFRecHitSpatialIndex()
+  : requested_(0),
+    phiOffset_(0.)
+{
+}
+
+void
+PFRecHitSpatialIndex::insertClusterElt(reco::PFBlockElement	*cluster)
+{
+  clusters_.push_back(cluster);
+
+  const std::vector<reco::PFRecHitFraction> &fraction = cluster->clusterRef()->recHitFractions();
+  for(size_t rhit = 0; rhit < fraction.size(); ++rhit) {
+    const reco::PFRecHitRef& rh = fraction[rhit].recHitRef();
+    double fract = fraction[rhit].fraction();
+
+    if ((rh.isNull()) || (fract < 1E-4))
+      continue;
+
+    links_.emplace_back(&(*rh), cluster);
+  }
+}
+
+void
+PFRecHitSpatialIndex::build()
+{
+  // Rechits and clusters are ordered by pointer, as in RecHitSet and BlockEltSet.
+  std::sort(links_.begin(), links_.end());
+  links_.erase(std::unique(links_.begin(), links_.end()), links_.end());
+
+  rechits_.clear();
+  rechitOffsets_.clear();
+  rechitClusters_.clear();
+  rechitClusters_.reserve(links_.size());
+  for (const auto& link : links_) {
+    if (rechits_.empty() || rechits_.back() != link.first) {
+      rechitOffsets_.push_back(rechitClusters_.size());
+      rechits_.push_back(link.first);
+    }
+    rechitClusters_.push_back(link.second);
+  }
+  rechitOffsets_.push_back(rechitClusters_.size());
+  links_.clear();
+
+  std::vector<double> dim1, dim2;
+  std::vector<unsigned int> ids;
+
+  if (requested_ & (1 << EtaPhi)) {
+    for (unsigned int i = 0; i < rechits_.size(); ++i) {
+      const reco::PFRecHit::REPPoint &posrep = rechits_[i]->positionREP();
+      const double eta = posrep.eta();
+      const double phi = posrep.phi();
+      dim1.push_back(eta); dim2.push_back(phi); ids.push_back(i);
+
+      // Here we solve the problem of phi circular set by duplicating some rechits
+      // too close to -Pi (or to Pi) and adding (substracting) to them 2 * Pi.
+      if (phi > (M_PI - phiOffset_)) {
+	dim1.push_back(eta); dim2.push_back(phi - 2 * M_PI); ids.push_back(i);
+      }
+      if (phi < (M_PI * -1.0 + phiOffset_)) {
+	dim1.push_back(eta); dim2.push_back(phi + 2 * M_PI); ids.push_back(i);
+      }
+    }
+    trees_[EtaPhi].build(dim1, dim2, ids);
+  }
+
+  if (requested_ & ((1 << XYNeg) | (1 << XYPos))) {
+    for (int side = 0; side < 2; ++side) {
+      dim1.clear(); dim2.clear(); ids.clear();
+      for (unsigned int i = 0; i < rechits_.size(); ++i) {
+	const reco::PFRecHit &rechit = *rechits_[i];
+	const PFLayer::Layer layer = rechit.layer();
+	if (layer == PFLayer::ECAL_BARREL || layer == PFLayer::HCAL_BARREL1 || layer == PFLayer::HCAL_BARREL2)
+	  continue;
+	const auto & posxyz = rechit.position();
+	if ((posxyz.z() < 0) != (side == 0))
+	  continue;
+	dim1.push_back(posxyz.x()); dim2.push_back(posxyz.y()); ids.push_back(i);
+      }
+      trees_[side == 0 ? XYNeg : XYPos].build(dim1, dim2, ids);
+    }
+  }
+}
+
+void
+PFRecHitSpatialIndex::clear()
+{
+  clusters_.clear();
+  links_.clear();
+  rechits_.clear();
+  rechitOffsets_.clear();
+  rechitClusters_.clear();
+  for (auto& tree : trees_)
+    tree.clear();
+}
@@ -0,0 +1,626 @@
+// Compares the links found by the KDTree linkers searching the rechits in the
+// shared PFRecHitSpatialIndex with the links found with one KDTreeLinkerAlgo
+// per linker, built from the rechits of its own field clusters as the linkers
+// did before the index was shared. The track-ECAL, preshower-ECAL and
+// track-HCAL linkers run on toy events with barrel and endcap showers, some
+// close to phi = +-Pi, clusters sharing rechits, rechits with negligible
+// fractions, and tracks which do not reach the calorimeters.
+//
+// usage: testKDTreeLinkerSpatialIndex [number of events, default 10]
+
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerAlgo.h"
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerTools.h"
+#include "RecoParticleFlow/PFProducer/interface/PFRecHitSpatialIndex.h"
+#include "DataFormats/Common/interface/TestHandle.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockElementCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockElementTrack.h"
+#include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFClusterFwd.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitFwd.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecTrack.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecTrackFwd.h"
+#include "Geometry/CaloGeometry/interface/IdealObliquePrism.h"
+#include "FWCore/PluginManager/interface/PluginManager.h"
+#include "FWCore/PluginManager/interface/standard.h"
+#include "TMath.h"
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+  typedef CaloCellGeometry::CCGFloat CCGFloat;
+  typedef std::map<reco::PFBlockElement*, reco::PFMultilinksType> Links;
+
+  constexpr unsigned int nParticles = 200;
+  constexpr unsigned int nNoiseTracks = 20;
+  constexpr unsigned int nNoisePS = 10;
+
+  // toy calorimeter: radius of the barrel faces, z of the endcap faces,
+  // half size of the cells, in eta/phi in the barrel and in cm in the endcap
+  constexpr double ecalR = 129.;
+  constexpr double ecalZ = 317.;
+  constexpr double ecalHalfSize = 0.0087;
+  constexpr double ecalEndcapHalfSize = 1.43;
+  constexpr double hcalR = 181.1;
+  constexpr double hcalHalfSize = 0.0435;
+  constexpr double ps1Z = 303.;
+  constexpr double ps2Z = 307.7;
+
+  // phi in [-Pi,Pi]
+  double wrap(double phi) {
+    while (phi > M_PI) phi -= 2*M_PI;
+    while (phi < -M_PI) phi += 2*M_PI;
+    return phi;
+  }
+
+  // point in the direction eta/phi on the cylinder of radius r closed by the disks at +-z
+  math::XYZPoint pointAt(double eta, double phi, double r, double z) {
+    double pz = r*std::sinh(eta);
+    if (std::abs(pz) > z) {
+      pz = std::copysign(z, eta);
+      r = z/std::abs(std::sinh(eta));
+    }
+    return math::XYZPoint(r*std::cos(phi), r*std::sin(phi), pz);
+  }
+
+  struct CellSpec {
+    GlobalPoint center;
+    std::array<CCGFloat,5> params;
+    PFLayer::Layer layer;
+  };
+
+  struct ClusterSpec {
+    PFLayer::Layer layer;
+    math::XYZPoint position;
+    std::vector<std::pair<unsigned int, double> > fractions;
+  };
+
+  // One toy event: the cell geometries and rechits, the clusters and the tracks.
+  class Event {
+  public:
+    Event(std::mt19937& rng) {
+      std::uniform_real_distribution<double> flat(0., 1.);
+      std::uniform_real_distribution<double> phiDist(-M_PI, M_PI);
+      std::uniform_real_distribution<double> barrelEta(-1.4, 1.4);
+      std::uniform_real_distribution<double> endcapEta(1.65, 2.8);
+      std::uniform_real_distribution<double> ptDist(0.5, 20.);
+      std::normal_distribution<double> gauss;
+
+      for (unsigned int i = 0; i < nParticles; ++i) {
+        double eta = flat(rng) < 0.6 ? barrelEta(rng) : std::copysign(endcapEta(rng), flat(rng)-0.5);
+        // some particles across phi = +-Pi
+        double phi = flat(rng) < 0.1 ? wrap(M_PI + 0.05*gauss(rng)) : phiDist(rng);
+        const double pt = ptDist(rng);
+        const bool barrel = std::abs(eta) < 1.479;
+
+        if (barrel)
+          barrelShower(ecalCells_, PFLayer::ECAL_BARREL, eta + 0.01*gauss(rng), phi + 0.01*gauss(rng),
+                       ecalR, ecalHalfSize, 11., 2, rng);
+        else
+          endcapShower(eta, phi, rng);
+        if (std::abs(eta) < 1.3 && flat(rng) < 0.7)
+          barrelShower(hcalCells_, PFLayer::HCAL_BARREL1, eta + 0.05*gauss(rng), phi + 0.05*gauss(rng),
+                       hcalR, hcalHalfSize, 50., 1, rng);
+        if (flat(rng) < 0.8)
+          addTrack(eta, phi, pt, flat(rng) < 0.5 ? -1. : 1., true);
+      }
+      for (unsigned int i = 0; i < nNoiseTracks; ++i)
+        addTrack(flat(rng) < 0.5 ? barrelEta(rng) : endcapEta(rng), phiDist(rng), ptDist(rng), 1., i > 0);
+      for (unsigned int i = 0; i < nNoisePS; ++i) {
+        const double z = std::copysign(i % 2 ? ps1Z : ps2Z, flat(rng)-0.5);
+        const math::XYZPoint p = pointAt(std::copysign(endcapEta(rng), z), phiDist(rng), ecalR, std::abs(z));
+        psSpecs_.push_back(ClusterSpec{i % 2 ? PFLayer::PS1 : PFLayer::PS2, p, {}});
+      }
+
+      build();
+    }
+
+    const std::vector<reco::PFBlockElement*>& elements(reco::PFBlockElement::Type type) const {
+      return elements_[type];
+    }
+
+  private:
+    // A shower of (2n+1)x(2n+1) barrel cells, in one or two clusters.
+    void barrelShower(std::vector<CellSpec>& cells, PFLayer::Layer layer, double eta, double phi,
+                      double r, double halfSize, double depth, int n, std::mt19937& rng) {
+      std::vector<unsigned int> ids;
+      std::vector<int> columns;
+      for (int i = -n; i <= n; ++i) {
+        for (int j = -n; j <= n; ++j) {
+          const double ceta = eta + 2*halfSize*i;
+          const double cphi = phi + 2*halfSize*j;
+          const math::XYZPoint p = pointAt(ceta, cphi, r, 1e4);
+          ids.push_back(cells.size());
+          columns.push_back(i);
+          cells.push_back(CellSpec{GlobalPoint(p.x(), p.y(), p.z()),
+                                   {{CCGFloat(halfSize), CCGFloat(halfSize), CCGFloat(depth), CCGFloat(ceta), CCGFloat(p.z())}},
+                                   layer});
+        }
+      }
+      addClusters(cells, layer, ids, columns, rng);
+    }
+
+    // A shower of 5x5 endcap crystals, in one or two clusters, and the preshower clusters in front.
+    void endcapShower(double eta, double phi, std::mt19937& rng) {
+      std::normal_distribution<double> gauss;
+      const math::XYZPoint center = pointAt(eta, phi, ecalR, ecalZ);
+      const double x0 = center.x() + gauss(rng);
+      const double y0 = center.y() + gauss(rng);
+      std::vector<unsigned int> ids;
+      std::vector<int> columns;
+      for (int i = -2; i <= 2; ++i) {
+        for (int j = -2; j <= 2; ++j) {
+          const double x = x0 + 2*ecalEndcapHalfSize*i;
+          const double y = y0 + 2*ecalEndcapHalfSize*j;
+          const double z = center.z();
+          const double r = std::hypot(x, y);
+          const GlobalPoint p(x, y, z);
+          ids.push_back(ecalCells_.size());
+          columns.push_back(i);
+          ecalCells_.push_back(CellSpec{p,
+                                        {{CCGFloat(ecalEndcapHalfSize*std::abs(z)/(r*std::hypot(r, z))),
+                                          CCGFloat(ecalEndcapHalfSize/r), CCGFloat(-11.), CCGFloat(p.eta()), CCGFloat(z)}},
+                                        PFLayer::ECAL_ENDCAP});
+        }
+      }
+      addClusters(ecalCells_, PFLayer::ECAL_ENDCAP, ids, columns, rng);
+
+      psSpecs_.push_back(ClusterSpec{PFLayer::PS1, math::XYZPoint((x0 + 0.1*gauss(rng))*ps1Z/ecalZ,
+                                                                 (y0 + 0.1*gauss(rng))*ps1Z/ecalZ,
+                                                                 std::copysign(ps1Z, center.z())), {}});
+      psSpecs_.push_back(ClusterSpec{PFLayer::PS2, math::XYZPoint((x0 + 0.1*gauss(rng))*ps2Z/ecalZ,
+                                                                 (y0 + 0.1*gauss(rng))*ps2Z/ecalZ,
+                                                                 std::copysign(ps2Z, center.z())), {}});
+    }
+
+    // One cluster with all the cells, shared with a second cluster on the
+    // cells of the positive columns half of the time. The fraction of one
+    // cell is sometimes below the 1E-4 threshold of the linkers.
+    void addClusters(const std::vector<CellSpec>& cells, PFLayer::Layer layer,
+                     const std::vector<unsigned int>& ids, const std::vector<int>& columns, std::mt19937& rng) {
+      std::uniform_real_distribution<double> flat(0., 1.);
+      const bool split = flat(rng) < 0.5;
+      const bool negligible = flat(rng) < 0.3;
+      std::vector<ClusterSpec>& clusters = layer == PFLayer::HCAL_BARREL1 ? hcalSpecs_ : ecalSpecs_;
+
+      const GlobalPoint& center = cells[ids[ids.size()/2]].center;
+      ClusterSpec first{layer, math::XYZPoint(center.x(), center.y(), center.z()), {}};
+      const GlobalPoint& side = cells[ids.back()].center;
+      ClusterSpec second{layer, math::XYZPoint(side.x(), side.y(), side.z()), {}};
+      for (unsigned int k = 0; k < ids.size(); ++k) {
+        if (split && columns[k] > 0) {
+          first.fractions.emplace_back(ids[k], 0.6);
+          second.fractions.emplace_back(ids[k], 0.4);
+        } else {
+          first.fractions.emplace_back(ids[k], negligible && k == 0 ? 5E-5 : 1.);
+        }
+      }
+      clusters.push_back(first);
+      if (split) clusters.push_back(second);
+    }
+
+    // A straight track, bent in phi in HCAL. Tracks which are not
+    // extrapolated have invalid calorimeter points.
+    void addTrack(double eta, double phi, double pt, double charge, bool extrapolated) {
+      const math::XYZTLorentzVector momentum(pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta), pt*std::cosh(eta));
+      const double bend = 0.1*charge/pt;
+      reco::PFRecTrack track(charge, reco::PFRecTrack::KF);
+      const double r[reco::PFTrajectoryPoint::NLayers] = {0., 2.9, ecalR, ecalR, ecalR, ecalR + 6., hcalR, 295., 407.};
+      const double z[reco::PFTrajectoryPoint::NLayers] = {0., 1e4, ps1Z, ps2Z, ecalZ, ecalZ + 8., 388., 560., 1e4};
+      const double dphi[reco::PFTrajectoryPoint::NLayers] = {0., 0., 0., 0., 0., 0., bend, 2*bend, 3*bend};
+      for (int layer = 0; layer < reco::PFTrajectoryPoint::NLayers; ++layer) {
+        if (!extrapolated && layer >= reco::PFTrajectoryPoint::PS1) {
+          track.addPoint(reco::PFTrajectoryPoint());
+          continue;
+        }
+        reco::PFTrajectoryPoint point(-1, layer,
+                                      layer == 0 ? math::XYZPoint(0., 0., 0.) : pointAt(eta, wrap(phi + dphi[layer]), r[layer], z[layer]),
+                                      momentum);
+        point.calculatePositionREP();
+        track.addPoint(point);
+      }
+      tracks_.push_back(track);
+    }
+
+    void build() {
+      // the corners of the cells are held by the manager, and their parameters by the specs
+      cornersMgr_.reset(new CaloCellGeometry::CornersMgr((ecalCells_.size() + hcalCells_.size())*CaloCellGeometry::k_cornerSize,
+                                                         CaloCellGeometry::k_cornerSize));
+      for (auto cells : {std::make_pair(&ecalCells_, &ecalRecHits_), std::make_pair(&hcalCells_, &hcalRecHits_)}) {
+        for (const CellSpec& cell : *cells.first) {
+          auto geometry = std::make_shared<IdealObliquePrism>(cell.center, cornersMgr_.get(), cell.params.data());
+          cells.second->emplace_back(geometry, cells.second->size(), cell.layer, 1.);
+        }
+      }
+
+      edm::TestHandle<reco::PFRecHitCollection> ecalHits(&ecalRecHits_, edm::ProductID(1, 1));
+      edm::TestHandle<reco::PFRecHitCollection> hcalHits(&hcalRecHits_, edm::ProductID(1, 2));
+      makeClusters(ecalSpecs_, ecalHits, ecalClusters_);
+      makeClusters(hcalSpecs_, hcalHits, hcalClusters_);
+      makeClusters(psSpecs_, ecalHits, psClusters_);
+
+      edm::TestHandle<reco::PFClusterCollection> ecalClusters(&ecalClusters_, edm::ProductID(1, 3));
+      edm::TestHandle<reco::PFClusterCollection> hcalClusters(&hcalClusters_, edm::ProductID(1, 4));
+      edm::TestHandle<reco::PFClusterCollection> psClusters(&psClusters_, edm::ProductID(1, 5));
+      edm::TestHandle<reco::PFRecTrackCollection> tracks(&tracks_, edm::ProductID(1, 6));
+      for (unsigned int i = 0; i < ecalClusters_.size(); ++i)
+        addElement(new reco::PFBlockElementCluster(reco::PFClusterRef(ecalClusters, i), reco::PFBlockElement::ECAL));
+      for (unsigned int i = 0; i < hcalClusters_.size(); ++i)
+        addElement(new reco::PFBlockElementCluster(reco::PFClusterRef(hcalClusters, i), reco::PFBlockElement::HCAL));
+      for (unsigned int i = 0; i < psClusters_.size(); ++i)
+        addElement(new reco::PFBlockElementCluster(reco::PFClusterRef(psClusters, i),
+                                                   psClusters_[i].layer() == PFLayer::PS1 ? reco::PFBlockElement::PS1
+                                                                                           : reco::PFBlockElement::PS2));
+      for (unsigned int i = 0; i < tracks_.size(); ++i)
+        addElement(new reco::PFBlockElementTrack(reco::PFRecTrackRef(tracks, i)));
+    }
+
+    void makeClusters(const std::vector<ClusterSpec>& specs, const edm::TestHandle<reco::PFRecHitCollection>& hits,
+                      reco::PFClusterCollection& clusters) {
+      for (const ClusterSpec& spec : specs) {
+        clusters.emplace_back(spec.layer, 1., spec.position.x(), spec.position.y(), spec.position.z());
+        for (const auto& fraction : spec.fractions)
+          clusters.back().addRecHitFraction(reco::PFRecHitFraction(reco::PFRecHitRef(hits, fraction.first), fraction.second));
+      }
+    }
+
+    void addElement(reco::PFBlockElement* element) {
+      owned_.emplace_back(element);
+      elements_[element->type()].push_back(element);
+    }
+
+    std::vector<CellSpec> ecalCells_, hcalCells_;
+    std::vector<ClusterSpec> ecalSpecs_, hcalSpecs_, psSpecs_;
+    std::unique_ptr<CaloCellGeometry::CornersMgr> cornersMgr_;
+    reco::PFRecHitCollection ecalRecHits_, hcalRecHits_;
+    reco::PFClusterCollection ecalClusters_, hcalClusters_, psClusters_;
+    reco::PFRecTrackCollection tracks_;
+    std::vector<std::unique_ptr<reco::PFBlockElement> > owned_;
+    std::vector<reco::PFBlockElement*> elements_[reco::PFBlockElement::kNBETypes];
+  };
+
+  // The rechits of the field clusters and their associations, as each linker
+  // built them for its own tree.
+  struct FieldRecHits {
+    RecHitSet rechits;
+    RecHit2BlockEltMap clusters;
+
+    void insert(reco::PFBlockElement* cluster) {
+      const std::vector<reco::PFRecHitFraction>& fraction = cluster->clusterRef()->recHitFractions();
+      for (size_t rhit = 0; rhit < fraction.size(); ++rhit) {
+        const reco::PFRecHitRef& rh = fraction[rhit].recHitRef();
+        if (rh.isNull() || fraction[rhit].fraction() < 1E-4) continue;
+        clusters[&*rh].insert(cluster);
+        rechits.insert(&*rh);
+      }
+    }
+  };
+
+  void buildEtaPhiTree(const RecHitSet& rechits, double phiOffset, KDTreeLinkerAlgo& tree) {
+    std::vector<KDTreeNodeInfo> eltList;
+    for (const reco::PFRecHit* rh : rechits) {
+      const double eta = rh->positionREP().eta();
+      const double phi = rh->positionREP().phi();
+      eltList.emplace_back(rh, eta, phi);
+      if (phi > M_PI - phiOffset) eltList.emplace_back(rh, eta, phi - 2*M_PI);
+      if (phi < -M_PI + phiOffset) eltList.emplace_back(rh, eta, phi + 2*M_PI);
+    }
+    tree.build(eltList, KDTreeBox(-3., 3., -M_PI - phiOffset, M_PI + phiOffset));
+  }
+
+  // The track-ECAL links found with a tree of the rechits of the ECAL clusters.
+  Links referenceTrackEcal(const Event& event, const KDTreeLinkerBase& linker) {
+    FieldRecHits field;
+    for (reco::PFBlockElement* cluster : event.elements(reco::PFBlockElement::ECAL))
+      field.insert(cluster);
+    KDTreeLinkerAlgo tree;
+    buildEtaPhiTree(field.rechits, linker.getPhiOffset(), tree);
+
+    const BlockEltSet targets(event.elements(reco::PFBlockElement::TRACK).begin(),
+                              event.elements(reco::PFBlockElement::TRACK).end());
+    BlockElt2BlockEltMap links;
+    for (reco::PFBlockElement* track : targets) {
+      const reco::PFRecTrackRef trackref = track->trackRefPF();
+      const reco::PFTrajectoryPoint& atECAL = trackref->extrapolatedPoint(reco::PFTrajectoryPoint::ECALShowerMax);
+      if (!atECAL.isValid()) continue;
+      const reco::PFTrajectoryPoint& atVertex = trackref->extrapolatedPoint(reco::PFTrajectoryPoint::ClosestApproach);
+
+      const double trackPt = std::sqrt(atVertex.momentum().Vect().Perp2());
+      const double tracketa = atECAL.positionREP().eta();
+      const double trackphi = atECAL.positionREP().phi();
+      const double trackx = atECAL.position().X();
+      const double tracky = atECAL.position().Y();
+      const double trackz = atECAL.position().Z();
+      const double range = linker.getCristalPhiEtaMaxSize()*(2.0 + 1.0/std::min(1., trackPt/2.));
+
+      std::vector<KDTreeNodeInfo> recHits;
+      tree.search(KDTreeBox(tracketa - range, tracketa + range, trackphi - range, trackphi + range), recHits);
+      for (const KDTreeNodeInfo& rhit : recHits) {
+        const auto& cornersxyz = rhit.ptr->getCornersXYZ();
+        const auto& posxyz = rhit.ptr->position();
+        const auto& rhrep = rhit.ptr->positionREP();
+        const auto& corners = rhit.ptr->getCornersREP();
+
+        double rhsizeeta = std::abs(corners[3].eta() - corners[1].eta());
+        double rhsizephi = std::abs(corners[3].phi() - corners[1].phi());
+        if (rhsizephi > M_PI) rhsizephi = 2.*M_PI - rhsizephi;
+        const double deta = std::abs(rhrep.eta() - tracketa);
+        double dphi = std::abs(rhrep.phi() - trackphi);
+        if (dphi > M_PI) dphi = 2.*M_PI - dphi;
+
+        for (reco::PFBlockElement* cluster : field.clusters[rhit.ptr]) {
+          const reco::PFClusterRef clusterref = cluster->clusterRef();
+          const double clusterz = clusterref->position().z();
+          const int fracsNbr = clusterref->recHitFractions().size();
+
+          if (clusterref->layer() == PFLayer::ECAL_BARREL) {
+            if (std::abs(trackz) > 300.) continue;
+            const double _rhsizeeta = rhsizeeta*(2.00 + 1.0/(fracsNbr*std::min(1., trackPt/2.)));
+            const double _rhsizephi = rhsizephi*(2.00 + 1.0/(fracsNbr*std::min(1., trackPt/2.)));
+            if (deta < _rhsizeeta/2. && dphi < _rhsizephi/2.) links[track].insert(cluster);
+          } else {
+            if (std::abs(trackz) < 300.) continue;
+            if (trackz*clusterz < 0.) continue;
+            double x[5];
+            double y[5];
+            for (unsigned jc = 0; jc < 4; ++jc) {
+              x[3-jc] = cornersxyz[jc].x() + (cornersxyz[jc].x() - posxyz.x())*(1.00 + 0.50/fracsNbr/std::min(1., trackPt/2.));
+              y[3-jc] = cornersxyz[jc].y() + (cornersxyz[jc].y() - posxyz.y())*(1.00 + 0.50/fracsNbr/std::min(1., trackPt/2.));
+            }
+            x[4] = x[0];
+            y[4] = y[0];
+            if (TMath::IsInside(trackx, tracky, 5, x, y)) links[track].insert(cluster);
+          }
+        }
+      }
+    }
+
+    Links result;
+    for (const auto& link : links) {
+      for (reco::PFBlockElement* cluster : link.second)
+        result[link.first].emplace_back(cluster->clusterRef()->positionREP().phi(), cluster->clusterRef()->positionREP().eta());
+    }
+    return result;
+  }
+
+  // The preshower-ECAL links found with one x/y tree of the rechits of the
+  // ECAL endcap clusters on each side.
+  Links referencePSEcal(const Event& event, reco::PFBlockElement::Type psType) {
+    constexpr double resPSpitch = 0.19;
+    constexpr double resPSlength = 6.1;
+    constexpr double ps1ToEcal = 1.072;
+    constexpr double ps2ToEcal = 1.057;
+    const double maxEcalRadius = 3./2.;
+
+    FieldRecHits field[2];
+    for (reco::PFBlockElement* cluster : event.elements(reco::PFBlockElement::ECAL)) {
+      if (cluster->clusterRef()->layer() != PFLayer::ECAL_ENDCAP) continue;
+      field[cluster->clusterRef()->position().Z() < 0 ? 0 : 1].insert(cluster);
+    }
+    KDTreeLinkerAlgo trees[2];
+    for (int side = 0; side < 2; ++side) {
+      std::vector<KDTreeNodeInfo> eltList;
+      for (const reco::PFRecHit* rh : field[side].rechits)
+        eltList.emplace_back(rh, rh->position().x(), rh->position().y());
+      trees[side].build(eltList, KDTreeBox(-150., 150., -150., 150.));
+    }
+
+    const BlockEltSet targets(event.elements(psType).begin(), event.elements(psType).end());
+    BlockElt2BlockEltMap links;
+    for (reco::PFBlockElement* ps : targets) {
+      const reco::PFCluster& clusterPS = *ps->clusterRef();
+      const double zPS = clusterPS.position().Z();
+      const double xPS = clusterPS.position().X();
+      const double yPS = clusterPS.position().Y();
+      const double etaPS = std::abs(clusterPS.positionREP().eta());
+      const bool isPS1 = clusterPS.layer() == PFLayer::PS1;
+      const double deltaX = isPS1 ? resPSpitch : resPSlength;
+      const double deltaY = isPS1 ? resPSlength : resPSpitch;
+      const double xPSonEcal = xPS*(isPS1 ? ps1ToEcal : ps2ToEcal);
+      const double yPSonEcal = yPS*(isPS1 ? ps1ToEcal : ps2ToEcal);
+
+      const double inflation = 2.4 - (etaPS - 1.6);
+      const double rangeX = maxEcalRadius*(1 + (0.05 + 1.0/maxEcalRadius*deltaX/2.))*inflation;
+      const double rangeY = maxEcalRadius*(1 + (0.05 + 1.0/maxEcalRadius*deltaY/2.))*inflation;
+
+      const int side = zPS < 0 ? 0 : 1;
+      std::vector<KDTreeNodeInfo> recHits;
+      trees[side].search(KDTreeBox(xPSonEcal - rangeX, xPSonEcal + rangeX, yPSonEcal - rangeY, yPSonEcal + rangeY), recHits);
+      for (const KDTreeNodeInfo& rhit : recHits) {
+        const auto& corners = rhit.ptr->getCornersXYZ();
+        for (reco::PFBlockElement* cluster : field[side].clusters[rhit.ptr]) {
+          const double clusterz = cluster->clusterRef()->position().z();
+          const auto& posxyz = rhit.ptr->position()*zPS/clusterz;
+          double x[5];
+          double y[5];
+          for (unsigned jc = 0; jc < 4; ++jc) {
+            auto cornerpos = corners[jc].basicVector()*zPS/clusterz;
+            x[3-jc] = cornerpos.x() + (cornerpos.x() - posxyz.x())*(0.05 + 1.0/std::abs(cornerpos.x() - posxyz.x())*deltaX/2.);
+            y[3-jc] = cornerpos.y() + (cornerpos.y() - posxyz.y())*(0.05 + 1.0/std::abs(cornerpos.y() - posxyz.y())*deltaY/2.);
+          }
+          x[4] = x[0];
+          y[4] = y[0];
+          if (TMath::IsInside(xPS, yPS, 5, x, y)) links[ps].insert(cluster);
+        }
+      }
+    }
+
+    Links result;
+    for (const auto& link : links) {
+      for (reco::PFBlockElement* cluster : link.second)
+        result[link.first].emplace_back(cluster->clusterRef()->positionREP().phi(), cluster->clusterRef()->positionREP().eta());
+    }
+    return result;
+  }
+
+  // The track-HCAL links found with a tree of the rechits of the HCAL
+  // clusters. They are stored in the clusters.
+  Links referenceTrackHcal(const Event& event, const KDTreeLinkerBase& linker) {
+    FieldRecHits field;
+    for (reco::PFBlockElement* cluster : event.elements(reco::PFBlockElement::HCAL))
+      field.insert(cluster);
+    KDTreeLinkerAlgo tree;
+    buildEtaPhiTree(field.rechits, linker.getPhiOffset(), tree);
+
+    const BlockEltSet targets(event.elements(reco::PFBlockElement::TRACK).begin(),
+                              event.elements(reco::PFBlockElement::TRACK).end());
+    BlockElt2BlockEltMap links;
+    for (reco::PFBlockElement* track : targets) {
+      const reco::PFRecTrackRef trackref = track->trackRefPF();
+      const reco::PFTrajectoryPoint& atHCAL = trackref->extrapolatedPoint(reco::PFTrajectoryPoint::HCALEntrance);
+      const reco::PFTrajectoryPoint& atHCALExit = trackref->extrapolatedPoint(reco::PFTrajectoryPoint::HCALExit);
+      if (!atHCAL.isValid()) continue;
+
+      const double dHeta = atHCALExit.positionREP().eta() - atHCAL.positionREP().eta();
+      const double dHphi = wrap(atHCALExit.positionREP().phi() - atHCAL.positionREP().phi());
+      const double tracketa = atHCAL.positionREP().eta() + 0.1*dHeta;
+      const double trackphi = wrap(atHCAL.positionREP().phi() + 0.1*dHphi);
+      const double rangeeta = linker.getCristalPhiEtaMaxSize()*(1.5 + 0.5) + 0.2*std::abs(dHeta);
+      const double rangephi = linker.getCristalPhiEtaMaxSize()*(1.5 + 0.5) + 0.2*std::abs(dHphi);
+
+      std::vector<KDTreeNodeInfo> recHits;
+      tree.search(KDTreeBox(tracketa - rangeeta, tracketa + rangeeta, trackphi - rangephi, trackphi + rangephi), recHits);
+      for (const KDTreeNodeInfo& rhit : recHits) {
+        const auto& rhrep = rhit.ptr->positionREP();
+        const auto& corners = rhit.ptr->getCornersREP();
+
+        const double rhsizeeta = std::abs(corners[3].eta() - corners[1].eta());
+        double rhsizephi = std::abs(corners[3].phi() - corners[1].phi());
+        if (rhsizephi > M_PI) rhsizephi = 2.*M_PI - rhsizephi;
+        const double deta = std::abs(rhrep.eta() - tracketa);
+        double dphi = std::abs(rhrep.phi() - trackphi);
+        if (dphi > M_PI) dphi = 2.*M_PI - dphi;
+
+        for (reco::PFBlockElement* cluster : field.clusters[rhit.ptr]) {
+          const int fracsNbr = cluster->clusterRef()->recHitFractions().size();
+          const double _rhsizeeta = rhsizeeta*(1.5 + 0.5/fracsNbr) + 0.2*std::abs(dHeta);
+          const double _rhsizephi = rhsizephi*(1.5 + 0.5/fracsNbr) + 0.2*std::abs(dHphi);
+          if (deta < _rhsizeeta/2. && dphi < _rhsizephi/2.) links[cluster].insert(track);
+        }
+      }
+    }
+
+    Links result;
+    for (const auto& link : links) {
+      for (reco::PFBlockElement* track : link.second) {
+        const reco::PFTrajectoryPoint& atHCAL = track->trackRefPF()->extrapolatedPoint(reco::PFTrajectoryPoint::HCALEntrance);
+        result[link.first].emplace_back(atHCAL.positionREP().phi(), atHCAL.positionREP().eta());
+      }
+    }
+    return result;
+  }
+
+  // Runs the linker on the shared index, as PFBlockAlgo does.
+  void process(KDTreeLinkerBase& linker, const Event& event, const PFRecHitSpatialIndex& index) {
+    for (reco::PFBlockElement* target : event.elements(linker.targetType()))
+      linker.insertTargetElt(target);
+    linker.setSpatialIndex(&index);
+    linker.process();
+  }
+
+  class Checker {
+  public:
+    Checker(const char* name) : name_(name), nElements_(0), nLinks_(0), nFailures_(0) {}
+
+    // The links stored in the elements by the linker must be the reference ones.
+    void operator()(const std::vector<reco::PFBlockElement*>& elements, const Links& expected) {
+      static const reco::PFMultilinksType none;
+      for (reco::PFBlockElement* element : elements) {
+        auto it = expected.find(element);
+        const reco::PFMultilinksType& links = it == expected.end() ? none : it->second;
+        ++nElements_;
+        nLinks_ += links.size();
+        if (element->getMultilinks() != links) {
+          if (nFailures_ < 10) {
+            std::cout << name_ << ": element with " << element->getMultilinks().size() << " links instead of "
+                      << links.size() << std::endl;
+          }
+          ++nFailures_;
+        }
+      }
+    }
+
+    unsigned int failures() const {
+      std::cout << name_ << ": " << nElements_ << " elements, " << nLinks_ << " links, "
+                << nFailures_ << " elements differ" << std::endl;
+      // the toy events must give links, otherwise the comparison is empty
+      return nLinks_ == 0 ? 1 : nFailures_;
+    }
+
+  private:
+    const char* name_;
+    unsigned int nElements_;
+    unsigned int nLinks_;
+    unsigned int nFailures_;
+  };
+}
+
+int main(int argc, char **argv) {
+  const unsigned int nEvents = argc > 1 ? std::atoi(argv[1]) : 10;
+
+  edmplugin::PluginManager::configure(edmplugin::standard::config());
+  std::unique_ptr<KDTreeLinkerBase> trackEcal(KDTreeLinkerFactory::get()->create("KDTreeTrackAndECALLinker"));
+  std::unique_ptr<KDTreeLinkerBase> ps1Ecal(KDTreeLinkerFactory::get()->create("KDTreePreshowerAndECALLinker"));
+  std::unique_ptr<KDTreeLinkerBase> ps2Ecal(KDTreeLinkerFactory::get()->create("KDTreePreshowerAndECALLinker"));
+  std::unique_ptr<KDTreeLinkerBase> trackHcal(KDTreeLinkerFactory::get()->create("KDTreeTrackAndHCALLinker"));
+  trackEcal->setTargetType(reco::PFBlockElement::TRACK);
+  trackEcal->setFieldType(reco::PFBlockElement::ECAL);
+  ps1Ecal->setTargetType(reco::PFBlockElement::PS1);
+  ps1Ecal->setFieldType(reco::PFBlockElement::ECAL);
+  ps2Ecal->setTargetType(reco::PFBlockElement::PS2);
+  ps2Ecal->setFieldType(reco::PFBlockElement::ECAL);
+  trackHcal->setTargetType(reco::PFBlockElement::TRACK);
+  trackHcal->setFieldType(reco::PFBlockElement::HCAL);
+
+  // one index per field type, shared by the linkers of this field
+  PFRecHitSpatialIndex ecalIndex;
+  PFRecHitSpatialIndex hcalIndex;
+  for (KDTreeLinkerBase* linker : {trackEcal.get(), ps1Ecal.get(), ps2Ecal.get()}) {
+    ecalIndex.requestCoordinates(linker->spatialIndexCoordinates());
+    ecalIndex.setPhiOffset(linker->getPhiOffset());
+  }
+  hcalIndex.requestCoordinates(trackHcal->spatialIndexCoordinates());
+  hcalIndex.setPhiOffset(trackHcal->getPhiOffset());
+
+  Checker checkTrackEcal("track-ECAL");
+  Checker checkPS1Ecal("PS1-ECAL");
+  Checker checkPS2Ecal("PS2-ECAL");
+  Checker checkTrackHcal("track-HCAL");
+
+  std::mt19937 rng(12345);
+  for (unsigned int ievent = 0; ievent < nEvents; ++ievent) {
+    Event event(rng);
+
+    for (reco::PFBlockElement* cluster : event.elements(reco::PFBlockElement::ECAL))
+      ecalIndex.insertClusterElt(cluster);
+    for (reco::PFBlockElement* cluster : event.elements(reco::PFBlockElement::HCAL))
+      hcalIndex.insertClusterElt(cluster);
+    ecalIndex.build();
+    hcalIndex.build();
+
+    process(*trackEcal, event, ecalIndex);
+    process(*ps1Ecal, event, ecalIndex);
+    process(*ps2Ecal, event, ecalIndex);
+    process(*trackHcal, event, hcalIndex);
+
+    checkTrackEcal(event.elements(reco::PFBlockElement::TRACK), referenceTrackEcal(event, *trackEcal));
+    checkPS1Ecal(event.elements(reco::PFBlockElement::PS1), referencePSEcal(event, reco::PFBlockElement::PS1));
+    checkPS2Ecal(event.elements(reco::PFBlockElement::PS2), referencePSEcal(event, reco::PFBlockElement::PS2));
+    checkTrackHcal(event.elements(reco::PFBlockElement::HCAL), referenceTrackHcal(event, *trackHcal));
+
+    ecalIndex.clear();
+    hcalIndex.clear();
+  }
+
+  const unsigned int nFailures = checkTrackEcal.failures() + checkPS1Ecal.failures() +
+                                 checkPS2Ecal.failures() + checkTrackHcal.failures();
+  return nFailures > 0 ? 1 : 0;
+}
@@ -39,6 +39,8 @@ public:
   using CAntuplet = std::vector<unsigned int>;
   using CAColl = std::vector<CACell>;
   using CAStatusColl = std::vector<CACellStatus>;
+  // {inner cell, outer cell}
+  using CALink = std::array<unsigned int, 2>;
   
   
   CACell(const HitDoublets* doublets, int doubletId, const int innerHitId, const int outerHitId) :
@@ -58,6 +60,10 @@ public:
   }
   
   
+  int getInnerHitId() const {
+    return theDoublets->innerHitId(theDoubletId);
+  }
+  
   float getInnerX() const {
     return theDoublets->x(theDoubletId, HitDoublets::inner);
   }
@@ -98,14 +104,15 @@ public:
     return theDoublets->phi(theDoubletId, HitDoublets::outer);
   }
   
-  void evolve(unsigned int me, CAStatusColl& allStatus) {
+  // the outer neighbors of the cell are [nb,ne) in the flat neighbor list of the automaton
+  void evolve(unsigned int me, CAStatusColl& allStatus, const unsigned int* nb, const unsigned int* ne) const {
     
     allStatus[me].hasSameStateNeighbors = 0;
     auto mystate = allStatus[me].theCAState;
     
-    for (auto oc : theOuterNeighbors ) {
+    for (auto oc = nb; oc != ne; ++oc) {
       
-      if (allStatus[oc].getCAState() == mystate) {
+      if (allStatus[*oc].getCAState() == mystate) {
 	
 	allStatus[me].hasSameStateNeighbors = 1;
 	
@@ -116,9 +123,13 @@ public:
   }
   
 
-  void checkAlignmentAndAct(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
+  // calls act(innerCell, thisCell) for each of innerCells compatible with this cell.
+  // Neither this cell nor innerCells are modified, so that different cells can be
+  // checked concurrently.
+  template<typename Act>
+  void checkAlignmentAndAct(const CAColl& allCells, const CAntuple & innerCells, const float ptmin, const float region_origin_x,
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut, std::vector<CACell::CAntuplet> * foundTriplets) {
+			    const float phiCut, const float hardPtCut, Act && act) const {
     int ncells = innerCells.size();
     int constexpr VSIZE = 16;
     int ok[VSIZE];
@@ -141,10 +152,7 @@ public:
 	auto & oc =  allCells[koc]; 
 	if (ok[j]&&haveSimilarCurvature(oc,ptmin, region_origin_x, region_origin_y,
 					region_origin_radius, phiCut, hardPtCut)) {
-	  if (foundTriplets) foundTriplets->emplace_back(CACell::CAntuplet{koc,cellId});
-	  else {
-	    oc.tagAsOuterNeighbor(cellId);
-	  }
+	  act(koc,cellId);
 	}
       }
     };
@@ -154,19 +162,25 @@ public:
     
   }
   
-  void checkAlignmentAndTag(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
+  // appends the links {innerCell, thisCell} to the list of links
+  void checkAlignmentAndTag(const CAColl& allCells, const CAntuple & innerCells, std::vector<CALink>& links,
+			    const float ptmin, const float region_origin_x,
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut) {
+			    const float phiCut, const float hardPtCut) const {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, nullptr);
+			 phiCut, hardPtCut, [&](unsigned int koc, unsigned int cellId) {
+			   links.push_back(CALink{{koc,cellId}});
+			 });
     
   }
-  void checkAlignmentAndPushTriplet(CAColl& allCells, CAntuple & innerCells, std::vector<CACell::CAntuplet>& foundTriplets,
+  void checkAlignmentAndPushTriplet(const CAColl& allCells, const CAntuple & innerCells, std::vector<CACell::CAntuplet>& foundTriplets,
 				    const float ptmin, const float region_origin_x, const float region_origin_y,
 				    const float region_origin_radius, const float thetaCut, const float phiCut,
-				    const float hardPtCut) {
+				    const float hardPtCut) const {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, &foundTriplets);
+			 phiCut, hardPtCut, [&](unsigned int koc, unsigned int cellId) {
+			   foundTriplets.emplace_back(CACell::CAntuplet{koc,cellId});
+			 });
   }
   
   
@@ -182,12 +196,6 @@ public:
   }
   
   
-  void tagAsOuterNeighbor(unsigned int otherCell)
-  {
-    theOuterNeighbors.push_back(otherCell);
-  }
-  
-  
   bool haveSimilarCurvature(const CACell & otherCell, const float ptmin,
 			    const float region_origin_x, const float region_origin_y, const float region_origin_radius, const float phiCut, const float hardPtCut) const
   {
@@ -257,37 +265,8 @@ public:
   }
   
   
-  // trying to free the track building process from hardcoded layers, leaving the visit of the graph
-  // based on the neighborhood connections between cells.
-  
-  void findNtuplets(CAColl& allCells, std::vector<CAntuplet>& foundNtuplets, CAntuplet& tmpNtuplet, const unsigned int minHitsPerNtuplet) const {
-    
-    // the building process for a track ends if:
-    // it has no outer neighbor
-    // it has no compatible neighbor
-    // the ntuplets is then saved if the number of hits it contains is greater than a threshold
-    
-    if (tmpNtuplet.size() == minHitsPerNtuplet - 1)
-      {
-	foundNtuplets.push_back(tmpNtuplet);
-      }
-    else
-      {
-	unsigned int numberOfOuterNeighbors = theOuterNeighbors.size();
-	for (unsigned int i = 0; i < numberOfOuterNeighbors; ++i) {
-	  tmpNtuplet.push_back((theOuterNeighbors[i]));
-	  allCells[theOuterNeighbors[i]].findNtuplets(allCells,foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
-	  tmpNtuplet.pop_back();
-	}
-      }
-    
-  }
-  
-  
 private:
   
-  CAntuple theOuterNeighbors;
-  
   const HitDoublets* theDoublets;  
   const int theDoubletId;
   
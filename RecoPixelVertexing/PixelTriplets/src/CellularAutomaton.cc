@@ -1,24 +1,19 @@
+#include <iterator>
 #include <queue>
 
+#include "tbb/parallel_for.h"
+
 #include "CellularAutomaton.h"
 
-void CellularAutomaton::createAndConnectCells(
-    const std::vector<const HitDoublets *> & hitDoublets,
-    const TrackingRegion & region,
-    const float thetaCut,
-    const float phiCut,
-    const float hardPtCut)
+void CellularAutomaton::createCells(const std::vector<const HitDoublets *> & hitDoublets)
 {
   int tsize = 0;
   for (auto hd : hitDoublets) {
     tsize += hd->size();
   }
   allCells.reserve(tsize);
+  theCellLayerPairs.clear();
   unsigned int cellId = 0;
-  float ptmin = region.ptMin();
-  float region_origin_x = region.origin().x();
-  float region_origin_y = region.origin().y();
-  float region_origin_radius = region.originRBound();
 
   std::vector<bool> alreadyVisitedLayerPairs;
   alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
@@ -58,13 +53,9 @@ void CellularAutomaton::createAndConnectCells(
           currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
 
           cellId++;
-
-          auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-          allCells.back().checkAlignmentAndTag(
-              allCells, neigCells, ptmin, region_origin_x, region_origin_y,
-              region_origin_radius, thetaCut, phiCut, hardPtCut);
         }
         assert(cellId == currentLayerPairRef.theFoundCells[1]);
+        theCellLayerPairs.push_back(currentLayerPair);
         for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs) {
           LayerPairsToVisit.push(outerLayerPair);
         }
@@ -80,24 +71,72 @@ void CellularAutomaton::createAndConnectCells(
   }
 }
 
+void CellularAutomaton::createAndConnectCells(
+    const std::vector<const HitDoublets *> & hitDoublets,
+    const TrackingRegion & region,
+    const float thetaCut,
+    const float phiCut,
+    const float hardPtCut)
+{
+  createCells(hitDoublets);
+
+  float ptmin = region.ptMin();
+  float region_origin_x = region.origin().x();
+  float region_origin_y = region.origin().y();
+  float region_origin_radius = region.originRBound();
+
+  // all the cells exist and are not modified anymore: the links of
+  // each layer pair are found concurrently
+  std::vector<std::vector<CACell::CALink> > links(theCellLayerPairs.size());
+  tbb::parallel_for(size_t(0), theCellLayerPairs.size(), [&](size_t ilp) {
+      auto const & layerPair = theLayerGraph.theLayerPairs[theCellLayerPairs[ilp]];
+      auto const & innerLayer = theLayerGraph.theLayers[layerPair.theLayers[0]];
+      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
+        auto const & cell = allCells[i];
+        auto const & neigCells = innerLayer.isOuterHitOfCell[cell.getInnerHitId()];
+        cell.checkAlignmentAndTag(
+            allCells, neigCells, links[ilp], ptmin, region_origin_x, region_origin_y,
+            region_origin_radius, thetaCut, phiCut, hardPtCut);
+      }
+    });
+
+  // the layer pairs come in increasing cell id, so that the outer
+  // neighbors of each cell are filled in increasing order
+  theNeighborOffsets.assign(allCells.size() + 1, 0);
+  for (auto const & lpLinks : links) {
+    for (auto const & link : lpLinks) ++theNeighborOffsets[link[0] + 1];
+  }
+  for (unsigned int i = 0; i < allCells.size(); ++i) {
+    theNeighborOffsets[i + 1] += theNeighborOffsets[i];
+  }
+  theNeighbors.resize(theNeighborOffsets.back());
+  std::vector<unsigned int> fill(theNeighborOffsets.begin(), theNeighborOffsets.end() - 1);
+  for (auto const & lpLinks : links) {
+    for (auto const & link : lpLinks) theNeighbors[fill[link[0]]++] = link[1];
+  }
+}
+
 void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 {
   allStatus.resize(allCells.size());
 
   unsigned int numberOfIterations = minHitsPerNtuplet - 2;
   // keeping the last iteration for later
+  // in each stage a cell only writes its own status, so that the layer pairs are independent
   for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration) {
-    for (auto & layerPair : theLayerGraph.theLayerPairs) {
-      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
-        allCells[i].evolve(i, allStatus);
-      }
-    }
+    tbb::parallel_for(size_t(0), theCellLayerPairs.size(), [&](size_t ilp) {
+        auto const & layerPair = theLayerGraph.theLayerPairs[theCellLayerPairs[ilp]];
+        for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
+          allCells[i].evolve(i, allStatus, neighborsBegin(i), neighborsEnd(i));
+        }
+      });
 
-    for (auto & layerPair : theLayerGraph.theLayerPairs) {
-      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
-        allStatus[i].updateState();
-      }
-    }
+    tbb::parallel_for(size_t(0), theCellLayerPairs.size(), [&](size_t ilp) {
+        auto const & layerPair = theLayerGraph.theLayerPairs[theCellLayerPairs[ilp]];
+        for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
+          allStatus[i].updateState();
+        }
+      });
   }
 
   // last iteration
@@ -107,7 +146,7 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
       auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
       for (auto i = foundCells[0]; i < foundCells[1]; ++i) {
         auto & cell = allStatus[i];
-        allCells[i].evolve(i, allStatus);
+        allCells[i].evolve(i, allStatus, neighborsBegin(i), neighborsEnd(i));
         cell.updateState();
         if (cell.isRootCell(minHitsPerNtuplet - 2)) {
           theRootCells.push_back(i);
@@ -119,14 +158,36 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 
 void CellularAutomaton::findNtuplets(std::vector<CACell::CAntuplet> & foundNtuplets, const unsigned int minHitsPerNtuplet)
 {
-  CACell::CAntuple tmpNtuplet;
-  tmpNtuplet.reserve(minHitsPerNtuplet);
+  // depth-first visit of the neighbors of the root cells, with an explicit
+  // stack: next[k] is the next neighbor to visit of the k-th cell of the ntuplet
+  const unsigned int numberOfCells = minHitsPerNtuplet - 1;
+  CACell::CAntuplet tmpNtuplet(numberOfCells);
+  std::vector<unsigned int> next(numberOfCells);
 
   for (auto root_cell : theRootCells)
   {
-    tmpNtuplet.clear();
-    tmpNtuplet.push_back(root_cell);
-    allCells[root_cell].findNtuplets(allCells, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+    tmpNtuplet[0] = root_cell;
+    if (numberOfCells == 1) {
+      foundNtuplets.push_back(tmpNtuplet);
+      continue;
+    }
+    next[0] = theNeighborOffsets[root_cell];
+    unsigned int depth = 0;
+    while (true) {
+      if (next[depth] == theNeighborOffsets[tmpNtuplet[depth] + 1]) {
+        if (depth == 0) break;
+        --depth;
+        continue;
+      }
+      auto outerCell = theNeighbors[next[depth]++];
+      tmpNtuplet[depth + 1] = outerCell;
+      if (depth + 2 == numberOfCells) {
+        foundNtuplets.push_back(tmpNtuplet);
+      } else {
+        ++depth;
+        next[depth] = theNeighborOffsets[outerCell];
+      }
+    }
   }
 }
 
@@ -137,74 +198,28 @@ void CellularAutomaton::findTriplets(
     const float phiCut,
     const float hardPtCut)
 {
-  int tsize = 0;
-  for (auto hd : hitDoublets) {
-    tsize += hd->size();
-  }
-  allCells.reserve(tsize);
+  createCells(hitDoublets);
 
-  unsigned int cellId = 0;
   float ptmin = region.ptMin();
   float region_origin_x = region.origin().x();
   float region_origin_y = region.origin().y();
   float region_origin_radius = region.originRBound();
 
-  std::vector<bool> alreadyVisitedLayerPairs;
-  alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
-  for (auto visited : alreadyVisitedLayerPairs) {
-    visited = false;
-  }
-  for (int rootVertex : theLayerGraph.theRootLayers) {
-    std::queue<int> LayerPairsToVisit;
-
-    for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs) {
-      LayerPairsToVisit.push(LayerPair);
-    }
-
-    unsigned int numberOfLayerPairsToVisitAtThisDepth = LayerPairsToVisit.size();
-
-    while (not LayerPairsToVisit.empty()) {
-      auto currentLayerPair = LayerPairsToVisit.front();
-      auto & currentLayerPairRef  = theLayerGraph.theLayerPairs[currentLayerPair];
-      auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
-      auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
-      bool allInnerLayerPairsAlreadyVisited{true};
-
-      for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs) {
-        allInnerLayerPairsAlreadyVisited &= alreadyVisitedLayerPairs[innerLayerPair];
+  // triplets of each layer pair, appended in the order of the layer pairs
+  std::vector<std::vector<CACell::CAntuplet> > triplets(theCellLayerPairs.size());
+  tbb::parallel_for(size_t(0), theCellLayerPairs.size(), [&](size_t ilp) {
+      auto const & layerPair = theLayerGraph.theLayerPairs[theCellLayerPairs[ilp]];
+      auto const & innerLayer = theLayerGraph.theLayers[layerPair.theLayers[0]];
+      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
+        auto const & cell = allCells[i];
+        auto const & neigCells = innerLayer.isOuterHitOfCell[cell.getInnerHitId()];
+        cell.checkAlignmentAndPushTriplet(
+            allCells, neigCells, triplets[ilp], ptmin, region_origin_x, region_origin_y,
+            region_origin_radius, thetaCut, phiCut, hardPtCut);
       }
+    });
 
-      if (alreadyVisitedLayerPairs[currentLayerPair] == false and allInnerLayerPairsAlreadyVisited) {
-        const HitDoublets *doubletLayerPairId = hitDoublets[currentLayerPair];
-        auto numberOfDoublets = doubletLayerPairId->size();
-        currentLayerPairRef.theFoundCells[0] = cellId;
-        currentLayerPairRef.theFoundCells[1] = cellId + numberOfDoublets;
-        for (unsigned int i = 0; i < numberOfDoublets; ++i) {
-          allCells.emplace_back(doubletLayerPairId, i,
-                                doubletLayerPairId->innerHitId(i),
-                                doubletLayerPairId->outerHitId(i));
-
-          currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
-
-          cellId++;
-
-          auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-          allCells.back().checkAlignmentAndPushTriplet(
-              allCells, neigCells, foundTriplets, ptmin, region_origin_x, region_origin_y,
-              region_origin_radius, thetaCut, phiCut, hardPtCut);
-        }
-        assert(cellId == currentLayerPairRef.theFoundCells[1]);
-        for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs) {
-          LayerPairsToVisit.push(outerLayerPair);
-        }
-
-        alreadyVisitedLayerPairs[currentLayerPair] = true;
-      }
-      LayerPairsToVisit.pop();
-      numberOfLayerPairsToVisitAtThisDepth--;
-      if (numberOfLayerPairsToVisitAtThisDepth == 0) {
-        numberOfLayerPairsToVisitAtThisDepth = LayerPairsToVisit.size();
-      }
-    }
+  for (auto & lpTriplets : triplets) {
+    std::move(lpTriplets.begin(), lpTriplets.end(), std::back_inserter(foundTriplets));
   }
 }
@@ -15,26 +15,43 @@ public:
   CellularAutomaton(CAGraph& graph)
     : theLayerGraph(graph)
   { }
-  
+
   std::vector<CACell> & getAllCells() { return allCells; }
-  
+  const std::vector<CACellStatus> & getAllStatus() const { return allStatus; }
+
   void createAndConnectCells(const std::vector<const HitDoublets *>&,
 			     const TrackingRegion&, const float, const float, const float);
-  
+
   void evolve(const unsigned int);
   void findNtuplets(std::vector<CACell::CAntuplet>&, const unsigned int);
   void findTriplets(const std::vector<const HitDoublets*>& hitDoublets,std::vector<CACell::CAntuplet>& foundTriplets, const TrackingRegion& region,
 		    const float thetaCut, const float phiCut, const float hardPtCut);
-  
+
 private:
+  // creates the cells of the layer pairs reachable from the root layers, in
+  // breadth-first order, and fills isOuterHitOfCell of the layers
+  void createCells(const std::vector<const HitDoublets *>&);
+
+  // outer neighbors of cell i
+  const unsigned int * neighborsBegin(unsigned int i) const { return theNeighbors.data() + theNeighborOffsets[i]; }
+  const unsigned int * neighborsEnd(unsigned int i) const { return theNeighbors.data() + theNeighborOffsets[i+1]; }
+
   CAGraph & theLayerGraph;
 
   std::vector<CACell> allCells;
   std::vector<CACellStatus> allStatus;
 
+  // layer pairs with cells, in the order their cells were created
+  std::vector<int> theCellLayerPairs;
+
+  // flat (CSR) neighbor graph: the outer neighbors of cell i are
+  // theNeighbors[theNeighborOffsets[i]] ... theNeighbors[theNeighborOffsets[i+1]-1],
+  // in increasing order
+  std::vector<unsigned int> theNeighborOffsets;
+  std::vector<unsigned int> theNeighbors;
+
   std::vector<unsigned int> theRootCells;
-  std::vector<std::vector<CACell*> > theNtuplets;
-  
+
 };
 
 #endif // RecoPixelVertexing_PixelTriplets_src_CellularAutomaton_h
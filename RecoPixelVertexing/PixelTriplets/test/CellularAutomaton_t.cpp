@@ -0,0 +1,264 @@
+// Compares the ntuplets, the triplets and the cell states found by
+// CellularAutomaton (flat neighbor graph, TBB stages) with a serial
+// reference, which keeps the neighbors of each cell in its own list and
+// visits the graph recursively, as the automaton did before.
+// The toy graph has four barrel layers, with the layer pairs
+// BPix1+BPix2, BPix2+BPix3, BPix2+BPix4 and BPix3+BPix4, filled with
+// the hits of curved tracks from the origin and random hits.
+
+#include "RecoPixelVertexing/PixelTriplets/src/CellularAutomaton.h"
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+#include "RecoTracker/TkTrackingRegions/interface/GlobalTrackingRegion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr unsigned int nLayers = 4;
+  const float layerRadius[nLayers] = {2.9, 6.8, 10.9, 16.0};
+  // {inner layer, outer layer}, in the breadth-first order of the automaton
+  const int layerPairs[][2] = {{0,1}, {1,2}, {1,3}, {2,3}};
+  constexpr unsigned int nLayerPairs = sizeof(layerPairs)/sizeof(layerPairs[0]);
+
+  // cuts of the initial step quadruplets
+  constexpr float ptMin = 0.6;
+  constexpr float thetaCut = 0.0012;
+  constexpr float phiCut = 0.2;
+  constexpr float hardPtCut = 0.;
+  constexpr float originRadius = 0.02;
+
+  constexpr float maxDeltaPhi = 0.15;
+  constexpr float maxDeltaZ = 15.;
+
+  struct Event {
+    std::vector<std::unique_ptr<RecHitsSortedInPhi> > layers;
+    std::vector<std::unique_ptr<HitDoublets> > doublets;
+    std::vector<const HitDoublets *> doubletPtrs;
+  };
+
+  void generate(Event& event, unsigned int nTracks, unsigned int nNoiseHits, std::mt19937& rng) {
+    std::uniform_real_distribution<float> phi(-M_PI, M_PI);
+    std::uniform_real_distribution<float> cotTheta(-2.f, 2.f);
+    std::uniform_real_distribution<float> z0(-5.f, 5.f);
+    std::uniform_real_distribution<float> invPt(-1.f/ptMin, 1.f/ptMin);
+    std::uniform_real_distribution<float> z(-26.f, 26.f);
+    std::normal_distribution<float> smear(0.f, 0.001f);
+
+    std::vector<float> phis[nLayers], rs[nLayers], zs[nLayers];
+    for (unsigned int t=0; t<nTracks; ++t) {
+      const float phi0 = phi(rng);
+      const float cot = cotTheta(rng);
+      const float zv = z0(rng);
+      // radius of curvature in cm, 87 cm/GeV for 3.8 T
+      const float radius = 87.f/std::max(std::abs(invPt(rng)), 0.01f);
+      const float sign = invPt(rng)>0 ? 1.f : -1.f;
+      for (unsigned int l=0; l<nLayers; ++l) {
+        const float r = layerRadius[l];
+        float p = phi0 + sign*std::asin(r/(2.f*radius)) + smear(rng);
+        if (p>float(M_PI)) p -= 2*M_PI;
+        if (p<-float(M_PI)) p += 2*M_PI;
+        phis[l].push_back(p);
+        rs[l].push_back(r);
+        zs[l].push_back(zv + r*cot + smear(rng));
+      }
+    }
+    for (unsigned int l=0; l<nLayers; ++l) {
+      for (unsigned int h=0; h<nNoiseHits; ++h) {
+        phis[l].push_back(phi(rng));
+        rs[l].push_back(layerRadius[l]);
+        zs[l].push_back(z(rng));
+      }
+      event.layers.emplace_back(new RecHitsSortedInPhi(phis[l], rs[l], zs[l], true));
+    }
+
+    // all the pairs of hits close in phi and z, sorted by outer hit
+    for (auto const & lp : layerPairs) {
+      auto const & in = *event.layers[lp[0]];
+      auto const & out = *event.layers[lp[1]];
+      event.doublets.emplace_back(new HitDoublets(in, out));
+      for (unsigned int o=0; o<out.size(); ++o) {
+        for (unsigned int i=0; i<in.size(); ++i) {
+          float dphi = std::abs(out.phi(o)-in.phi(i));
+          if (dphi>float(M_PI)) dphi = 2*M_PI - dphi;
+          if (dphi<maxDeltaPhi && std::abs(out.z[o]-in.z[i])<maxDeltaZ) event.doublets.back()->add(i, o);
+        }
+      }
+      event.doubletPtrs.push_back(event.doublets.back().get());
+    }
+  }
+
+  CAGraph makeGraph(const Event& event) {
+    CAGraph g;
+    for (unsigned int l=0; l<nLayers; ++l) {
+      g.theLayers.emplace_back("BPix"+std::to_string(l+1), event.layers[l]->size());
+    }
+    g.theRootLayers.push_back(0);
+    for (auto const & lp : layerPairs) {
+      g.theLayerPairs.emplace_back(lp[0], lp[1]);
+      g.theLayers[lp[0]].theOuterLayerPairs.push_back(g.theLayerPairs.size()-1);
+      g.theLayers[lp[0]].theOuterLayers.push_back(lp[1]);
+      g.theLayers[lp[1]].theInnerLayerPairs.push_back(g.theLayerPairs.size()-1);
+      g.theLayers[lp[1]].theInnerLayers.push_back(lp[0]);
+    }
+    return g;
+  }
+
+  // the automaton as it was with neighbor lists in the cells
+  class SerialCA {
+  public:
+    SerialCA(const Event& event, const TrackingRegion& region) : region_(region) {
+      std::vector<std::vector<std::vector<unsigned int> > > isOuterHitOfCell(nLayers);
+      for (unsigned int l=0; l<nLayers; ++l) isOuterHitOfCell[l].resize(event.layers[l]->size());
+      for (unsigned int ilp=0; ilp<nLayerPairs; ++ilp) {
+        auto const & doublets = *event.doubletPtrs[ilp];
+        foundCells_[ilp][0] = cells.size();
+        for (unsigned int i=0; i<doublets.size(); ++i) {
+          isOuterHitOfCell[layerPairs[ilp][1]][doublets.outerHitId(i)].push_back(cells.size());
+          cells.emplace_back(&doublets, i, doublets.innerHitId(i), doublets.outerHitId(i));
+        }
+        foundCells_[ilp][1] = cells.size();
+      }
+      cellInnerNeighbors_.resize(cells.size());
+      for (unsigned int ilp=0; ilp<nLayerPairs; ++ilp) {
+        for (unsigned int c=foundCells_[ilp][0]; c<foundCells_[ilp][1]; ++c) {
+          cellInnerNeighbors_[c] = isOuterHitOfCell[layerPairs[ilp][0]][cells[c].getInnerHitId()];
+        }
+      }
+    }
+
+    void connect() {
+      neighbors.assign(cells.size(), std::vector<unsigned int>());
+      for (unsigned int c=0; c<cells.size(); ++c) {
+        std::vector<CACell::CALink> links;
+        cells[c].checkAlignmentAndTag(cells, cellInnerNeighbors_[c], links, region_.ptMin(),
+                                      region_.origin().x(), region_.origin().y(), region_.originRBound(),
+                                      thetaCut, phiCut, hardPtCut);
+        for (auto const & link : links) neighbors[link[0]].push_back(link[1]);
+      }
+    }
+
+    void evolve(unsigned int minHitsPerNtuplet) {
+      status.assign(cells.size(), CACellStatus());
+      for (unsigned int iteration=0; iteration<minHitsPerNtuplet-3; ++iteration) {
+        for (unsigned int c=0; c<cells.size(); ++c) cells[c].evolve(c, status, nb(c), ne(c));
+        for (unsigned int c=0; c<cells.size(); ++c) status[c].updateState();
+      }
+      // the root layer pair is the first one
+      for (unsigned int c=foundCells_[0][0]; c<foundCells_[0][1]; ++c) {
+        cells[c].evolve(c, status, nb(c), ne(c));
+        status[c].updateState();
+        if (status[c].isRootCell(minHitsPerNtuplet-2)) rootCells.push_back(c);
+      }
+    }
+
+    void findNtuplets(std::vector<CACell::CAntuplet>& found, unsigned int minHitsPerNtuplet) const {
+      CACell::CAntuplet tmp;
+      for (auto root : rootCells) {
+        tmp.assign(1, root);
+        visit(root, found, tmp, minHitsPerNtuplet);
+      }
+    }
+
+    void findTriplets(std::vector<CACell::CAntuplet>& found) const {
+      for (unsigned int c=0; c<cells.size(); ++c) {
+        cells[c].checkAlignmentAndPushTriplet(cells, cellInnerNeighbors_[c], found, region_.ptMin(),
+                                              region_.origin().x(), region_.origin().y(), region_.originRBound(),
+                                              thetaCut, phiCut, hardPtCut);
+      }
+    }
+
+    std::vector<CACell> cells;
+    std::vector<std::vector<unsigned int> > neighbors;
+    std::vector<CACellStatus> status;
+    std::vector<unsigned int> rootCells;
+
+  private:
+    const unsigned int* nb(unsigned int c) const { return neighbors[c].data(); }
+    const unsigned int* ne(unsigned int c) const { return neighbors[c].data()+neighbors[c].size(); }
+
+    void visit(unsigned int c, std::vector<CACell::CAntuplet>& found, CACell::CAntuplet& tmp,
+               unsigned int minHitsPerNtuplet) const {
+      if (tmp.size()==minHitsPerNtuplet-1) {
+        found.push_back(tmp);
+        return;
+      }
+      for (auto oc : neighbors[c]) {
+        tmp.push_back(oc);
+        visit(oc, found, tmp, minHitsPerNtuplet);
+        tmp.pop_back();
+      }
+    }
+
+    const TrackingRegion& region_;
+    unsigned int foundCells_[nLayerPairs][2];
+    std::vector<std::vector<unsigned int> > cellInnerNeighbors_;
+  };
+
+  bool sameStates(const std::vector<CACellStatus>& a, const std::vector<CACellStatus>& b) {
+    if (a.size()!=b.size()) return false;
+    for (unsigned int c=0; c<a.size(); ++c)
+      if (a[c].getCAState()!=b[c].getCAState()) return false;
+    return true;
+  }
+}
+
+int main() {
+  const GlobalTrackingRegion region(ptMin, GlobalPoint(0,0,0), originRadius, 15.);
+  std::mt19937 rng(12345);
+
+  unsigned int nFailures = 0;
+  unsigned int nNtuplets = 0;
+  unsigned int nTriplets = 0;
+  for (unsigned int ievent=0; ievent<20; ++ievent) {
+    Event event;
+    generate(event, 20+10*ievent, 5*ievent, rng);
+
+    SerialCA reference(event, region);
+    reference.connect();
+
+    for (unsigned int minHitsPerNtuplet : {3, 4}) {
+      CAGraph graph = makeGraph(event);
+      CellularAutomaton ca(graph);
+      ca.createAndConnectCells(event.doubletPtrs, region, thetaCut, phiCut, hardPtCut);
+      ca.evolve(minHitsPerNtuplet);
+      std::vector<CACell::CAntuplet> ntuplets;
+      ca.findNtuplets(ntuplets, minHitsPerNtuplet);
+
+      reference.rootCells.clear();
+      reference.evolve(minHitsPerNtuplet);
+      std::vector<CACell::CAntuplet> referenceNtuplets;
+      reference.findNtuplets(referenceNtuplets, minHitsPerNtuplet);
+
+      nNtuplets += referenceNtuplets.size();
+      if (ca.getAllCells().size()!=reference.cells.size() || !sameStates(ca.getAllStatus(), reference.status) ||
+          ntuplets!=referenceNtuplets) {
+        std::cout << "event " << ievent << " with " << minHitsPerNtuplet << " hits per ntuplet: "
+                  << ca.getAllCells().size() << " / " << reference.cells.size() << " cells, "
+                  << ntuplets.size() << " / " << referenceNtuplets.size() << " ntuplets"
+                  << (sameStates(ca.getAllStatus(), reference.status) ? "" : ", cell states differ") << std::endl;
+        ++nFailures;
+      }
+    }
+
+    CAGraph graph = makeGraph(event);
+    CellularAutomaton ca(graph);
+    std::vector<CACell::CAntuplet> triplets, referenceTriplets;
+    ca.findTriplets(event.doubletPtrs, triplets, region, thetaCut, phiCut, hardPtCut);
+    reference.findTriplets(referenceTriplets);
+    nTriplets += referenceTriplets.size();
+    if (triplets!=referenceTriplets) {
+      std::cout << "event " << ievent << ": " << triplets.size() << " / " << referenceTriplets.size()
+                << " triplets" << std::endl;
+      ++nFailures;
+    }
+  }
+
+  std::cout << nNtuplets << " ntuplets and " << nTriplets << " triplets compared, "
+            << nFailures << " differences" << std::endl;
+  return nFailures>0 ? 1 : 0;
+}
@@ -71,6 +71,9 @@ namespace cms
     RedundantSeedCleaner*  theSeedCleaner;
 
     unsigned int maxSeedsBeforeCleaning_;
+
+    // if not 0, the seeds are built concurrently in batches of this size
+    unsigned int seedBatchSize_;
     
     edm::EDGetTokenT<edm::View<TrajectorySeed> >  theSeedLabel;
     edm::EDGetTokenT<MeasurementTrackerEvent>     theMTELabel;
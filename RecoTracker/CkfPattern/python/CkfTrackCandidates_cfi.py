@@ -17,6 +17,10 @@ ckfTrackCandidates = cms.EDProducer("CkfTrackCandidateMaker",
 #    SeedLabel = cms.string(''),
     maxNSeeds = cms.uint32(500000),
     maxSeedsBeforeCleaning = cms.uint32(5000),
+# If not 0, build the seeds concurrently in batches of this size
+# (the result does not depend on it). Ignored with on-demand strip
+# clusters, as the batches would unpack all of them
+    seedBatchSize = cms.uint32(0),
 # SeedProducer:SeedLabel descoped to src
     src = cms.InputTag('globalMixedSeeds'),                                  
     SimpleMagneticField = cms.string(''),                                    
@@ -41,9 +41,7 @@
 // #define VI_TBB
 
 #include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -74,6 +72,7 @@ namespace cms{
     theNavigationSchool(nullptr),
     theSeedCleaner(nullptr),
     maxSeedsBeforeCleaning_(0),
+    seedBatchSize_(conf.exists("seedBatchSize") ? conf.getParameter<unsigned int>("seedBatchSize") : 0),
     theMTELabel(iC.consumes<MeasurementTrackerEvent>(conf.getParameter<edm::InputTag>("MeasurementTrackerEvent"))),
     skipClusters_(false),
     phase2skipClusters_(false)
@@ -168,12 +167,14 @@ namespace cms{
     e.getByToken(theMTELabel, data);
 
     std::unique_ptr<MeasurementTrackerEvent> dataWithMasks;
+    const MeasurementTrackerEvent * measurementTrackerEvent = &*data;
     if (skipClusters_) {
         edm::Handle<PixelClusterMask> pixelMask;
         e.getByToken(maskPixels_, pixelMask);
         edm::Handle<StripClusterMask> stripMask;
         e.getByToken(maskStrips_, stripMask);
         dataWithMasks = std::make_unique<MeasurementTrackerEvent>(*data, *stripMask, *pixelMask);
+        measurementTrackerEvent = &*dataWithMasks;
         //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created with masks " << std::endl;
         theTrajectoryBuilder->setEvent(e, es, &*dataWithMasks);
     } else if (phase2skipClusters_) {
@@ -183,6 +184,7 @@ namespace cms{
         edm::Handle<Phase2OTClusterMask> phase2OTMask;
         e.getByToken(maskPhase2OTs_, phase2OTMask);
         dataWithMasks = std::make_unique<MeasurementTrackerEvent>(*data, *pixelMask, *phase2OTMask);
+        measurementTrackerEvent = &*dataWithMasks;
         //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created with phase2 masks " << std::endl;
         theTrajectoryBuilder->setEvent(e, es, &*dataWithMasks);
     } else {
@@ -267,37 +269,22 @@ namespace cms{
 #endif
 
       std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
-        auto j = indeces[ii];
 
-        ntseed++;
-
-        // to be moved inside a par section (how with tbb??)
-        std::vector<Trajectory> theTmpTrajectories;
-
-
-	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
-
-        { Lock lock(theMutex);
-	// Check if seed hits already used by another track
-	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
-          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
-          (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
-          return;  // from the lambda!
-        }}
+      // set when the seed cleaner is given new trajectories
+      bool seedCleanerUpdated = false;
 
+      // Build the trajectories of seed j. Returns false, with the stop reason
+      // set in stopInfo, if no trajectory is left.
+      auto buildSeed = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories, SeedStopInfo & stopInfo) {
 
 	// Build trajectory from seed outwards
         theTmpTrajectories.clear();
         unsigned int nCandPerSeed = 0;
         auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr );
-        {
-          Lock lock(theMutex);
-          (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
-          if(theTmpTrajectories.empty()) {
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NO_TRAJECTORY);
-            return; // from the lambda!
-          }
+        stopInfo.setCandidatesPerSeed(nCandPerSeed);
+        if(theTmpTrajectories.empty()) {
+          stopInfo.setStopReason(SeedStopReason::NO_TRAJECTORY);
+          return false;
         }
 
 	LogDebug("CkfPattern") << "======== In-out trajectory building found " << theTmpTrajectories.size()
@@ -325,9 +312,8 @@ namespace cms{
   			              << " valid/invalid trajectories from seed " << j << " ========\n"
 				 <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
           if(theTmpTrajectories.empty()) {
-            Lock lock(theMutex);
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_REGION_REBUILD);
-            return;
+            stopInfo.setStopReason(SeedStopReason::SEED_REGION_REBUILD);
+            return false;
           }
         }
 
@@ -338,8 +324,11 @@ namespace cms{
         LogDebug("CkfPattern") << "======== Trajectory cleaning gave the following " << theTmpTrajectories.size() << " valid trajectories from seed "
                                << j << " ========\n"
 			       <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
+        return true;
+      };
 
-        { Lock lock(theMutex);
+      // Store the valid trajectories of seed j (to be called with the seeds in order)
+      auto storeSeed = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories) {
 	for(vector<Trajectory>::iterator it=theTmpTrajectories.begin();
 	    it!=theTmpTrajectories.end(); it++){
 	  if( it->isValid() ) {
@@ -349,16 +338,18 @@ namespace cms{
 	    rawResult.push_back(std::move(*it));
   	    // Tell seed cleaner which hits this trajectory used.
             //TO BE FIXED: this cut should be configurable via cfi file
-            if (theSeedCleaner && rawResult.back().foundHits()>3) theSeedCleaner->add( &rawResult.back() );
+            if (theSeedCleaner && rawResult.back().foundHits()>3) {
+              theSeedCleaner->add( &rawResult.back() );
+              seedCleanerUpdated = true;
+            }
             //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
 	  }
-	}}
+	}
 
         theTmpTrajectories.clear();
 
 	LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
 
-        { Lock lock(theMutex);
 	if ( maxSeedsBeforeCleaning_ >0 && rawResult.size() > maxSeedsBeforeCleaning_+lastCleanResult) {
           theTrajectoryCleaner->clean(rawResult);
           rawResult.erase(std::remove_if(rawResult.begin()+lastCleanResult,rawResult.end(),
@@ -366,13 +357,79 @@ namespace cms{
 			  rawResult.end());
           lastCleanResult=rawResult.size();
         }
-        }
+      };
+
+      auto theLoop = [&](size_t ii) {
+        auto j = indeces[ii];
+
+        ntseed++;
+
+        // to be moved inside a par section (how with tbb??)
+        std::vector<Trajectory> theTmpTrajectories;
+
+
+	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
+
+        { Lock lock(theMutex);
+	// Check if seed hits already used by another track
+	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
+          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+          (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+          return;  // from the lambda!
+        }}
 
+        SeedStopInfo stopInfo;
+        const bool built = buildSeed(j, theTmpTrajectories, stopInfo);
+
+        Lock lock(theMutex);
+        (*outputSeedStopInfos)[j] = stopInfo;
+        if (built) storeSeed(j, theTmpTrajectories);
       };
       // end of loop over seeds
 
 
+      // The batches need all the strip detsets filled up front. With on-demand
+      // strip clusters (regional and HLT tracking) that would unpack all of
+      // them, so the seeds are then built by the sequential loop.
+      if (seedBatchSize_ > 0 && !measurementTrackerEvent->stripClustersOnDemand()) {
+        // The seeds are built concurrently in batches of seedBatchSize_, then
+        // stored in order. Adding trajectories to the seed cleaner can only make
+        // it reject more seeds: the seeds it rejects before the batch are not
+        // built, the others are checked again when they are stored. The result
+        // is the same as the one of the sequential loop.
+        // The strip detsets are filled on first use: they are all filled here,
+        // so that the concurrent builds only read them.
+        measurementTrackerEvent->fillStripDetSets();
+        std::vector<std::vector<Trajectory> > batchTrajectories(seedBatchSize_);
+        std::vector<SeedStopInfo> batchStopInfos(seedBatchSize_);
+        std::vector<char> batchGood(seedBatchSize_), batchBuilt(seedBatchSize_);
+        for (size_t first = 0; first < collseed_size; first += seedBatchSize_) {
+          const size_t batch = std::min<size_t>(seedBatchSize_, collseed_size - first);
+          for (size_t ib = 0; ib < batch; ++ib) {
+            auto j = indeces[first+ib];
+            batchStopInfos[ib] = SeedStopInfo();
+            batchGood[ib] = !theSeedCleaner || theSeedCleaner->good( &((*collseed)[j]) );
+          }
+          tbb::parallel_for(size_t(0), batch, [&](size_t ib) {
+              batchBuilt[ib] = batchGood[ib] && buildSeed(indeces[first+ib], batchTrajectories[ib], batchStopInfos[ib]);
+            });
+          seedCleanerUpdated = false;
+          for (size_t ib = 0; ib < batch; ++ib) {
+            auto j = indeces[first+ib];
+            ntseed++;
+            if (!batchGood[ib] || (seedCleanerUpdated && !theSeedCleaner->good( &((*collseed)[j]) ))) {
+              LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+              (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+              batchTrajectories[ib].clear();
+              continue;
+            }
+            (*outputSeedStopInfos)[j] = batchStopInfos[ib];
+            if (batchBuilt[ib]) storeSeed(j, batchTrajectories[ib]);
+          }
+        }
+      } else {
 #ifdef VI_TBB
+     measurementTrackerEvent->fillStripDetSets();
      tbb::parallel_for(0UL,collseed_size,1UL,theLoop);
 #else
 #ifdef VI_OMP
@@ -382,6 +439,7 @@ namespace cms{
        theLoop(j);
       }
 #endif
+      }
       assert(ntseed==collseed_size);
       if (theSeedCleaner) theSeedCleaner->done();
 
@@ -0,0 +1,58 @@
+# Runs the tracking on 2017 simulated RAW events, and builds the track
+# candidates of the initial and low pt triplet steps again with the seeds
+# built concurrently in batches (seedBatchSize). TrackCandidateComparator
+# checks that the candidates and the seed stop reasons are identical to those
+# of the serial loop. The low pt triplet step also covers the masked clusters.
+#
+# usage: cmsRun CkfSeedBatchCompare_cfg.py inputFiles=<GEN-SIM-DIGI-RAW file, e.g. of a 2017 ttbar RelVal> [maxEvents=N]
+# Each compared event prints one 'identical track candidates' line per step.
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.Eras.Era_Run2_2017_cff import Run2_2017
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.parseArguments()
+
+process = cms.Process('RECO', Run2_2017)
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.MessageLogger.categories.append('TrackCandidateComparator')
+process.MessageLogger.cerr.TrackCandidateComparator = cms.untracked.PSet(limit = cms.untracked.int32(-1))
+process.load('SimGeneral.MixingModule.mixNoPU_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2017_realistic', '')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.compare = cms.Sequence()
+for step in ['initialStep', 'lowPtTripletStep']:
+    serial = getattr(process, step + 'TrackCandidates')
+    batched = serial.clone(seedBatchSize = 16)
+    setattr(process, step + 'TrackCandidatesBatched', batched)
+    comparator = cms.EDAnalyzer("TrackCandidateComparator",
+        reference = cms.InputTag(step + 'TrackCandidates'),
+        candidates = cms.InputTag(step + 'TrackCandidatesBatched')
+    )
+    setattr(process, step + 'Compare', comparator)
+    process.compare += batched*comparator
+
+process.raw2digi_step = cms.Path(process.RawToDigi)
+process.reconstruction_step = cms.Path(process.reconstruction_trackingOnly)
+process.compare_step = cms.Path(process.compare)
+process.schedule = cms.Schedule(process.raw2digi_step, process.reconstruction_step, process.compare_step)
@@ -0,0 +1,107 @@
+// Compares the track candidates and the seed stop reasons of two
+// CkfTrackCandidateMaker modules run on the same seeds, e.g. the serial
+// loop and the concurrent seed batches. Any difference throws.
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/TrackCandidate/interface/TrackCandidateCollection.h"
+#include "DataFormats/TrackReco/interface/SeedStopInfo.h"
+
+#include <sstream>
+#include <vector>
+
+class TrackCandidateComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit TrackCandidateComparator(const edm::ParameterSet&);
+
+private:
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+  static bool sameCandidate(const TrackCandidate& a, const TrackCandidate& b);
+
+  edm::EDGetTokenT<TrackCandidateCollection> referenceToken_;
+  edm::EDGetTokenT<TrackCandidateCollection> candidatesToken_;
+  edm::EDGetTokenT<std::vector<SeedStopInfo> > referenceStopToken_;
+  edm::EDGetTokenT<std::vector<SeedStopInfo> > candidatesStopToken_;
+};
+
+TrackCandidateComparator::TrackCandidateComparator(const edm::ParameterSet& conf) :
+  referenceToken_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("reference"))),
+  candidatesToken_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("candidates"))),
+  referenceStopToken_(consumes<std::vector<SeedStopInfo> >(conf.getParameter<edm::InputTag>("reference"))),
+  candidatesStopToken_(consumes<std::vector<SeedStopInfo> >(conf.getParameter<edm::InputTag>("candidates"))) {}
+
+bool TrackCandidateComparator::sameCandidate(const TrackCandidate& a, const TrackCandidate& b) {
+  if (a.seedRef().key() != b.seedRef().key() || a.stopReason() != b.stopReason() || a.nLoops() != b.nLoops()) return false;
+  if (a.recHits().second - a.recHits().first != b.recHits().second - b.recHits().first) return false;
+  const PTrajectoryStateOnDet& sa = a.trajectoryStateOnDet();
+  const PTrajectoryStateOnDet& sb = b.trajectoryStateOnDet();
+  if (sa.detId() != sb.detId()) return false;
+  const AlgebraicVector5 pa = sa.parameters().vector();
+  const AlgebraicVector5 pb = sb.parameters().vector();
+  for (int i = 0; i < 5; ++i) {
+    if (pa[i] != pb[i]) return false;
+  }
+  for (int i = 0; i < 15; ++i) {
+    if (sa.error(i) != sb.error(i)) return false;
+  }
+  auto hb = b.recHits().first;
+  for (auto ha = a.recHits().first; ha != a.recHits().second; ++ha, ++hb) {
+    if (ha->geographicalId() != hb->geographicalId() || ha->isValid() != hb->isValid()) return false;
+    if (ha->isValid() && !ha->sharesInput(&*hb, TrackingRecHit::all)) return false;
+  }
+  return true;
+}
+
+void TrackCandidateComparator::analyze(edm::StreamID, const edm::Event& e, const edm::EventSetup&) const {
+  edm::Handle<TrackCandidateCollection> reference, candidates;
+  e.getByToken(referenceToken_, reference);
+  e.getByToken(candidatesToken_, candidates);
+  edm::Handle<std::vector<SeedStopInfo> > referenceStops, candidatesStops;
+  e.getByToken(referenceStopToken_, referenceStops);
+  e.getByToken(candidatesStopToken_, candidatesStops);
+
+  std::ostringstream differences;
+  unsigned int nDifferences = 0;
+  if (reference->size() != candidates->size()) {
+    differences << "\n " << candidates->size() << " track candidates instead of " << reference->size();
+    ++nDifferences;
+  } else {
+    for (unsigned int i = 0; i < reference->size(); ++i) {
+      if (!sameCandidate((*reference)[i], (*candidates)[i])) {
+        if (nDifferences < 10) differences << "\n track candidate " << i << " of seed "
+                                           << (*reference)[i].seedRef().key() << " differs";
+        ++nDifferences;
+      }
+    }
+  }
+  if (referenceStops->size() != candidatesStops->size()) {
+    differences << "\n " << candidatesStops->size() << " seed stop reasons instead of " << referenceStops->size();
+    ++nDifferences;
+  } else {
+    for (unsigned int i = 0; i < referenceStops->size(); ++i) {
+      const SeedStopInfo& a = (*referenceStops)[i];
+      const SeedStopInfo& b = (*candidatesStops)[i];
+      if (a.stopReason() != b.stopReason() || a.candidatesPerSeed() != b.candidatesPerSeed()) {
+        if (nDifferences < 10) differences << "\n seed " << i << " stop reason " << int(b.stopReasonUC()) << " instead of "
+                                           << int(a.stopReasonUC()) << ", " << b.candidatesPerSeed() << " candidates instead of "
+                                           << a.candidatesPerSeed();
+        ++nDifferences;
+      }
+    }
+  }
+
+  if (nDifferences > 0) {
+    throw cms::Exception("TrackCandidateComparator") << "event " << e.id() << ": " << nDifferences << " differences"
+                                                     << differences.str();
+  }
+  edm::LogInfo("TrackCandidateComparator") << "event " << e.id() << ": " << reference->size()
+                                           << " identical track candidates from " << referenceStops->size() << " seeds";
+}
+
+DEFINE_FWK_MODULE(TrackCandidateComparator);
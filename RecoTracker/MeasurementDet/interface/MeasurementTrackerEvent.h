@@ -53,6 +53,15 @@ public:
    const std::vector<bool> & pixelClustersToSkip() const { return thePixelClustersToSkip; }
    const std::vector<bool> & phase2OTClustersToSkip() const { return thePhase2OTClustersToSkip; }
 
+   /// true if the strip clusters are unpacked on demand, i.e. when the
+   /// detset of their module is first used
+   bool stripClustersOnDemand() const;
+
+   /// fill the strip detsets that are otherwise filled on first use, so that
+   /// the MeasurementDets can then be used by several threads at once.
+   /// With on-demand strip clusters this unpacks all of them.
+   void fillStripDetSets() const;
+
    // forwarded calls
    const TrackingGeometry* geomTracker() const { return measurementTracker().geomTracker(); }
    const GeometricSearchTracker* geometricSearchTracker() const {return measurementTracker().geometricSearchTracker(); }
@@ -86,3 +86,11 @@ MeasurementTrackerEvent::MeasurementTrackerEvent(const MeasurementTrackerEvent &
     thePhase2OTClustersToSkip.resize(phase2OTClustersToSkip.size());
     phase2OTClustersToSkip.copyMaskTo(thePhase2OTClustersToSkip);
 }
+
+bool MeasurementTrackerEvent::stripClustersOnDemand() const {
+    return theStripData && theStripData->onDemand();
+}
+
+void MeasurementTrackerEvent::fillStripDetSets() const {
+    if (theStripData) theStripData->getAllDetSets();
+}
@@ -213,6 +213,14 @@ public:
   const edm::Handle<edmNew::DetSetVector<SiStripCluster> > & handle() const {  return handle_; }
   // StripDetset & detSet(int i) { return detSet_[i]; }
   const StripDetset & detSet(int i) const { if (ready_[i]) const_cast<StMeasurementDetSet*>(this)->getDetSet(i);     return detSet_[i]; }
+  // true if the clusters are unpacked on demand, when their detset is filled
+  bool onDemand() const { return handle_.isValid() && handle_->onDemand(); }
+  // fills the detsets not yet filled by detSet(i), after which detSet(i) only
+  // reads and can be called from several threads; with onDemand() clusters
+  // this unpacks all of them
+  void getAllDetSets() const {
+    for (int i=0, n=size(); i<n; ++i) if (ready_[i]) const_cast<StMeasurementDetSet*>(this)->getDetSet(i);
+  }
   
 
   //// ------- pieces for on-demand unpacking -------- 
@@ -42,6 +42,12 @@ public:
   
   RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint const & origin, DetLayer const * il);
 
+  // Builds the container from the phi, u and v of hits without RecHit
+  //  nor layer (the hits and the layer are null, the errors are zero):
+  //  for the tests of the indexing, which need no geometry.
+  //
+  RecHitsSortedInPhi(const std::vector<float>& phis, const std::vector<float>& us, const std::vector<float>& vs, bool barrel);
+
   bool empty() const { return theHits.empty(); }
   std::size_t size() const { return theHits.size();}
 
@@ -68,6 +74,13 @@ public:
   // some above, just double range of indeces..
   DoubleRange doubleRange(float phiMin, float phiMax) const;
 
+  // Appends to "result", in increasing order, the indices of the hits
+  //  in [b,e) (one of the ranges of doubleRange) with v in [vMin,vMax].
+  //  Whole phi bins are looked up in the v index, so that for narrow
+  //  v windows most hits outside of the window are never touched.
+  //
+  void indicesInVRange(int b, int e, float vMin, float vMax, std::vector<int>& result) const;
+
   // Fast access to the hits in the phi interval (phi in radians).
   //  The arguments must satisfy -pi <= phiMin < phiMax <= pi
   //  No check is made for this.
@@ -112,6 +125,17 @@ public:
   std::vector<float> dv;
   std::vector<float> lphi;
 
+  // 2D (phi x v) index: the hits are grouped in phi bins of vBinSize
+  // consecutive hits, and in each bin vIndex lists the hits in increasing
+  // v, vSorted being their v. uMin, uMax and dvMax bound u and dv of all
+  // the hits, for the computation of v windows from RZ compatibilities.
+  static constexpr int vBinSize = 32;
+  std::vector<int> vIndex;
+  std::vector<float> vSorted;
+  float uMin, uMax, dvMax;
+
+  void buildVIndex();
+
   static void copyResult( const Range& range, std::vector<Hit>& result) {
     result.reserve(result.size()+(range.second-range.first));
     for (HitIter i = range.first; i != range.second; i++) result.push_back( i->hit());
@@ -62,6 +62,19 @@ namespace {
 	ok[i-b] = ! crossRange.empty() ;
       }
     }
+
+    // same on a list of hit indices
+    void operator()(int const * indices, int n, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
+      constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+      for (int k=0; k!=n; ++k) {
+	int i = indices[k];
+	Range allowed = checkRZ->range(innerHitsMap.u[i]);
+	float vErr = nSigmaRZ * innerHitsMap.dv[i];
+	Range hitRZ(innerHitsMap.v[i]-vErr, innerHitsMap.v[i]+vErr);
+	Range crossRange = allowed.intersection(hitRZ);
+	ok[k] = ! crossRange.empty() ;
+      }
+    }
     Algo const * checkRZ;
     
   };
@@ -69,6 +82,24 @@ namespace {
 
   template<typename ... Args> using Kernels = std::tuple<Kernel<Args>...>;
 
+  // Window in v of the inner hits which may be compatible with checkRZ.
+  // The z range allowed by HitZCheck (also used by HitEtaCheck in the
+  // barrel) is linear in r, so that over the layer its bounds are extreme
+  // at uMin or uMax. The window is widened by the largest hit error and
+  // by a margin for rounding. Returns false for the other checks.
+  bool vWindow(const HitRZCompatibility & checkRZ, const RecHitsSortedInPhi & innerHitsMap, float & vMin, float & vMax) {
+    if (!(checkRZ.algo()==HitRZCompatibility::zAlgo ||
+	  (checkRZ.algo()==HitRZCompatibility::etaAlgo && innerHitsMap.isBarrel))) return false;
+    constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+    constexpr float margin = 0.01f;
+    Range atMin = checkRZ.range(innerHitsMap.uMin);
+    Range atMax = checkRZ.range(innerHitsMap.uMax);
+    float vErr = nSigmaRZ*innerHitsMap.dvMax + margin;
+    vMin = std::min(atMin.min(),atMax.min()) - vErr;
+    vMax = std::max(atMin.max(),atMax.max()) + vErr;
+    return true;
+  }
+
 }
 
 
@@ -121,6 +152,7 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 
   // constexpr float nSigmaRZ = std::sqrt(12.f);
   constexpr float nSigmaPhi = 3.f;
+  std::vector<int> indices;
   for (int io = 0; io!=int(outerHitsMap.theHits.size()); ++io) {
     if (!deltaPhi.prefilter(outerHitsMap.x[io],outerHitsMap.y[io])) continue;
     Hit const & ohit =  outerHitsMap.theHits[io].hit();
@@ -141,17 +173,27 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 
     Kernels<HitZCheck,HitRCheck,HitEtaCheck> kernels;
 
+    // when possible, only the inner hits in the v window are checked
+    float vMin, vMax;
+    const bool inVWindow = vWindow(*checkRZ, innerHitsMap, vMin, vMax);
+
     auto innerRange = innerHitsMap.doubleRange(phiRange.min(), phiRange.max());
     LogDebug("HitPairGeneratorFromLayerPair")<<
       "preparing for combination of: "<< innerRange[1]-innerRange[0]+innerRange[3]-innerRange[2]
 				      <<" inner and: "<< outerHitsMap.theHits.size()<<" outter";
     for(int j=0; j<3; j+=2) {
       auto b = innerRange[j]; auto e=innerRange[j+1];
-      bool ok[e-b];
+      if (inVWindow) {
+	indices.clear();
+	innerHitsMap.indicesInVRange(b,e,vMin,vMax,indices);
+      }
+      const int n = inVWindow ? int(indices.size()) : e-b;
+      bool ok[n];
       switch (checkRZ->algo()) {
 	case (HitRZCompatibility::zAlgo) :
 	  std::get<0>(kernels).set(checkRZ);
-	  std::get<0>(kernels)(b,e,innerHitsMap, ok);
+	  if (inVWindow) std::get<0>(kernels)(indices.data(),n,innerHitsMap, ok);
+	  else std::get<0>(kernels)(b,e,innerHitsMap, ok);
 	  break;
 	case (HitRZCompatibility::rAlgo) :
 	  std::get<1>(kernels).set(checkRZ);
@@ -159,10 +201,11 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 	  break;
 	case (HitRZCompatibility::etaAlgo) :
 	  std::get<2>(kernels).set(checkRZ);
-	  std::get<2>(kernels)(b,e,innerHitsMap, ok);
+	  if (inVWindow) std::get<2>(kernels)(indices.data(),n,innerHitsMap, ok);
+	  else std::get<2>(kernels)(b,e,innerHitsMap, ok);
 	  break;
       }
-      for (int i=0; i!=e-b; ++i) {
+      for (int i=0; i!=n; ++i) {
 	if (!ok[i]) continue;
 	if (theMaxElement!=0 && result.size() >= theMaxElement){
 	  result.clear();
@@ -170,7 +213,7 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 	  delete checkRZ;
 	  return;
 	}
-        result.add(b+i,io);
+        result.add(inVWindow ? indices[i] : b+i,io);
       }
     }
     delete checkRZ;
@@ -2,6 +2,7 @@
 #include "DataFormats/TrackerRecHit2D/interface/BaseTrackerRecHit.h"
 
 #include <algorithm>
+#include <cmath>
 #include<cassert>
 
 
@@ -11,7 +12,9 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
   isBarrel(il->isBarrel()),
   x(hits.size()),y(hits.size()),z(hits.size()),drphi(hits.size()),
   u(hits.size()),v(hits.size()),du(hits.size()),dv(hits.size()),
-  lphi(hits.size())
+  lphi(hits.size()),
+  vIndex(hits.size()), vSorted(hits.size()),
+  uMin(0), uMax(0), dvMax(0)
 {
 
   // standard region have origin as 0,0,z (not true!!!!0
@@ -44,10 +47,60 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
     dv[i] = isBarrel ? dz : dr;
     lphi[i] = loc.barePhi();
   }
+
+  buildVIndex();
   
 }
 
 
+RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<float>& phis, const std::vector<float>& us, const std::vector<float>& vs, bool barrel) :
+  layer(nullptr),
+  isBarrel(barrel),
+  x(phis.size()),y(phis.size()),z(phis.size()),drphi(phis.size()),
+  u(phis.size()),v(phis.size()),du(phis.size()),dv(phis.size()),
+  lphi(phis.size()),
+  vIndex(phis.size()), vSorted(phis.size()),
+  uMin(0), uMax(0), dvMax(0)
+{
+  assert(us.size()==phis.size() && vs.size()==phis.size());
+
+  std::vector<int> order(phis.size());
+  for (unsigned int i=0; i!=order.size(); ++i) order[i]=i;
+  std::stable_sort(order.begin(),order.end(),[&](int i, int j){ return phis[i]<phis[j];});
+
+  theHits.reserve(phis.size());
+  for (unsigned int i=0; i!=order.size(); ++i) {
+    int k = order[i];
+    theHits.emplace_back(nullptr,phis[k]);
+    float lr = barrel ? us[k] : vs[k];
+    x[i] = lr*std::cos(phis[k]);
+    y[i] = lr*std::sin(phis[k]);
+    z[i] = barrel ? vs[k] : us[k];
+    u[i] = us[k];
+    v[i] = vs[k];
+    lphi[i] = phis[k];
+  }
+
+  buildVIndex();
+}
+
+
+void RecHitsSortedInPhi::buildVIndex() {
+  if (!theHits.empty()) {
+    uMin = *std::min_element(u.begin(),u.end());
+    uMax = *std::max_element(u.begin(),u.end());
+    dvMax = *std::max_element(dv.begin(),dv.end());
+  }
+
+  for (int b=0; b<int(theHits.size()); b+=vBinSize) {
+    int e = std::min(b+vBinSize,int(theHits.size()));
+    for (int i=b; i!=e; ++i) vIndex[i]=i;
+    std::sort(vIndex.begin()+b,vIndex.begin()+e,[&](int i, int j){ return v[i]<v[j];});
+    for (int i=b; i!=e; ++i) vSorted[i]=v[vIndex[i]];
+  }
+}
+
+
 RecHitsSortedInPhi::DoubleRange RecHitsSortedInPhi::doubleRange(float phiMin, float phiMax) const {
   Range r1,r2;
   if ( phiMin < phiMax) {
@@ -74,6 +127,28 @@ RecHitsSortedInPhi::DoubleRange RecHitsSortedInPhi::doubleRange(float phiMin, fl
 }
 
 
+void RecHitsSortedInPhi::indicesInVRange(int b, int e, float vMin, float vMax, std::vector<int>& result) const {
+  if (b>=e) return;
+  for (int bin=b/vBinSize; bin<=(e-1)/vBinSize; ++bin) {
+    int kb = bin*vBinSize;
+    int ke = std::min(kb+vBinSize,int(theHits.size()));
+    if (kb<b || ke>e) {
+      // bin partially in the range: the hits are checked one by one
+      for (int i=std::max(kb,b), ie=std::min(ke,e); i!=ie; ++i)
+        if (v[i]>=vMin && v[i]<=vMax) result.push_back(i);
+      continue;
+    }
+    auto first = vSorted.begin()+kb;
+    auto last = vSorted.begin()+ke;
+    auto lo = std::lower_bound(first,last,vMin);
+    auto hi = std::upper_bound(lo,last,vMax);
+    auto size = result.size();
+    for (auto p=lo; p!=hi; ++p) result.push_back(vIndex[p-vSorted.begin()]);
+    std::sort(result.begin()+size,result.end());
+  }
+}
+
+
 void RecHitsSortedInPhi::hits( float phiMin, float phiMax, std::vector<Hit>& result) const
 {
   if ( phiMin < phiMax) {
@@ -0,0 +1,139 @@
+// Compares RecHitsSortedInPhi::indicesInVRange with a linear scan of the
+// hits, on barrel-like (v=z) and endcap-like (v=r) layers, for the phi
+// ranges given by doubleRange and for ranges starting or ending on the
+// edges of the phi bins of the v index.
+//
+// usage: testRecHitsSortedInPhiVIndex
+
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  constexpr int binSize = RecHitsSortedInPhi::vBinSize;
+
+  std::vector<int> linearScan(const RecHitsSortedInPhi& hits, int b, int e, float vMin, float vMax) {
+    std::vector<int> result;
+    for (int i=b; i<e; ++i)
+      if (hits.v[i]>=vMin && hits.v[i]<=vMax) result.push_back(i);
+    return result;
+  }
+
+  class Checker {
+  public:
+    Checker(const RecHitsSortedInPhi& hits, const char* name) : hits_(hits), name_(name) {}
+
+    void operator()(int b, int e, float vMin, float vMax) {
+      std::vector<int> result;
+      hits_.indicesInVRange(b, e, vMin, vMax, result);
+      ++nChecks;
+      if (result!=linearScan(hits_, b, e, vMin, vMax)) {
+        if (nFailures<10) {
+          std::cout << name_ << " with " << hits_.size() << " hits: range [" << b << "," << e << ") v in ["
+                    << vMin << "," << vMax << "] gives " << result.size() << " hits instead of "
+                    << linearScan(hits_, b, e, vMin, vMax).size() << std::endl;
+        }
+        ++nFailures;
+      }
+    }
+
+    static unsigned int nChecks;
+    static unsigned int nFailures;
+
+  private:
+    const RecHitsSortedInPhi& hits_;
+    const char* name_;
+  };
+  unsigned int Checker::nChecks = 0;
+  unsigned int Checker::nFailures = 0;
+
+  void check(const RecHitsSortedInPhi& hits, const char* name, std::mt19937& rng) {
+    Checker checker(hits, name);
+    const int n = hits.size();
+    float vLow = 0., vHigh = 0.;
+    if (n>0) {
+      vLow = *std::min_element(hits.v.begin(), hits.v.end());
+      vHigh = *std::max_element(hits.v.begin(), hits.v.end());
+    }
+    std::uniform_real_distribution<float> vDist(vLow-1.f, vHigh+1.f);
+    std::uniform_real_distribution<float> phiDist(-M_PI, M_PI);
+    std::uniform_real_distribution<float> dPhiDist(0.f, 1.f);
+    std::exponential_distribution<float> width(1.f);
+
+    // v windows: whole layer, empty, narrow, wide, and windows whose edges are exactly on hits
+    auto windows = [&](int b, int e) {
+      checker(b, e, vLow-1.f, vHigh+1.f);
+      checker(b, e, vHigh+1.f, vLow-1.f);
+      for (int k=0; k<5; ++k) {
+        const float v0 = vDist(rng);
+        checker(b, e, v0, v0+width(rng));
+        checker(b, e, v0, v0+10.f*width(rng));
+      }
+      if (b<e) {
+        std::uniform_int_distribution<int> hit(b, e-1);
+        const float v0 = hits.v[hit(rng)];
+        const float v1 = hits.v[hit(rng)];
+        checker(b, e, v0, v0);
+        checker(b, e, std::min(v0,v1), std::max(v0,v1));
+      }
+    };
+
+    // ranges on and around the bin edges, including single bins and single hits
+    std::vector<int> edges;
+    for (int k=0; k<=n; k+=binSize) {
+      for (int d=-1; d<=1; ++d)
+        if (k+d>=0 && k+d<=n) edges.push_back(k+d);
+    }
+    edges.push_back(n);
+    for (int b : edges)
+      for (int e : edges)
+        if (b<=e) windows(b, e);
+
+    // the ranges of doubleRange for phi windows, some across -pi
+    for (int k=0; k<50; ++k) {
+      const float phiMin = phiDist(rng);
+      const float phiMax = phiMin + dPhiDist(rng);
+      const auto ranges = hits.doubleRange(phiMin, phiMax);
+      windows(ranges[0], ranges[1]);
+      windows(ranges[2], ranges[3]);
+    }
+  }
+}
+
+int main() {
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<float> phi(-M_PI, M_PI);
+
+  for (int n : {0, 1, binSize-1, binSize, binSize+1, 2*binSize, 1000}) {
+    std::vector<float> phis(n), us(n), vs(n);
+
+    // barrel layer: u=r around the layer radius, v=z along the ladders
+    std::uniform_real_distribution<float> barrelR(4.2f, 4.6f);
+    std::uniform_real_distribution<float> barrelZ(-26.7f, 26.7f);
+    for (int i=0; i<n; ++i) {
+      phis[i] = phi(rng);
+      us[i] = barrelR(rng);
+      vs[i] = barrelZ(rng);
+    }
+    // some hits with the same v, which must all be found at the window edges
+    for (int i=0; i<n; i+=7) vs[i] = vs[0];
+    check(RecHitsSortedInPhi(phis, us, vs, true), "barrel", rng);
+
+    // endcap disk: u=z around the disk position, v=r across the blades
+    std::uniform_real_distribution<float> endcapZ(34.3f, 35.7f);
+    std::uniform_real_distribution<float> endcapR(4.5f, 16.1f);
+    for (int i=0; i<n; ++i) {
+      phis[i] = phi(rng);
+      us[i] = endcapZ(rng);
+      vs[i] = endcapR(rng);
+    }
+    check(RecHitsSortedInPhi(phis, us, vs, false), "endcap", rng);
+  }
+
+  std::cout << Checker::nChecks << " ranges checked, " << Checker::nFailures << " differ" << std::endl;
+  return Checker::nFailures>0 ? 1 : 0;
+}
@@ -190,6 +190,16 @@ public:
   bool split(const double beta,  track_t &t, vertex_t & y, double threshold = 1. ) const;
   
   double beta0(const double betamax, track_t const & tks, vertex_t const & y) const;
+
+  // annealing down to T=Tstop, fills the vertex prototypes y and returns the final beta and rho0
+  void anneal(track_t & tks, vertex_t & y, double & beta, double & rho0) const;
+  // same, with the tracks partitioned in overlapping blocks in z which are annealed in parallel
+  // down to T=Tpurge, then purged and cooled down to T=Tstop together
+  void annealInBlocks(track_t & tks, vertex_t & y, double & beta, double & rho0) const;
+  // the two stages of anneal: down to T=Tpurge, with the outlier rejection rho0max switched on at T=Tmin,
+  void annealToPurge(track_t & tks, vertex_t & y, double & beta, double & rho0, const double rho0max) const;
+  // then purging and cooling down to T=Tstop
+  void purgeAndCool(track_t & tks, vertex_t & y, double & beta, double & rho0) const;
     
   
 private:
@@ -211,6 +221,10 @@ private:
   double zmerge_;
   double betapurge_;
 
+  bool runInBlocks_;
+  unsigned int block_size_;
+  double overlap_frac_;
+
 };
 
 
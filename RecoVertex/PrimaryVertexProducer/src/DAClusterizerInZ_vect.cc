@@ -1,5 +1,6 @@
 #include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZ_vect.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 #include "DataFormats/GeometryCommonDetAlgo/interface/Measurement1D.h"
 #include "RecoVertex/VertexPrimitives/interface/VertexException.h"
 
@@ -10,6 +11,8 @@
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
 
+#include "tbb/parallel_for.h"
+
 using namespace std;
 
 DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
@@ -39,6 +42,15 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
   dzCutOff_ = conf.getParameter<double> ("dzCutOff");
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
+  runInBlocks_ = conf.exists("runInBlocks") ? conf.getParameter<bool>("runInBlocks") : false;
+  block_size_ = conf.exists("block_size") ? conf.getParameter<unsigned int>("block_size") : 512;
+  overlap_frac_ = conf.exists("overlap_frac") ? conf.getParameter<double>("overlap_frac") : 0.5;
+  if (block_size_ == 0) {
+    throw cms::Exception("Configuration") << "DAClusterizerInZ_vect: block_size must be positive";
+  }
+  if (!(overlap_frac_ >= 0. && overlap_frac_ < 1.)) {
+    throw cms::Exception("Configuration") << "DAClusterizerInZ_vect: overlap_frac must be in [0,1), got " << overlap_frac_;
+  }
 
   if(verbose_){
     std::cout << "DAClusterizerinZ_vect: mintrkweight = " << mintrkweight_ << std::endl;
@@ -51,6 +63,9 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
     std::cout << "DAClusterizerinZ_vect: coolingFactor = " << coolingFactor_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: d0CutOff = " << d0CutOff_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: dzCutOff = " << dzCutOff_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: runInBlocks = " << runInBlocks_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: block_size = " << block_size_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: overlap_frac = " << overlap_frac_ << std::endl;
   }
 
 
@@ -568,18 +583,23 @@ void DAClusterizerInZ_vect::splitAll( vertex_t & y) const {
 
 
 
-vector<TransientVertex> 
-DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, const int verbosity) const {
-  track_t && tks = fill(tracks);
-  tks.ExtractRaw();
-  
-  unsigned int nt = tks.GetSize();
-  double rho0 = 0.0; // start with no outlier rejection
-  
-  vector<TransientVertex> clusters;
-  if (tks.GetSize() == 0) return clusters;
-  
-  vertex_t y; // the vertex prototypes
+void
+DAClusterizerInZ_vect::anneal(track_t & tks, vertex_t & y, double & beta, double & rho0) const {
+  // runs the annealing on the tracks, down to T=Tstop
+  // y must be empty, and is filled with the vertex prototypes
+
+  annealToPurge(tks, y, beta, rho0, 1./tks.GetSize());
+  purgeAndCool(tks, y, beta, rho0);
+}
+
+
+
+void
+DAClusterizerInZ_vect::annealToPurge(track_t & tks, vertex_t & y, double & beta, double & rho0, const double rho0max) const {
+  // runs the annealing on the tracks, down to T=Tpurge
+  // y must be empty, and is filled with the vertex prototypes
+
+  rho0 = 0.0; // start with no outlier rejection
   
   // initialize:single vertex at infinite temperature
   y.AddItem( 0, 1.0);
@@ -588,7 +608,7 @@ DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, con
   
   
   // estimate first critical temperature
-  double beta = beta0(betamax_, tks, y);
+  beta = beta0(betamax_, tks, y);
   if ( verbose_) std::cout << "Beta0 is " << beta << std::endl;
   
   niter = 0;
@@ -651,7 +671,7 @@ DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, con
   
   // switch on outlier rejection at T=Tmin
   if(dzCutOff_ > 0){
-    rho0 = 1./nt;
+    rho0 = rho0max;
     for(unsigned int a=0; a<10; a++){ update(beta, tks, y, true, a*rho0/10);} // adiabatic turn-on
   }
 
@@ -675,8 +695,16 @@ DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, con
     niter = 0;
     while ((update(beta, tks, y, false, rho0) > 1.e-8) && (niter++ < maxIterations_)) {}
   }
+}
 
 
+
+void
+DAClusterizerInZ_vect::purgeAndCool(track_t & tks, vertex_t & y, double & beta, double & rho0) const {
+  // eliminates the insignificant prototypes at T=Tpurge, then cools down to T=Tstop
+
+  int niter = 0;
+
   // eliminate insigificant vertices, this is more restrictive at higher T
   while (purge(y, tks, rho0, beta)) {
     niter = 0;
@@ -701,6 +729,119 @@ DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, con
     std::cout  << "Final result, rho0=" << std::scientific << rho0 << endl;
     dump(beta, y, tks, 2);
   }
+}
+
+
+
+void
+DAClusterizerInZ_vect::annealInBlocks(track_t & tks, vertex_t & y, double & beta, double & rho0) const {
+  // runs the annealing independently, and in parallel, on blocks of tracks of
+  // consecutive z down to T=Tpurge, and combines the vertex prototypes of all
+  // the blocks there. They are then purged and cooled down to T=Tstop on all
+  // the tracks, as in anneal.
+  // y must be empty, and is filled with the vertex prototypes
+
+  const unsigned int nt = tks.GetSize();
+  if (nt <= block_size_) {
+    anneal(tks, y, beta, rho0);
+    return;
+  }
+
+  std::vector<unsigned int> order(nt);
+  for (unsigned int i = 0; i < nt; i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&tks](unsigned int a, unsigned int b){ return tks._z[a] < tks._z[b]; });
+
+  // block ib holds the sorted tracks [first[ib], first[ib]+block_size_), the last block ends with the last track
+  const unsigned int step = std::max(1U, (unsigned int)(block_size_ * (1. - overlap_frac_)));
+  const unsigned int nBlocks = 1 + (nt - block_size_ + step - 1) / step;
+  std::vector<unsigned int> first(nBlocks);
+  for (unsigned int ib = 0; ib < nBlocks; ib++) first[ib] = std::min(ib * step, nt - block_size_);
+
+  // a prototype is kept from the block whose core contains it: the cores
+  // are bounded by the middle of the overlaps of consecutive blocks
+  std::vector<double> zlow(nBlocks + 1);
+  zlow[0] = -std::numeric_limits<double>::max();
+  zlow[nBlocks] = std::numeric_limits<double>::max();
+  for (unsigned int ib = 1; ib < nBlocks; ib++) {
+    zlow[ib] = 0.5 * (tks._z[order[first[ib]]] + tks._z[order[first[ib - 1] + block_size_ - 1]]);
+  }
+
+  // the weights of the prototypes are normalized to the tracks of their block,
+  // sumpi/bsumpi times those normalized to all the tracks
+  double sumpi = 0;
+  for (unsigned int i = 0; i < nt; i++) sumpi += tks._pi[i];
+  std::vector<double> blockSumpi(nBlocks, 0.);
+  for (unsigned int ib = 0; ib < nBlocks; ib++) {
+    for (unsigned int j = first[ib]; j < first[ib] + block_size_; j++) blockSumpi[ib] += tks._pi[order[j]];
+  }
+
+  std::vector<track_t> blockTracks(nBlocks);
+  std::vector<vertex_t> blockVertices(nBlocks);
+  std::vector<double> blockBeta(nBlocks);
+  tbb::parallel_for(0U, nBlocks, [&](unsigned int ib) {
+      auto & btks = blockTracks[ib];
+      for (unsigned int j = first[ib]; j < first[ib] + block_size_; j++) {
+	auto i = order[j];
+	btks.AddItem(tks._z[i], tks._dz2[i], tks.tt[i], tks._pi[i]);
+      }
+      btks.ExtractRaw();
+      // the outlier rejection of all the tracks, 1/nt, in the normalization of the block
+      const double brho0max = blockSumpi[ib] > 0 ? sumpi / (nt * blockSumpi[ib]) : 1./block_size_;
+      double brho0;
+      annealToPurge(btks, blockVertices[ib], blockBeta[ib], brho0, brho0max);
+    });
+
+  beta = 0;
+  for (unsigned int ib = 0; ib < nBlocks; ib++) {
+    const double bsumpi = blockSumpi[ib];
+    auto const & by = blockVertices[ib];
+    for (unsigned int k = 0; k < by.GetSize(); k++) {
+      if ((by._z[k] >= zlow[ib]) && (by._z[k] < zlow[ib + 1])) {
+	y.AddItem(by._z[k], by._pk[k] * bsumpi / sumpi);
+      }
+    }
+    beta = std::max(beta, blockBeta[ib]);
+  }
+
+  if (y.GetSize() == 0) {
+    anneal(tks, y, beta, rho0);
+    return;
+  }
+
+  // let the prototypes of neighbouring blocks find their equilibrium on all
+  // the tracks at T=Tpurge, and merge the ones found by both blocks
+  rho0 = dzCutOff_ > 0 ? 1./nt : 0.;
+  int niter = 0;
+  while ((update(beta, tks, y, true, rho0) > 1.e-8) && (niter++ < maxIterations_)) {}
+  while (merge(y, beta)) {update(beta, tks, y, true, rho0); }
+  if (verbose_) {
+    std::cout  << "dump after merging the prototypes of " << nBlocks << " blocks" << endl;
+    dump(beta, y, tks, 2);
+  }
+
+  purgeAndCool(tks, y, beta, rho0);
+}
+
+
+
+vector<TransientVertex> 
+DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, const int verbosity) const {
+  track_t && tks = fill(tracks);
+  tks.ExtractRaw();
+  
+  unsigned int nt = tks.GetSize();
+  double rho0 = 0.0;
+  double beta = 0.0;
+  
+  vector<TransientVertex> clusters;
+  if (tks.GetSize() == 0) return clusters;
+  
+  vertex_t y; // the vertex prototypes
+  if (runInBlocks_) {
+    annealInBlocks(tks, y, beta, rho0);
+  } else {
+    anneal(tks, y, beta, rho0);
+  }
 
   // select significant tracks and use a TransientVertex as a container
   GlobalError dummyError(0.01, 0, 0.01, 0., 0., 0.01);
@@ -0,0 +1,131 @@
+// Compares DAClusterizerInZ_vect::annealInBlocks with the serial annealing on
+// simulated pileup events, and reports the time taken by both. Both must end
+// at T=Tstop with the outlier rejection of all the tracks.
+//
+// usage: testDAClusterizerInZ_vect [number of events per pileup scenario, default 1]
+
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZ_vect.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  // defaults of TkClusParameters_cff
+  edm::ParameterSet parameters(bool runInBlocks, unsigned int blockSize = 512, double overlapFrac = 0.5) {
+    edm::ParameterSet conf;
+    conf.addParameter<double>("coolingFactor", 0.6);
+    conf.addParameter<double>("Tmin", 2.0);
+    conf.addParameter<double>("Tpurge", 2.0);
+    conf.addParameter<double>("Tstop", 0.5);
+    conf.addParameter<double>("vertexSize", 0.006);
+    conf.addParameter<double>("d0CutOff", 3.);
+    conf.addParameter<double>("dzCutOff", 3.);
+    conf.addParameter<double>("zmerge", 1e-2);
+    conf.addParameter<double>("uniquetrkweight", 0.8);
+    conf.addParameter<bool>("runInBlocks", runInBlocks);
+    conf.addParameter<unsigned int>("block_size", blockSize);
+    conf.addParameter<double>("overlap_frac", overlapFrac);
+    return conf;
+  }
+
+  // the constructor must reject the block parameters the blocks cannot be made with
+  bool rejected(unsigned int blockSize, double overlapFrac) {
+    try {
+      DAClusterizerInZ_vect clusterizer(parameters(true, blockSize, overlapFrac));
+    } catch (cms::Exception const &) {
+      return true;
+    }
+    std::cout << "block_size " << blockSize << " overlap_frac " << overlapFrac << " not rejected" << std::endl;
+    return false;
+  }
+
+  // number of prototypes of a which have a prototype of b within tolerance
+  unsigned int matched(DAClusterizerInZ_vect::vertex_t const & a, DAClusterizerInZ_vect::vertex_t const & b, double tolerance) {
+    unsigned int n = 0;
+    for (unsigned int k = 0; k < a.GetSize(); k++) {
+      auto it = std::lower_bound(b.z.begin(), b.z.end(), a.z[k] - tolerance);
+      if (it != b.z.end() && *it <= a.z[k] + tolerance) n++;
+    }
+    return n;
+  }
+}
+
+int main(int argc, char **argv) {
+  const unsigned int nEvents = argc>1 ? std::atoi(argv[1]) : 1;
+  constexpr double tolerance = 0.01; // cm, as zmerge
+
+  if (!rejected(0, 0.5) || !rejected(512, 1.) || !rejected(512, 1.5) || !rejected(512, -0.1)) return 1;
+
+  DAClusterizerInZ_vect serial(parameters(false));
+  DAClusterizerInZ_vect blocks(parameters(true));
+
+  std::mt19937 rng(12345);
+  std::normal_distribution<double> beamSpot(0., 4.5);
+  std::poisson_distribution<int> nTracksPerVertex(25);
+  std::lognormal_distribution<double> trackError(std::log(0.02), 0.7);
+  std::normal_distribution<double> gauss;
+
+  bool ok = true;
+  for (unsigned int pileup : {50, 140, 200}) {
+    double serialTime = 0.;
+    double blocksTime = 0.;
+    unsigned int nTracks = 0, nSerial = 0, nBlocks = 0, nMatched = 0, nFinalStateDiffers = 0;
+
+    for (unsigned int ievent = 0; ievent < nEvents; ievent++) {
+      DAClusterizerInZ_vect::track_t tks;
+      for (unsigned int iv = 0; iv < pileup; iv++) {
+        const double zv = beamSpot(rng);
+        const int nt = nTracksPerVertex(rng);
+        for (int it = 0; it < nt; it++) {
+          const double dz = trackError(rng);
+          tks.AddItem(zv + dz*gauss(rng), 1./(dz*dz + 0.006*0.006), nullptr, 1.);
+        }
+      }
+      tks.ExtractRaw();
+      nTracks += tks.GetSize();
+
+      DAClusterizerInZ_vect::track_t tks2 = tks;
+      tks2.ExtractRaw();
+      DAClusterizerInZ_vect::vertex_t ys, yb;
+      double betas, rho0s, betab, rho0b;
+
+      auto start = std::chrono::steady_clock::now();
+      serial.anneal(tks, ys, betas, rho0s);
+      auto stop = std::chrono::steady_clock::now();
+      serialTime += std::chrono::duration<double>(stop-start).count();
+
+      start = std::chrono::steady_clock::now();
+      blocks.annealInBlocks(tks2, yb, betab, rho0b);
+      stop = std::chrono::steady_clock::now();
+      blocksTime += std::chrono::duration<double>(stop-start).count();
+
+      nSerial += ys.GetSize();
+      nBlocks += yb.GetSize();
+      nMatched += matched(ys, yb, tolerance);
+      if (betab != betas || rho0b != rho0s) {
+        std::cout << "  event " << ievent << ": blocks end at beta " << betab << ", rho0 " << rho0b
+                  << " instead of beta " << betas << ", rho0 " << rho0s << std::endl;
+        nFinalStateDiffers++;
+      }
+    }
+
+    std::cout << "pileup " << pileup << ", " << nTracks/nEvents << " tracks per event" << std::endl
+              << "  serial " << serialTime*1e3/nEvents << " ms per event, " << nSerial << " prototypes" << std::endl
+              << "  blocks " << blocksTime*1e3/nEvents << " ms per event, " << nBlocks << " prototypes, "
+              << nMatched << " serial prototypes matched within " << tolerance << " cm" << std::endl;
+
+    // the blocks see different tracks at high temperature, so that a few
+    // prototypes close to each other may be split or merged differently
+    if (nMatched < 0.95*nSerial || std::abs(double(nBlocks) - double(nSerial)) > 0.05*nSerial) ok = false;
+    if (nFinalStateDiffers > 0) ok = false;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// Converts a HF shower library from ROOT to the binary file mapped by
+// HFShowerLibraryFile (HFShowerLibrary.BinaryFileName in g4SimHits).
+// The branches are read as in HFShowerLibrary; the optional arguments
+// correspond to its BranchEvt, BranchPre, BranchPost, TreeEMID and
+// TreeHadID parameters, with the defaults of g4SimHits.
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerLibraryEventInfo.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
+#include "FWCore/FWLite/interface/FWLiteEnabler.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // reads entry of branch as HFShowerLibrary::getRecord does
+  void readRecord(TBranch* branch, int entry, bool newForm, bool v3version,
+                  HFShowerPhotonCollection& photons) {
+    photons.clear();
+    if (newForm && v3version) {
+      std::vector<float> t;
+      std::vector<float>* tp = &t;
+      branch->SetAddress(&tp);
+      branch->GetEntry(entry);
+      unsigned int tSize = t.size() / 5;
+      for (unsigned int i = 0; i < tSize; i++)
+        photons.push_back(HFShowerPhoton(t[i], t[1 * tSize + i], t[2 * tSize + i], t[3 * tSize + i], t[4 * tSize + i]));
+    } else if (newForm) {
+      HFShowerPhotonCollection* photo = &photons;
+      branch->SetAddress(&photo);
+      branch->GetEntry(entry);
+    } else {
+      branch->SetAddress(&photons);
+      branch->GetEntry(entry);
+    }
+  }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " library.root library.bin"
+              << " [BranchEvt BranchPre BranchPost TreeEMID TreeHadID]" << std::endl;
+    return 1;
+  }
+  std::string branchEvInfo = argc > 3 ? argv[3] : "";
+  std::string branchPre = argc > 4 ? argv[4] : "";
+  std::string branchPost = argc > 5 ? argv[5] : "";
+  std::string emName = argc > 6 ? argv[6] : "emParticles";
+  std::string hadName = argc > 7 ? argv[7] : "hadParticles";
+
+  FWLiteEnabler::enable();
+
+  TFile* hf = TFile::Open(argv[1]);
+  if (hf == nullptr || !hf->IsOpen()) {
+    std::cerr << "Opening of " << argv[1] << " fails" << std::endl;
+    return 1;
+  }
+  bool newForm = branchEvInfo.empty();
+  TTree* event = (TTree*)hf->Get(newForm ? "HFSimHits" : "Events");
+  if (event == nullptr) {
+    std::cerr << "Events tree absent" << std::endl;
+    return 1;
+  }
+
+  HFShowerLibraryFile::Info info = HFShowerLibraryFile::hardwiredInfo();
+  if (!newForm) {
+    TBranch* evtInfo = event->GetBranch((branchEvInfo + branchPost).c_str());
+    if (evtInfo == nullptr) {
+      std::cerr << "Event information absent" << std::endl;
+      return 1;
+    }
+    std::vector<HFShowerLibraryEventInfo> eventInfoCollection;
+    evtInfo->SetAddress(&eventInfoCollection);
+    evtInfo->GetEntry(0);
+    info.totEvents = eventInfoCollection[0].totalEvents();
+    info.nMomBin = eventInfoCollection[0].numberOfBins();
+    info.evtPerBin = eventInfoCollection[0].eventsPerBin();
+    info.libVers = eventInfoCollection[0].showerLibraryVersion();
+    info.listVersion = eventInfoCollection[0].physListVersion();
+    info.pmom = eventInfoCollection[0].energyBins();
+  }
+
+  TBranch* emBranch = event->GetBranch((branchPre + emName + branchPost).c_str());
+  TBranch* hadBranch = event->GetBranch((branchPre + hadName + branchPost).c_str());
+  if (emBranch == nullptr || hadBranch == nullptr) {
+    std::cerr << "Branches " << emName << " or " << hadName << " absent" << std::endl;
+    return 1;
+  }
+  bool v3version = (emBranch->GetClassName() == std::string("vector<float>"));
+
+  HFShowerLibraryFile::Writer writer(argv[2], info);
+  HFShowerPhotonCollection photons;
+  unsigned long nPhotons = 0;
+  for (int type = 0; type < 2; ++type) {
+    for (int nrc = 0; nrc < info.totEvents; ++nrc) {
+      if (type == 0)
+        readRecord(emBranch, nrc, newForm, v3version, photons);
+      else
+        readRecord(hadBranch, newForm ? nrc + info.totEvents : nrc, newForm, v3version, photons);
+      writer.addRecord(photons);
+      nPhotons += photons.size();
+    }
+  }
+  writer.close();
+  hf->Close();
+
+  std::cout << "Wrote " << 2 * info.totEvents << " records with " << nPhotons << " photons to " << argv[2]
+            << std::endl;
+  return 0;
+}
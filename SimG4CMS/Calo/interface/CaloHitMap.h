@@ -0,0 +1,68 @@
+#ifndef SimG4CMS_CaloHitMap_h
+#define SimG4CMS_CaloHitMap_h
+///////////////////////////////////////////////////////////////////////////////
+// File: CaloHitMap.h
+// Description: Open addressing hash map from CaloHitID to the CaloG4Hit
+//              of the current event, used by CaloSD to find existing hits.
+//              Keys are the fields compared by CaloHitID::operator< (unit,
+//              depth, track, time slice), so two IDs are the same key
+//              exactly when they would be in a std::map<CaloHitID,...>.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/CaloHitID.h"
+
+#include <cstdint>
+#include <vector>
+
+class CaloG4Hit;
+
+class CaloHitMap {
+
+public:
+
+  CaloHitMap();
+
+  // the hit stored for id, nullptr if none
+  CaloG4Hit*   find(const CaloHitID& id) const;
+  // does nothing if id is already there (as std::map::insert); hit != nullptr
+  void         insert(const CaloHitID& id, CaloG4Hit* hit);
+  void         erase(const CaloHitID& id);
+  // removes all hits, keeping the table for the next event
+  void         clear();
+
+  unsigned int size() const { return theSize; }
+  bool         empty() const { return theSize == 0; }
+
+private:
+
+  struct Key {
+    uint32_t   unit;
+    int32_t    track;
+    int32_t    timeSlice;
+    uint32_t   depth;
+    bool operator==(const Key& k) const {
+      return unit == k.unit && track == k.track && timeSlice == k.timeSlice && depth == k.depth;
+    }
+  };
+
+  // a slot is empty when hit == nullptr
+  struct Slot {
+    Key        key;
+    CaloG4Hit* hit;
+  };
+
+  static Key      makeKey(const CaloHitID& id);
+  static uint64_t hash(const Key& key);
+
+  unsigned int    home(const Key& key) const { return hash(key) & theMask; }
+  // slot holding key, or the empty slot where it would go
+  unsigned int    lookup(const Key& key) const;
+  void            rehash(unsigned int nSlots);
+
+  std::vector<Slot> theSlots;
+  unsigned int      theMask;
+  unsigned int      theSize;
+
+};
+
+#endif
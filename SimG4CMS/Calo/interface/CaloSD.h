@@ -9,6 +9,7 @@
 
 #include "SimG4CMS/Calo/interface/CaloG4Hit.h"
 #include "SimG4CMS/Calo/interface/CaloG4HitCollection.h"
+#include "SimG4CMS/Calo/interface/CaloHitMap.h"
 #include "SimG4CMS/Calo/interface/CaloMeanResponse.h"
 #include "SimG4Core/Notification/interface/Observer.h"
 #include "SimG4Core/Notification/interface/BeginOfRun.h"
@@ -26,7 +27,7 @@
 #include "G4VGFlashSensitiveDetector.hh"
 
 #include <vector>
-#include <map>
+#include <unordered_map>
 
 class G4Step;
 class G4HCofThisEvent;
@@ -165,8 +166,8 @@ private:
   double                          eminHitD;
   double                          correctT;
 
-  std::map<CaloHitID,CaloG4Hit*>  hitMap;
-  std::map<int,TrackWithHistory*> tkMap;
+  CaloHitMap                      hitMap;
+  std::unordered_map<int,TrackWithHistory*> tkMap;
 
   std::vector<CaloG4Hit*>         reusehit;
   std::vector<CaloG4Hit*>         hitvec;
@@ -25,6 +25,8 @@
 
 class EcalBaseNumber;
 class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VTouchable;
 class EnergyResolutionVsLumi;
 
 class ECalSD : public CaloSD {
@@ -52,6 +54,8 @@ private:
   double                    curve_LY(const G4LogicalVolume*);  
 
   void                      getBaseNumber(const G4Step*); 
+  bool                      sameVolumeHistory(const G4VTouchable*);
+  void                      setVolumeInfo(const G4LogicalVolume*);
   double                    getBirkL3(const G4Step*);
 
   std::vector<double>               getDDDArray(const std::string&,
@@ -79,6 +83,15 @@ private:
   double                            crystalLength;
   double                            crystalDepth;
   uint16_t                          depth;
+
+  // consecutive steps mostly stay in the same crystal: the unit ID and the
+  // properties of the logical volume of the last step are kept
+  std::vector<std::pair<const G4VPhysicalVolume*,int> > lastHistory;
+  uint32_t                          lastUnitID;
+  const G4LogicalVolume*            lastLV;
+  bool                              lastInXtalMap, lastNoWeight;
+  double                            lastXtalL;
+  uint16_t                          lastDepth;
  
 #ifdef plotDebug
   TH2F                             *g2L_[4];
@@ -9,6 +9,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "Geometry/HcalCommonData/interface/HcalDDDSimConstants.h"
 #include "SimG4CMS/Calo/interface/HFFibre.h"
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
 #include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
 #include "DetectorDescription/Core/interface/DDsvalues.h"
 
@@ -66,6 +67,8 @@ private:
   HFFibre *           fibre;
   TFile *             hf;
   TBranch             *emBranch, *hadBranch;
+  // mapped binary library, used instead of the ROOT file when given
+  std::shared_ptr<const HFShowerLibraryFile> binaryLib;
 
   bool                verbose, applyFidCut, newForm, v3version;
   int                 nMomBin, totEvents, evtPerBin;
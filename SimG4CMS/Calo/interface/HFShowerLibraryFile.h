@@ -0,0 +1,91 @@
+#ifndef SimG4CMS_HFShowerLibraryFile_h
+#define SimG4CMS_HFShowerLibraryFile_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryFile.h
+// Description: Read-only memory mapped view of a HF shower library converted
+//              to a flat binary file (see bin/HFShowerLibraryConverter.cpp).
+//              The file is mapped once per process and shared by all the
+//              HFShowerLibrary instances (one per Geant4 worker thread).
+//
+// Layout: header, energy bins, records, record offsets. A record keeps the
+// x, y, z, lambda and t of its photons as five consecutive float columns,
+// as in the vector<float> branches of the v3 libraries. Records are the
+// totEvents EM showers followed by the totEvents hadronic ones.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class HFShowerLibraryFile {
+
+public:
+
+  struct Info {
+    int                 nMomBin;
+    int                 evtPerBin;
+    int                 totEvents;
+    float               libVers;
+    float               listVersion;
+    std::vector<double> pmom;        // in GeV
+  };
+
+  // the numbers assumed by HFShowerLibrary for libraries without event info
+  static Info hardwiredInfo();
+
+  // maps fileName, or returns the mapping already made in this process
+  static std::shared_ptr<const HFShowerLibraryFile> open(const std::string& fileName);
+
+  ~HFShowerLibraryFile();
+
+  const Info&  info() const { return info_; }
+
+  // photons of record (counted from 0) of type 0 (EM) or 1 (hadronic),
+  // appended to photons
+  void         getRecord(int type, int record, HFShowerPhotonCollection& photons) const;
+
+  class Writer {
+  public:
+    Writer(const std::string& fileName, const Info& info);
+    ~Writer();
+    // records must be added in the order of the layout above
+    void addRecord(const HFShowerPhotonCollection& photons);
+    // writes the offsets, completing the file
+    void close();
+  private:
+    std::ofstream         file_;
+    std::vector<uint64_t> offsets_;
+    bool                  closed_;
+  };
+
+private:
+
+  struct Header {
+    char     magic[8];
+    uint32_t nMomBin;
+    uint32_t evtPerBin;
+    uint32_t totEvents;
+    uint32_t nRecords;
+    float    libVers;
+    float    listVersion;
+    uint64_t offsetsPos;    // byte position of the record offsets
+  };
+
+  explicit HFShowerLibraryFile(const std::string& fileName);
+
+  // empty if the header and the record offsets of the mapped file are
+  // consistent, so that getRecord stays within the mapping, else the reason
+  std::string checkLayout(const Header& header) const;
+
+  Info             info_;
+  const char*      data_;
+  size_t           size_;
+  const uint64_t*  offsets_; // byte position of record i, for i <= nRecords
+  unsigned int     nRecords_;
+
+};
+#endif
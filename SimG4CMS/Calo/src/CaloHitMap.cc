@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: CaloHitMap.cc
+// Description: Open addressing (linear probing) map of the hits of an event
+///////////////////////////////////////////////////////////////////////////////
+#include "SimG4CMS/Calo/interface/CaloHitMap.h"
+
+#include <cassert>
+
+namespace {
+  // initial size of the table, which is kept at most half full
+  constexpr unsigned int minSlots = 256;
+}
+
+CaloHitMap::CaloHitMap() : theMask(0), theSize(0) {}
+
+CaloHitMap::Key CaloHitMap::makeKey(const CaloHitID& id) {
+  return Key{id.unitID(), id.trackID(), id.timeSliceID(), id.depth()};
+}
+
+uint64_t CaloHitMap::hash(const Key& key) {
+  uint64_t h = (uint64_t(key.unit) << 32) | uint32_t(key.track);
+  h ^= ((uint64_t(uint32_t(key.timeSlice)) << 16) | key.depth) * 0x9e3779b97f4a7c15ULL;
+  // final mixing of MurmurHash3
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+unsigned int CaloHitMap::lookup(const Key& key) const {
+  unsigned int i = home(key);
+  while (theSlots[i].hit != nullptr && !(theSlots[i].key == key)) i = (i+1) & theMask;
+  return i;
+}
+
+CaloG4Hit* CaloHitMap::find(const CaloHitID& id) const {
+  if (theSize == 0) return nullptr;
+  return theSlots[lookup(makeKey(id))].hit;
+}
+
+void CaloHitMap::insert(const CaloHitID& id, CaloG4Hit* hit) {
+  assert(hit != nullptr);
+  if (2*(theSize+1) > theSlots.size())
+    rehash(theSlots.empty() ? minSlots : 2*theSlots.size());
+  Key key = makeKey(id);
+  Slot& slot = theSlots[lookup(key)];
+  if (slot.hit == nullptr) {
+    slot.key = key;
+    slot.hit = hit;
+    ++theSize;
+  }
+}
+
+void CaloHitMap::erase(const CaloHitID& id) {
+  if (theSize == 0) return;
+  unsigned int i = lookup(makeKey(id));
+  if (theSlots[i].hit == nullptr) return;
+
+  // backward shift deletion: move up the following entries of the cluster
+  // which would not be found any more with a hole at i
+  unsigned int j = i;
+  while (true) {
+    j = (j+1) & theMask;
+    if (theSlots[j].hit == nullptr) break;
+    unsigned int k = home(theSlots[j].key);
+    bool movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+    if (movable) {
+      theSlots[i] = theSlots[j];
+      i = j;
+    }
+  }
+  theSlots[i].hit = nullptr;
+  --theSize;
+}
+
+void CaloHitMap::clear() {
+  if (theSize == 0) return;
+  for (auto& slot : theSlots) slot.hit = nullptr;
+  theSize = 0;
+}
+
+void CaloHitMap::rehash(unsigned int nSlots) {
+  std::vector<Slot> old(nSlots, Slot{Key{0, 0, 0, 0}, nullptr});
+  old.swap(theSlots);
+  theMask = nSlots - 1;
+  for (const auto& slot : old) {
+    if (slot.hit != nullptr) theSlots[lookup(slot.key)] = slot;
+  }
+}
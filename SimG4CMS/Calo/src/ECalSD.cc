@@ -44,7 +44,7 @@ ECalSD::ECalSD(const std::string& name, const DDCompactView & cpv,
   CaloSD(name, cpv, clg, p, manager, 
          (float)(p.getParameter<edm::ParameterSet>("ECalSD").getParameter<double>("TimeSliceUnit")),
          p.getParameter<edm::ParameterSet>("ECalSD").getParameter<bool>("IgnoreTrackID")), 
-  numberingScheme(nullptr){
+  numberingScheme(nullptr), lastUnitID(0), lastLV(nullptr) {
 
   //   static SimpleConfigurable<bool>   on1(false,  "ECalSD:UseBirkLaw");
   //   static SimpleConfigurable<double> bk1(0.00463,"ECalSD:BirkC1");
@@ -194,8 +194,9 @@ double ECalSD::getEnergyDeposit(const G4Step * aStep) {
     }
   }
   const G4LogicalVolume* lv = preStepPoint->GetTouchable()->GetVolume(0)->GetLogicalVolume();
+  setVolumeInfo(lv);
   double wt1 = 1.0;
-  if (useWeight && !any(noWeight,lv)) {
+  if (useWeight && !lastNoWeight) {
     weight *= curve_LY(lv);
     if (useBirk) {
       if (useBirkL3) weight *= getBirkL3(aStep);
@@ -234,15 +235,15 @@ uint16_t ECalSD::getDepth(const G4Step * aStep) {
   currentLocalPoint = setToLocal(hitPoint->GetPosition(), hitPoint->GetTouchable());
   const G4LogicalVolume* lv = hitPoint->GetTouchable()->GetVolume(0)->GetLogicalVolume();
 
-  auto ite = xtalLMap.find(lv);
-  crystalLength = (ite == xtalLMap.end()) ? 230.0 : std::abs(ite->second);
-  crystalDepth = (ite == xtalLMap.end()) 
-    ? 0.0 : (std::abs(0.5*(ite->second)+currentLocalPoint.z()));
-  depth = any(useDepth1,lv) ? 1 : (any(useDepth2,lv) ? 2 : 0);
+  setVolumeInfo(lv);
+  crystalLength = (!lastInXtalMap) ? 230.0 : std::abs(lastXtalL);
+  crystalDepth = (!lastInXtalMap) 
+    ? 0.0 : (std::abs(0.5*lastXtalL+currentLocalPoint.z()));
+  depth = lastDepth;
 
   if (storeRL) {
-    uint16_t depth1 = (ite == xtalLMap.end()) ? 0 : (((ite->second) >= 0) ? 0 :
-                                                     PCaloHit::kEcalDepthRefz);
+    uint16_t depth1 = (!lastInXtalMap) ? 0 : ((lastXtalL >= 0) ? 0 :
+                                              PCaloHit::kEcalDepthRefz);
     uint16_t depth2 = getRadiationLength(hitPoint, lv);
     depth          |= (((depth2&PCaloHit::kEcalDepthMask) << PCaloHit::kEcalDepthOffset) | depth1);
   } else if (storeLayerTimeSim) {
@@ -252,7 +253,7 @@ uint16_t ECalSD::getDepth(const G4Step * aStep) {
 #ifdef EDM_ML_DEBUG
   edm::LogVerbatim("EcalSim") << "ECalSD::Depth " << std::hex << depth1 << ":"
                               << depth2 << ":" << depth << std::dec << " L "
-                              << (ite == xtalLMap.end()) << ":" <<ite->second;
+                              << (!lastInXtalMap) << ":" << lastXtalL;
 #endif
   return depth;
 }
@@ -298,8 +299,13 @@ uint32_t ECalSD::setDetUnitId(const G4Step * aStep) {
   if (numberingScheme == nullptr) {
     return EBDetId(1,1)();
   } else {
-    getBaseNumber(aStep);
-    return numberingScheme->getUnitID(theBaseNumber);
+    // the ID only depends on the volume history: a step in the same
+    // volume as the previous one does not rebuild the base number
+    if (!sameVolumeHistory(aStep->GetPreStepPoint()->GetTouchable())) {
+      getBaseNumber(aStep);
+      lastUnitID = numberingScheme->getUnitID(theBaseNumber);
+    }
+    return lastUnitID;
   }
 }
 
@@ -308,6 +314,7 @@ void ECalSD::setNumberingScheme(EcalNumberingScheme* scheme) {
     edm::LogVerbatim("EcalSim") << "EcalSD: updates numbering scheme for " 
                             << GetName();
     if (numberingScheme) delete numberingScheme;
+    lastHistory.clear();
     numberingScheme = scheme;
   }
 }
@@ -473,6 +480,33 @@ void ECalSD::getBaseNumber(const G4Step* aStep) {
   }
 }
 
+bool ECalSD::sameVolumeHistory(const G4VTouchable* touch) {
+
+  int theSize = touch->GetHistoryDepth()+1;
+  bool same = ((int)(lastHistory.size()) == theSize);
+  for (int ii = 0; same && ii < theSize; ii++) 
+    same = (lastHistory[ii].first  == touch->GetVolume(ii) &&
+            lastHistory[ii].second == touch->GetReplicaNumber(ii));
+  if (!same) {
+    lastHistory.resize(theSize);
+    for (int ii = 0; ii < theSize; ii++) 
+      lastHistory[ii] = std::pair<const G4VPhysicalVolume*,int>(touch->GetVolume(ii),touch->GetReplicaNumber(ii));
+  }
+  return same;
+}
+
+void ECalSD::setVolumeInfo(const G4LogicalVolume* lv) {
+
+  if (lv != lastLV) {
+    auto ite      = xtalLMap.find(lv);
+    lastInXtalMap = (ite != xtalLMap.end());
+    lastXtalL     = lastInXtalMap ? ite->second : 0;
+    lastDepth     = any(useDepth1,lv) ? 1 : (any(useDepth2,lv) ? 2 : 0);
+    lastNoWeight  = any(noWeight,lv);
+    lastLV        = lv;
+  }
+}
+
 double ECalSD::getBirkL3(const G4Step* aStep) {
 
   double weight = 1.;
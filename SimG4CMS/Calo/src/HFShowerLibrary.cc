@@ -44,6 +44,33 @@ HFShowerLibrary::HFShowerLibrary(const std::string & name, const DDCompactView &
   std::string branchPost   = m_HS.getUntrackedParameter<std::string>("BranchPost","_R.obj");
   verbose                  = m_HS.getUntrackedParameter<bool>("Verbosity",false);
   applyFidCut              = m_HS.getParameter<bool>("ApplyFiducialCut");
+  std::string binaryName   = m_HS.getUntrackedParameter<std::string>("BinaryFileName","");
+
+  fibre = new HFFibre(name, cpv, p);
+  photo = new HFShowerPhotonCollection;
+
+  if (!binaryName.empty()) {
+    // shared by all threads, records are read directly from the mapped file
+    binaryLib = HFShowerLibraryFile::open(edm::FileInPath(binaryName).fullPath());
+    const HFShowerLibraryFile::Info & info = binaryLib->info();
+    totEvents   = info.totEvents;
+    nMomBin     = info.nMomBin;
+    evtPerBin   = info.evtPerBin;
+    libVers     = info.libVers;
+    listVersion = info.listVersion;
+    pmom        = info.pmom;
+    for (int i=0; i<nMomBin; i++) 
+      pmom[i] *= GeV;
+    newForm   = true;
+    v3version = true;
+    edm::LogVerbatim("HFShower") << "HFShowerLibrary: Library " << libVers 
+                                 << " ListVersion " << listVersion 
+                                 << " Events Total " << totEvents << " and " 
+                                 << evtPerBin << " per bin from " << binaryName
+                                 << "\n Maximum probability cut off " << probMax
+                                 << "  Back propagation of light prob. " << backProb;
+    return;
+  }
 
   if (pTreeName.find(".") == 0) pTreeName.erase(0,2);
   const char* nTree = pTreeName.c_str();
@@ -116,9 +143,6 @@ HFShowerLibrary::HFShowerLibrary(const std::string & name, const DDCompactView &
                            << "\n Maximum probability cut off " 
                            << probMax << "  Back propagation of light prob. "
                            << backProb;
-  
-  fibre = new HFFibre(name, cpv, p);
-  photo = new HFShowerPhotonCollection;
 }
 
 HFShowerLibrary::~HFShowerLibrary() {
@@ -370,7 +394,9 @@ void HFShowerLibrary::getRecord(int type, int record) {
   int nrc     = record-1;
   photon.clear();
   photo->clear();
-  if (type > 0) {
+  if (binaryLib) {
+    binaryLib->getRecord((type > 0) ? 1 : 0, nrc, *photo);
+  } else if (type > 0) {
     if (newForm) {
       if ( !v3version ) {
         hadBranch->SetAddress(&photo);
@@ -442,12 +468,13 @@ void HFShowerLibrary::loadEventInfo(TBranch* branch) {
   } else {
     edm::LogVerbatim("HFShower") << "HFShowerLibrary::loadEventInfo loads "
                              << " EventInfo from hardwired numbers";
-    nMomBin     = 16;
-    evtPerBin   = 5000;
-    totEvents   = nMomBin*evtPerBin;
-    libVers     = 1.1;
-    listVersion = 3.6;
-    pmom        = {2,3,5,7,10,15,20,30,50,75,100,150,250,350,500,1000};
+    HFShowerLibraryFile::Info info = HFShowerLibraryFile::hardwiredInfo();
+    nMomBin     = info.nMomBin;
+    evtPerBin   = info.evtPerBin;
+    totEvents   = info.totEvents;
+    libVers     = info.libVers;
+    listVersion = info.listVersion;
+    pmom        = info.pmom;
   }
   for (int i=0; i<nMomBin; i++) 
     pmom[i] *= GeV;
@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryFile.cc
+// Description: Memory mapped HF shower library
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  const char magicWord[8] = {'H','F','S','H','L','I','B','1'};
+}
+
+HFShowerLibraryFile::Info HFShowerLibraryFile::hardwiredInfo() {
+  Info info;
+  info.nMomBin     = 16;
+  info.evtPerBin   = 5000;
+  info.totEvents   = info.nMomBin*info.evtPerBin;
+  info.libVers     = 1.1;
+  info.listVersion = 3.6;
+  info.pmom        = {2,3,5,7,10,15,20,30,50,75,100,150,250,350,500,1000};
+  return info;
+}
+
+std::shared_ptr<const HFShowerLibraryFile> HFShowerLibraryFile::open(const std::string& fileName) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const HFShowerLibraryFile> > files;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  std::weak_ptr<const HFShowerLibraryFile>& entry = files[fileName];
+  std::shared_ptr<const HFShowerLibraryFile> file = entry.lock();
+  if (!file) {
+    file.reset(new HFShowerLibraryFile(fileName));
+    entry = file;
+  }
+  return file;
+}
+
+HFShowerLibraryFile::HFShowerLibraryFile(const std::string& fileName) :
+  data_(nullptr), size_(0), offsets_(nullptr), nRecords_(0) {
+
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw cms::Exception("Unknown", "HFShowerLibraryFile")
+      << "Opening of " << fileName << " fails\n";
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(Header)) {
+    size_ = st.st_size;
+    void* map = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (map != MAP_FAILED) data_ = static_cast<const char*>(map);
+  }
+  ::close(fd);
+  if (data_ == nullptr) {
+    throw cms::Exception("Unknown", "HFShowerLibraryFile")
+      << "Mapping of " << fileName << " fails\n";
+  }
+  // showers are picked at random
+  madvise(const_cast<char*>(data_), size_, MADV_RANDOM);
+
+  const Header* header = reinterpret_cast<const Header*>(data_);
+  std::string error = checkLayout(*header);
+  if (!error.empty()) {
+    munmap(const_cast<char*>(data_), size_);
+    throw cms::Exception("Unknown", "HFShowerLibraryFile")
+      << fileName << " is not a valid shower library file: " << error << "\n";
+  }
+  nRecords_ = header->nRecords;
+
+  info_.nMomBin     = header->nMomBin;
+  info_.evtPerBin   = header->evtPerBin;
+  info_.totEvents   = header->totEvents;
+  info_.libVers     = header->libVers;
+  info_.listVersion = header->listVersion;
+  const double* pmom = reinterpret_cast<const double*>(data_ + sizeof(Header));
+  info_.pmom.assign(pmom, pmom + info_.nMomBin);
+  offsets_ = reinterpret_cast<const uint64_t*>(data_ + header->offsetsPos);
+
+  edm::LogVerbatim("HFShower") << "HFShowerLibraryFile: mapped " << fileName
+                               << " (" << size_ << " bytes) with " << nRecords_
+                               << " records";
+}
+
+std::string HFShowerLibraryFile::checkLayout(const Header& header) const {
+  if (std::memcmp(header.magic, magicWord, sizeof(magicWord)) != 0)
+    return "wrong magic word";
+  // HFShowerLibrary picks the showers of an energy bin among its evtPerBin ones
+  if (header.nMomBin == 0 || header.evtPerBin == 0 ||
+      uint64_t(header.nMomBin)*header.evtPerBin > header.totEvents)
+    return "inconsistent energy bins";
+  // the records follow the energy bins, the offsets follow the records
+  uint64_t recordsPos = sizeof(Header) + uint64_t(header.nMomBin)*sizeof(double);
+  uint64_t nOffsets = uint64_t(header.nRecords) + 1;
+  if (header.offsetsPos % sizeof(uint64_t) != 0 || header.offsetsPos < recordsPos ||
+      header.offsetsPos > size_ || nOffsets > (size_ - header.offsetsPos)/sizeof(uint64_t))
+    return "record offsets outside of the file";
+  if (header.nRecords < 2*uint64_t(header.totEvents))
+    return "fewer records than showers";
+  // every record must lie between the energy bins and the offsets, and hold
+  // a whole number of photons
+  const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data_ + header.offsetsPos);
+  if (offsets[0] != recordsPos || offsets[header.nRecords] > header.offsetsPos)
+    return "records outside of the file";
+  for (uint32_t i = 0; i < header.nRecords; ++i) {
+    if (offsets[i+1] < offsets[i] || (offsets[i+1] - offsets[i]) % (5*sizeof(float)) != 0)
+      return "record " + std::to_string(i) + " has an invalid length";
+  }
+  return std::string();
+}
+
+HFShowerLibraryFile::~HFShowerLibraryFile() {
+  munmap(const_cast<char*>(data_), size_);
+}
+
+void HFShowerLibraryFile::getRecord(int type, int record,
+                                    HFShowerPhotonCollection& photons) const {
+  unsigned int i = type*info_.totEvents + record;
+  if (type < 0 || type > 1 || record < 0 || record >= info_.totEvents) {
+    throw cms::Exception("Unknown", "HFShowerLibraryFile")
+      << "Record " << record << " of type " << type << " out of range\n";
+  }
+  const float* column = reinterpret_cast<const float*>(data_ + offsets_[i]);
+  unsigned int n = (offsets_[i+1] - offsets_[i]) / (5*sizeof(float));
+  photons.reserve(photons.size() + n);
+  for (unsigned int j = 0; j < n; ++j) {
+    photons.push_back(HFShowerPhoton(column[j], column[n+j], column[2*n+j],
+                                     column[3*n+j], column[4*n+j]));
+  }
+}
+
+HFShowerLibraryFile::Writer::Writer(const std::string& fileName, const Info& info) :
+  file_(fileName, std::ios::binary | std::ios::trunc), closed_(false) {
+
+  if (!file_) {
+    throw cms::Exception("Unknown", "HFShowerLibraryFile")
+      << "Opening of " << fileName << " for writing fails\n";
+  }
+  // the header is written again with the number of records by close()
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, magicWord, sizeof(magicWord));
+  header.nMomBin     = info.nMomBin;
+  header.evtPerBin   = info.evtPerBin;
+  header.totEvents   = info.totEvents;
+  header.libVers     = info.libVers;
+  header.listVersion = info.listVersion;
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file_.write(reinterpret_cast<const char*>(info.pmom.data()),
+              info.nMomBin*sizeof(double));
+  offsets_.push_back(file_.tellp());
+}
+
+HFShowerLibraryFile::Writer::~Writer() {
+  if (!closed_) 
+    edm::LogWarning("HFShower") << "HFShowerLibraryFile: writer not closed, "
+                                << "the file is incomplete";
+}
+
+void HFShowerLibraryFile::Writer::addRecord(const HFShowerPhotonCollection& photons) {
+  unsigned int n = photons.size();
+  std::vector<float> columns(5*n);
+  for (unsigned int j = 0; j < n; ++j) {
+    columns[j]     = photons[j].x();
+    columns[n+j]   = photons[j].y();
+    columns[2*n+j] = photons[j].z();
+    columns[3*n+j] = photons[j].lambda();
+    columns[4*n+j] = photons[j].t();
+  }
+  file_.write(reinterpret_cast<const char*>(columns.data()), columns.size()*sizeof(float));
+  offsets_.push_back(file_.tellp());
+}
+
+void HFShowerLibraryFile::Writer::close() {
+  closed_ = true;
+  // the offsets are aligned to 8 bytes
+  uint64_t pos = offsets_.back();
+  static const char padding[8] = {0,0,0,0,0,0,0,0};
+  file_.write(padding, (8 - pos%8) % 8);
+  uint64_t offsetsPos = file_.tellp();
+  file_.write(reinterpret_cast<const char*>(offsets_.data()),
+              offsets_.size()*sizeof(uint64_t));
+
+  uint32_t nRecords = offsets_.size() - 1;
+  file_.seekp(offsetof(Header, nRecords));
+  file_.write(reinterpret_cast<const char*>(&nRecords), sizeof(nRecords));
+  file_.seekp(offsetof(Header, offsetsPos));
+  file_.write(reinterpret_cast<const char*>(&offsetsPos), sizeof(offsetsPos));
+  file_.close();
+  if (file_.fail()) {
+    throw cms::Exception("Unknown", "HFShowerLibraryFile")
+      << "Writing of the shower library fails\n";
+  }
+}
@@ -0,0 +1,116 @@
+// Compares the hit lookup of CaloSD with CaloHitMap against the former
+// std::map<CaloHitID,CaloG4Hit*> on a toy stream of shower steps: each step
+// looks for the hit of its (unit, depth, track, time slice) and creates it if
+// it is missing, and from time to time part of the hits is dropped, as in
+// CaloSD::cleanHitCollection. Reports the step throughput of both.
+#include "SimG4CMS/Calo/interface/CaloG4Hit.h"
+#include "SimG4CMS/Calo/interface/CaloHitMap.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+  struct Step {
+    CaloHitID id;
+    double edep;
+  };
+
+  std::vector<Step> makeSteps(unsigned int nShowers, unsigned int nStepsPerShower, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> centre(0, 60000);
+    std::normal_distribution<double> spread(0., 2.);
+    std::exponential_distribution<double> time(0.5);
+    std::exponential_distribution<double> edep(10.);
+    std::uniform_int_distribution<int> depth(0, 3);
+    std::vector<Step> steps;
+    steps.reserve(nShowers * nStepsPerShower);
+    for (unsigned int is = 0; is < nShowers; ++is) {
+      uint32_t c = centre(rng);
+      int track = 1 + is;
+      for (unsigned int i = 0; i < nStepsPerShower; ++i) {
+        uint32_t unit = c + int(spread(rng)) * 360 + int(spread(rng));
+        steps.push_back(Step{CaloHitID(unit, time(rng), track, depth(rng)), edep(rng)});
+      }
+    }
+    return steps;
+  }
+
+  CaloG4Hit* find(std::map<CaloHitID, CaloG4Hit*> const& map, CaloHitID const& id) {
+    auto it = map.find(id);
+    return it == map.end() ? nullptr : it->second;
+  }
+  CaloG4Hit* find(CaloHitMap const& map, CaloHitID const& id) { return map.find(id); }
+
+  void insert(std::map<CaloHitID, CaloG4Hit*>& map, CaloHitID const& id, CaloG4Hit* hit) {
+    map.insert(std::pair<CaloHitID, CaloG4Hit*>(id, hit));
+  }
+  void insert(CaloHitMap& map, CaloHitID const& id, CaloG4Hit* hit) { map.insert(id, hit); }
+
+  // returns the energy kept in the hits
+  template <typename Map>
+  double process(std::vector<Step> const& steps, Map& map, std::vector<CaloG4Hit*>& hits) {
+    const unsigned int cleanEvery = 50000;
+    for (unsigned int i = 0; i < steps.size(); ++i) {
+      CaloG4Hit* hit = find(map, steps[i].id);
+      if (hit == nullptr) {
+        hit = new CaloG4Hit;
+        hit->setID(steps[i].id);
+        hits.push_back(hit);
+        insert(map, steps[i].id, hit);
+      }
+      hit->addEnergyDeposit(steps[i].edep, 0.);
+      if ((i + 1) % cleanEvery == 0) {
+        // drop the hits below threshold
+        unsigned int nKept = 0;
+        for (auto h : hits) {
+          if (h->getEnergyDeposit() < 0.05) {
+            map.erase(h->getID());
+            delete h;
+          } else {
+            hits[nKept++] = h;
+          }
+        }
+        hits.resize(nKept);
+      }
+    }
+    double sum = 0;
+    for (auto h : hits) sum += h->getEnergyDeposit();
+    return sum;
+  }
+
+}  // namespace
+
+int main() {
+  std::vector<Step> steps = makeSteps(2000, 1000, 4321);
+
+  int ret = 0;
+  for (int rep = 0; rep < 3; ++rep) {
+    double sum[2], time[2];
+    unsigned int nHits[2];
+    for (int hashed = 0; hashed < 2; ++hashed) {
+      std::map<CaloHitID, CaloG4Hit*> stdMap;
+      CaloHitMap hashMap;
+      std::vector<CaloG4Hit*> hits;
+      auto start = std::chrono::high_resolution_clock::now();
+      sum[hashed] = hashed ? process(steps, hashMap, hits) : process(steps, stdMap, hits);
+      auto stop = std::chrono::high_resolution_clock::now();
+      time[hashed] = std::chrono::duration<double, std::milli>(stop - start).count();
+      nHits[hashed] = hits.size();
+      if ((hashed ? hashMap.size() : stdMap.size()) != hits.size())
+        ret = 1;
+      for (auto h : hits)
+        delete h;
+    }
+    bool same = (sum[0] == sum[1] && nHits[0] == nHits[1]);
+    if (!same)
+      ret = 1;
+    std::cout << steps.size() << " steps, " << nHits[1] << " hits: std::map " << steps.size() / time[0] * 1e-3
+              << " Msteps/s, CaloHitMap " << steps.size() / time[1] * 1e-3 << " Msteps/s"
+              << (same ? "" : " MISMATCH") << std::endl;
+  }
+  return ret;
+}
@@ -0,0 +1,140 @@
+// Writes a small shower library with HFShowerLibraryFile::Writer, maps it
+// and checks that every record reads back unchanged and that the mapping
+// is shared between users of the same file. Truncated or corrupted copies
+// of the file must be refused when they are opened.
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+  // positions of nRecords and offsetsPos in the header of the file
+  constexpr size_t nRecordsPos = 20;
+  constexpr size_t offsetsPosPos = 32;
+
+  template <typename T>
+  T get(const std::vector<char>& bytes, size_t pos) {
+    T value;
+    std::memcpy(&value, bytes.data() + pos, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  void set(std::vector<char>& bytes, size_t pos, T value) {
+    std::memcpy(bytes.data() + pos, &value, sizeof(T));
+  }
+
+  // writes a copy of bytes changed by corrupt, and checks that it cannot be opened
+  bool refused(const std::string& fileName, const std::vector<char>& bytes, const char* what,
+               const std::function<void(std::vector<char>&)>& corrupt) {
+    std::vector<char> copy(bytes);
+    corrupt(copy);
+    std::string copyName = fileName + "." + std::to_string(std::hash<std::string>()(what));
+    std::ofstream(copyName, std::ios::binary).write(copy.data(), copy.size());
+    bool ok = false;
+    try {
+      HFShowerLibraryFile::open(copyName);
+    } catch (const cms::Exception&) {
+      ok = true;
+    }
+    std::remove(copyName.c_str());
+    if (!ok)
+      std::cout << "file with " << what << " not refused" << std::endl;
+    return ok;
+  }
+}
+
+int main() {
+  std::string fileName = "HFShowerLibraryFile_t_" + std::to_string(getpid()) + ".bin";
+
+  HFShowerLibraryFile::Info info = HFShowerLibraryFile::hardwiredInfo();
+  info.evtPerBin = 10;
+  info.totEvents = info.nMomBin * info.evtPerBin;
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> nPhotons(0, 40);
+  std::uniform_real_distribution<float> value(-100.f, 100.f);
+  std::vector<HFShowerPhotonCollection> records(2 * info.totEvents);
+  {
+    HFShowerLibraryFile::Writer writer(fileName, info);
+    for (auto& record : records) {
+      int n = nPhotons(rng);
+      for (int j = 0; j < n; ++j)
+        record.push_back(HFShowerPhoton(value(rng), value(rng), value(rng), value(rng), value(rng)));
+      writer.addRecord(record);
+    }
+    writer.close();
+  }
+
+  int nBad = 0;
+  {
+    auto lib = HFShowerLibraryFile::open(fileName);
+    auto again = HFShowerLibraryFile::open(fileName);
+    if (lib != again) {
+      std::cout << "the mapping is not shared" << std::endl;
+      ++nBad;
+    }
+    if (lib->info().totEvents != info.totEvents || lib->info().pmom != info.pmom)
+      ++nBad;
+    HFShowerPhotonCollection photons;
+    for (int type = 0; type < 2; ++type) {
+      for (int nrc = 0; nrc < info.totEvents; ++nrc) {
+        photons.clear();
+        lib->getRecord(type, nrc, photons);
+        const HFShowerPhotonCollection& ref = records[type * info.totEvents + nrc];
+        bool same = (photons.size() == ref.size());
+        for (unsigned int j = 0; same && j < ref.size(); ++j)
+          same = (photons[j].x() == ref[j].x() && photons[j].y() == ref[j].y() && photons[j].z() == ref[j].z() &&
+                  photons[j].lambda() == ref[j].lambda() && photons[j].t() == ref[j].t());
+        if (!same) {
+          std::cout << "record " << nrc << " of type " << type << " differs" << std::endl;
+          ++nBad;
+        }
+      }
+    }
+  }
+
+  std::ifstream in(fileName, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  const uint32_t nRecords = get<uint32_t>(bytes, nRecordsPos);
+  const uint64_t offsetsPos = get<uint64_t>(bytes, offsetsPosPos);
+  auto offset = [&](uint32_t i) { return offsetsPos + i*sizeof(uint64_t); };
+  // a record with photons, and the one after it
+  uint32_t full = 0;
+  while (get<uint64_t>(bytes, offset(full+1)) == get<uint64_t>(bytes, offset(full))) ++full;
+
+  const std::vector<std::pair<const char*, std::function<void(std::vector<char>&)> > > corruptions = {
+    {"the last offset cut", [&](std::vector<char>& b) { b.resize(b.size() - 4); }},
+    {"the offsets cut", [&](std::vector<char>& b) { b.resize(offsetsPos + 8); }},
+    {"too many records", [&](std::vector<char>& b) { set<uint32_t>(b, nRecordsPos, nRecords + 1); }},
+    {"too few records", [&](std::vector<char>& b) { set<uint32_t>(b, nRecordsPos, nRecords - 1); }},
+    {"misaligned offsets", [&](std::vector<char>& b) { set<uint64_t>(b, offsetsPosPos, offsetsPos - 4); }},
+    {"decreasing offsets", [&](std::vector<char>& b) {
+        set<uint64_t>(b, offset(full+1), get<uint64_t>(b, offset(full)) - 5*sizeof(float)); }},
+    {"a partial photon", [&](std::vector<char>& b) {
+        set<uint64_t>(b, offset(full+1), get<uint64_t>(b, offset(full+1)) - sizeof(float)); }},
+    {"a record over the offsets", [&](std::vector<char>& b) {
+        set<uint64_t>(b, offset(nRecords), offsetsPos + 5*sizeof(float)); }},
+    {"a record over the energy bins", [&](std::vector<char>& b) {
+        set<uint64_t>(b, offset(0), get<uint64_t>(b, offset(0)) - 5*sizeof(float)); }}
+  };
+  for (const auto& corruption : corruptions) {
+    if (!refused(fileName, bytes, corruption.first, corruption.second))
+      ++nBad;
+  }
+  std::remove(fileName.c_str());
+
+  std::cout << records.size() << " records and " << corruptions.size() << " corrupted files checked, "
+            << nBad << " errors" << std::endl;
+  return nBad;
+}
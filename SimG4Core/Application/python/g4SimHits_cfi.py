@@ -355,7 +355,8 @@ g4SimHits = cms.EDProducer("OscarMTProducer",
         ApplyFiducialCut= cms.bool(True),
         BranchPost      = cms.untracked.string(''),
         BranchEvt       = cms.untracked.string(''),
-        BranchPre       = cms.untracked.string('')
+        BranchPre       = cms.untracked.string(''),
+        BinaryFileName  = cms.untracked.string('')
     ),
     HFShowerPMT = cms.PSet(
         common_UsePMT,
@@ -15,7 +15,8 @@ class SiChargeCollectionDrifter{
   typedef std::vector <EnergyDepositUnit> ionization_type;
 
   virtual ~SiChargeCollectionDrifter() { }
-  virtual collection_type drift (const ionization_type&, const LocalVector&,double,double) = 0;
+  // fills the last argument, whose capacity is reused from hit to hit
+  virtual void drift (const ionization_type&, const LocalVector&,double,double, collection_type&) = 0;
 };
 
 #endif
@@ -20,7 +20,8 @@ class SiChargeDivider{
  public:
   typedef std::vector< EnergyDepositUnit > ionization_type;
   virtual ~SiChargeDivider() { }
-  virtual ionization_type divide(const PSimHit*, const LocalVector&, double, const StripGeomDetUnit& det, CLHEP::HepRandomEngine* engine ) = 0;
+  // fills the last argument, whose capacity is reused from hit to hit
+  virtual void divide(const PSimHit*, const LocalVector&, double, const StripGeomDetUnit& det, CLHEP::HepRandomEngine* engine, ionization_type& ) = 0;
   virtual void setParticleDataTable(const ParticleDataTable * pdt) = 0;
 };
 
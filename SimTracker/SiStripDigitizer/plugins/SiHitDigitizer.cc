@@ -39,9 +39,7 @@ SiHitDigitizer::processHit(const PSimHit* hit, const StripGeomDetUnit& det, Glob
   LocalVector driftDir = DriftDirection(&det,bfield,langle);
   
   // Fully process one SimHit
-  theSiInduceChargeOnStrips->induce(
-      theSiChargeCollectionDrifter->drift(
-                                          theSiChargeDivider->divide(hit, driftDir, moduleThickness, det, engine),
-          driftDir,moduleThickness,timeNormalisation),
-      det,locAmpl,firstChannelWithSignal,lastChannelWithSignal,tTopo);
+  theSiChargeDivider->divide(hit, driftDir, moduleThickness, det, engine, theIonizationPoints);
+  theSiChargeCollectionDrifter->drift(theIonizationPoints, driftDir, moduleThickness, timeNormalisation, theSignalPoints);
+  theSiInduceChargeOnStrips->induce(theSignalPoints, det, locAmpl, firstChannelWithSignal, lastChannelWithSignal, tTopo);
 }
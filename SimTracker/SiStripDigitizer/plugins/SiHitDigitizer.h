@@ -62,6 +62,10 @@ class SiHitDigitizer {
   std::unique_ptr<SiChargeCollectionDrifter> theSiChargeCollectionDrifter;
   std::unique_ptr<const SiInduceChargeOnStrips> theSiInduceChargeOnStrips;
 
+  // buffers reused from hit to hit
+  SiChargeDivider::ionization_type theIonizationPoints;
+  SiChargeCollectionDrifter::collection_type theSignalPoints;
+
   typedef GloballyPositioned<double> Frame;
   
   LocalVector DriftDirection(const StripGeomDetUnit* _detp, GlobalVector _bfield, float langle) {
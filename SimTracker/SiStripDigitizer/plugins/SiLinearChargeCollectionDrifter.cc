@@ -13,16 +13,15 @@ SiLinearChargeCollectionDrifter::SiLinearChargeCollectionDrifter(double dc,
 {
 }
 
-SiChargeCollectionDrifter::collection_type SiLinearChargeCollectionDrifter::drift(const SiChargeCollectionDrifter::ionization_type& ion, 
-										  const LocalVector& driftDir,double mt, double tn) {
+void SiLinearChargeCollectionDrifter::drift(const SiChargeCollectionDrifter::ionization_type& ion, 
+                                            const LocalVector& driftDir,double mt, double tn,
+                                            SiChargeCollectionDrifter::collection_type& _temp) {
   // prepare output
-  collection_type _temp;
   _temp.resize(ion.size());
   // call the drift method for each deposit
   for (size_t i=0; i<ion.size(); i++){
     _temp[i] = drift(ion[i], driftDir, mt, tn);
   }
-  return _temp;
 }
 
 SignalPoint SiLinearChargeCollectionDrifter::drift
@@ -12,8 +12,9 @@
 class SiLinearChargeCollectionDrifter : public SiChargeCollectionDrifter{
  public:
   SiLinearChargeCollectionDrifter(double,double,double,double);
-  SiChargeCollectionDrifter::collection_type drift(const SiChargeCollectionDrifter::ionization_type&, 
-                                                   const LocalVector&,double,double) override;
+  void drift(const SiChargeCollectionDrifter::ionization_type&, 
+             const LocalVector&,double,double,
+             SiChargeCollectionDrifter::collection_type&) override;
  private:
   SignalPoint drift(const EnergyDepositUnit&, const LocalVector&,double,double);
  private:
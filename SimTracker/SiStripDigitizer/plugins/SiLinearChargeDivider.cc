@@ -26,14 +26,17 @@ SiLinearChargeDivider::SiLinearChargeDivider(const edm::ParameterSet& conf) :
 SiLinearChargeDivider::~SiLinearChargeDivider(){
 }
 
-SiChargeDivider::ionization_type 
-SiLinearChargeDivider::divide(const PSimHit* hit, const LocalVector& driftdir, double moduleThickness, const StripGeomDetUnit& det, CLHEP::HepRandomEngine* engine) {
+void
+SiLinearChargeDivider::divide(const PSimHit* hit, const LocalVector& driftdir, double moduleThickness, const StripGeomDetUnit& det, CLHEP::HepRandomEngine* engine,
+                              SiChargeDivider::ionization_type& _ionization_points) {
+
+  _ionization_points.clear();
 
   // signal after pulse shape correction
   float const decSignal = TimeResponse(hit, det);
 
   // if out of time go home!
-  if (0==decSignal) return ionization_type();
+  if (0==decSignal) return;
 
   // Get the nass if the particle, in MeV.
   // Protect from particles with Mass = 0, assuming then the pion mass
@@ -61,7 +64,6 @@ SiLinearChargeDivider::divide(const PSimHit* hit, const LocalVector& driftdir, d
 
 
   // Prepare output
-  ionization_type _ionization_points;
   _ionization_points.resize(NumberOfSegmentation);
 
   // Fluctuate charge in track subsegments
@@ -89,7 +91,6 @@ SiLinearChargeDivider::divide(const PSimHit* hit, const LocalVector& driftdir, d
       }
     }
   }
-  return _ionization_points;
 }
 
 void SiLinearChargeDivider::fluctuateEloss(double particleMass, float particleMomentum, 
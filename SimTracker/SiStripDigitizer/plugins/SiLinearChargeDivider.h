@@ -34,7 +34,8 @@ class SiLinearChargeDivider : public SiChargeDivider{
   ~SiLinearChargeDivider() override;
 
   // main method: divide the charge (from the PSimHit) into several energy deposits in the bulk
-  SiChargeDivider::ionization_type divide(const PSimHit*, const LocalVector&, double, const StripGeomDetUnit& det, CLHEP::HepRandomEngine*) override;
+  void divide(const PSimHit*, const LocalVector&, double, const StripGeomDetUnit& det, CLHEP::HepRandomEngine*,
+              SiChargeDivider::ionization_type&) override;
 
   // set the ParticleDataTable (used to fluctuate the charge properly)
   void setParticleDataTable(const ParticleDataTable * pdt) override { theParticleDataTable = pdt; }
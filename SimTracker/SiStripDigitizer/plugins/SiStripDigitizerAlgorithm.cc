@@ -194,7 +194,8 @@ SiStripDigitizerAlgorithm::accumulateSimHits(std::vector<PSimHit>::const_iterato
         if(thisLastChannelWithSignal < localLastChannel) thisLastChannelWithSignal = localLastChannel;
 
         if( makeDigiSimLinks_ ) { // No need to do any of this if truth association was turned off in the configuration
-          for( size_t stripIndex=0; stripIndex<locAmpl.size(); ++stripIndex ) {
+          // the hit only changed the strips in [localFirstChannel, localLastChannel)
+          for( size_t stripIndex=localFirstChannel; stripIndex<localLastChannel; ++stripIndex ) {
             // Work out the amplitude from this SimHit from the difference of what it was before and what it is now
             float signalFromThisSimHit=locAmpl[stripIndex]-previousLocalAmplitude[stripIndex];
             if( signalFromThisSimHit!=0 ) { // If this SimHit had any contribution I need to record it.
@@ -196,6 +196,12 @@ induceVector(const SiChargeCollectionDrifter::collection_type& collection_points
       fromStrip[i]  = std::max( 0,  int(std::floor( chargePosition[i] - Nsigma*chargeSpread[i])) );
       nStrip[i] = std::min( Nstrips, int(std::ceil( chargePosition[i] + Nsigma*chargeSpread[i])) ) - fromStrip[i];
     }
+    // only the strips reached by the points of this chunk are cleared and scanned below
+    int minStrip=Nstrips, maxStrip=0;
+    for (int i=0; i!=N;++i) {
+      minStrip = std::min(minStrip, fromStrip[i]);
+      maxStrip = std::max(maxStrip, fromStrip[i]+nStrip[i]);
+    }
     int tot=0;
     for (int i=0; i!=N;++i) tot += nStrip[i];
     tot+=N; // add last strip 
@@ -236,7 +242,7 @@ induceVector(const SiChargeCollectionDrifter::collection_type& collection_points
       value[k]-=value[k+1];  // this is negative!
     
     
-    float charge[Nstrips]; for (int i=0;i!=Nstrips; ++i) charge[i]=0;
+    float charge[Nstrips]; for (int i=minStrip;i<maxStrip; ++i) charge[i]=0;
     kk=0;
     for (int i=0; i!=N;++i){ 
       for (int j=0;j!=nStrip[i]; ++j)
@@ -249,7 +255,7 @@ induceVector(const SiChargeCollectionDrifter::collection_type& collection_points
     /// do crosstalk... (can be done better, most probably not worth)
     int minA=recordMinAffectedStrip, maxA=recordMaxAffectedStrip;
     int sc = coupling.size();
-    for (int i=0;i!=Nstrips; ++i) {
+    for (int i=minStrip;i<maxStrip; ++i) {
       int strip = i;
       if (0==charge[i]) continue;
       auto affectedFromStrip  = std::max( 0, strip - sc + 1);
@@ -2,6 +2,7 @@
 #define CMSUTILS_BEUEUE_H
 #include <boost/intrusive_ptr.hpp>
 #include<cassert>
+#include<new>
 
 /**  Backwards linked queue with "head sharing"
 
@@ -31,6 +32,9 @@
     to support c++11 begin,end and operator++ has been added with the same semantics of rbegin,rend and operator--
     Highly confusing, still the bqueue is a sort of reversed slist: provided the user knows should work....
 
+    The items are allocated from a per-thread pool (_bqueue_pool): trajectory building forks and drops
+    many short lived candidates, and their items are recycled instead of going back to the heap.
+    bqueue<T>::poolStats() returns the allocation counters of the current thread.
 
 */
 namespace cmsutils {
@@ -41,6 +45,73 @@ namespace cmsutils {
   template<class T> void intrusive_ptr_add_ref(_bqueue_item<T> *it) ;
   template<class T> void intrusive_ptr_release(_bqueue_item<T> *it) ;
   
+  /* Per-thread cache of released items of one type.
+     An item released by another thread than the one which allocated it is cached by the
+     releasing thread: each cache is only accessed by its own thread.
+     Each item is a separate heap allocation, so that any cached item can be given back to the heap.
+  */
+  template<class T>
+  class _bqueue_pool {
+  public:
+    struct Stats {
+      unsigned long long allocated = 0; // items taken from the heap
+      unsigned long long reused = 0;    // items taken from the cache
+      unsigned long long released = 0;  // items given back (to the cache or to the heap)
+    };
+
+    static void * allocate(std::size_t size) {
+      Cache & cache = local();
+      if (cache.head) {
+        FreeItem * item = cache.head;
+        cache.head = item->next;
+        --cache.size;
+        ++cache.stats.reused;
+        return item;
+      }
+      ++cache.stats.allocated;
+      return ::operator new(size);
+    }
+
+    static void release(void * ptr) {
+      Cache & cache = local();
+      ++cache.stats.released;
+      if (cache.size >= cache.maxSize) { ::operator delete(ptr); return; }
+      FreeItem * item = static_cast<FreeItem *>(ptr);
+      item->next = cache.head;
+      cache.head = item;
+      ++cache.size;
+    }
+
+    static Stats const & stats() { return local().stats; }
+    static void resetStats() { local().stats = Stats(); }
+
+    // maximal number of items cached by the current thread (0 disables the cache)
+    static void setMaxSize(unsigned int maxSize) {
+      Cache & cache = local();
+      cache.maxSize = maxSize;
+      while (cache.size > maxSize) {
+        FreeItem * item = cache.head;
+        cache.head = item->next;
+        --cache.size;
+        ::operator delete(item);
+      }
+    }
+
+  private:
+    struct FreeItem { FreeItem * next; };
+    struct Cache {
+      FreeItem * head = nullptr;
+      unsigned int size = 0;
+      unsigned int maxSize = 4096;
+      Stats stats;
+      ~Cache() {
+        while (head) { FreeItem * next = head->next; ::operator delete(head); head = next; }
+        size = maxSize = 0;
+      }
+    };
+    static Cache & local() { static thread_local Cache cache; return cache; }
+  };
+
   template <class T> 
   class _bqueue_item  {
     friend class bqueue<T>;
@@ -49,6 +120,11 @@ namespace cmsutils {
     friend void intrusive_ptr_release<T>(_bqueue_item<T> *it);
     void addRef() { ++refCount; }
     void delRef() { if ((--refCount) == 0) delete this; }
+    static void * operator new(std::size_t size) {
+      static_assert(sizeof(_bqueue_item<T>) >= sizeof(void *), "item too small to be pooled");
+      return _bqueue_pool<T>::allocate(size);
+    }
+    static void operator delete(void * ptr) { _bqueue_pool<T>::release(ptr); }
   private:
     _bqueue_item() : back(0), value(), refCount(0) { }
     _bqueue_item(boost::intrusive_ptr< _bqueue_item<T> > tail, const T &val) : back(tail), value(val), refCount(0) { }
@@ -99,6 +175,12 @@ namespace cmsutils {
     typedef boost::intrusive_ptr< _bqueue_item<value_type> >  itemptr;
     typedef _bqueue_itr<value_type>       iterator;
     typedef _bqueue_itr<value_type> const_iterator;
+    typedef typename _bqueue_pool<value_type>::Stats PoolStats;
+
+    // allocation counters of the items of this type, for the current thread
+    static PoolStats const & poolStats() { return _bqueue_pool<value_type>::stats(); }
+    static void resetPoolStats() { _bqueue_pool<value_type>::resetStats(); }
+    static void setPoolSize(unsigned int maxSize) { _bqueue_pool<value_type>::setMaxSize(maxSize); }
     
     bqueue() : m_size(0),  m_head(), m_tail() { }
     ~bqueue() { }
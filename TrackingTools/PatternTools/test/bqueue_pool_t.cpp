@@ -0,0 +1,109 @@
+// Benchmark of the bqueue item pool on a toy combinatorial track finding:
+// each candidate is extended layer by layer with a few compatible hits and
+// an invalid hit, and the best maxCand candidates are kept, as in the CKF.
+// The configurations roughly follow the iterative tracking steps.
+#include "TrackingTools/PatternTools/interface/bqueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  // about the size of a TrajectoryMeasurement
+  struct Measurement {
+    double state[20];
+    float chi2;
+    int hit;
+  };
+
+  typedef cmsutils::bqueue<Measurement> Cont;
+
+  struct Candidate {
+    Cont measurements;
+    float chi2 = 0;
+  };
+
+  struct Step {
+    const char * name;
+    unsigned int nSeeds;
+    unsigned int nLayers;
+    unsigned int maxCand;
+    unsigned int maxHits;  // maximal number of compatible hits per layer
+  };
+
+  // returns a checksum of the tracks found
+  double buildTracks(Step const & step, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned int> nHits(0, step.maxHits);
+    std::exponential_distribution<float> chi2(1.f);
+
+    double checksum = 0;
+    std::vector<Candidate> candidates, newCandidates;
+    for (unsigned int is = 0; is < step.nSeeds; ++is) {
+      candidates.clear();
+      candidates.emplace_back();
+      for (unsigned int il = 0; il < step.nLayers; ++il) {
+        newCandidates.clear();
+        for (auto const & cand : candidates) {
+          unsigned int n = nHits(rng);
+          for (unsigned int ih = 0; ih <= n; ++ih) {
+            // ih == n is the invalid hit
+            Candidate newCand(cand);
+            Measurement m;
+            std::fill(m.state, m.state + 20, double(il));
+            m.chi2 = ih < n ? chi2(rng) : 10.f;
+            m.hit = ih < n ? int(il * 100 + ih) : -1;
+            newCand.chi2 += m.chi2;
+            newCand.measurements.push_back(m);
+            newCandidates.push_back(std::move(newCand));
+          }
+        }
+        unsigned int nKept = std::min<unsigned int>(step.maxCand, newCandidates.size());
+        std::partial_sort(newCandidates.begin(), newCandidates.begin() + nKept, newCandidates.end(),
+                          [](Candidate const & a, Candidate const & b) { return a.chi2 < b.chi2; });
+        newCandidates.resize(nKept);
+        candidates.swap(newCandidates);
+      }
+      for (auto const & cand : candidates)
+        for (auto const & m : cand.measurements) checksum += m.hit;
+    }
+    return checksum;
+  }
+
+}
+
+int main() {
+  const Step steps[] = {
+    {"initialStep", 4000, 13, 3, 3},
+    {"lowPtTripletStep", 8000, 13, 4, 3},
+    {"detachedTripletStep", 6000, 13, 3, 3},
+    {"mixedTripletStep", 6000, 13, 2, 3},
+    {"pixelLessStep", 4000, 13, 2, 3},
+    {"tobTecStep", 4000, 13, 2, 3}
+  };
+
+  int ret = 0;
+  for (auto const & step : steps) {
+    double checksum[2];
+    double time[2];
+    Cont::PoolStats stats[2];
+    for (int pooled = 0; pooled < 2; ++pooled) {
+      Cont::setPoolSize(pooled ? 4096 : 0);
+      Cont::resetPoolStats();
+      auto start = std::chrono::high_resolution_clock::now();
+      checksum[pooled] = buildTracks(step, 1234);
+      auto stop = std::chrono::high_resolution_clock::now();
+      time[pooled] = std::chrono::duration<double, std::milli>(stop - start).count();
+      stats[pooled] = Cont::poolStats();
+    }
+    if (checksum[0] != checksum[1]) ret = 1;
+    std::cout << step.name << ": heap " << time[0] << " ms, pooled " << time[1] << " ms"
+              << ", items allocated " << stats[1].allocated << " reused " << stats[1].reused
+              << " (without pool " << stats[0].allocated << ")"
+              << (checksum[0] != checksum[1] ? " MISMATCH" : "") << std::endl;
+  }
+  return ret;
+}